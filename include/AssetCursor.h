@@ -0,0 +1,55 @@
+/**
+ * @file AssetCursor.h
+ * @brief 资产分页游标
+ *
+ * 基于 Database::SearchAssetsPage 的键集分页，按需逐页拉取搜索结果
+ */
+
+#ifndef ASSETCURSOR_H
+#define ASSETCURSOR_H
+
+#include "models.h"
+#include "database.h"
+#include <vector>
+
+/**
+ * @brief 资产分页游标
+ *
+ * 首屏只查询一页数据，滚动时再调用 FetchNext 拉取后续页。
+ * 游标只保存上一页末行的 (排序键, id)，翻页代价与已读行数无关。
+ */
+class AssetCursor {
+public:
+    AssetCursor(Database& db, const AssetFilter& filter, int pageSize = 200);
+
+    /**
+     * @brief 是否可能还有更多数据
+     */
+    bool HasMore() const { return m_hasMore; }
+
+    /**
+     * @brief 拉取下一页，没有更多数据时返回空
+     */
+    std::vector<Asset> FetchNext();
+
+    /**
+     * @brief 回到第一页
+     */
+    void Reset();
+
+    /**
+     * @brief 更换查询条件并回到第一页
+     */
+    void SetFilter(const AssetFilter& filter);
+
+    const AssetFilter& GetFilter() const { return m_filter; }
+
+private:
+    Database& m_db;
+    AssetFilter m_filter;
+    AssetPageKey m_position;
+    int m_pageSize;
+    bool m_hasMore;
+};
+
+#endif  // ASSETCURSOR_H
@@ -54,6 +54,8 @@ private:
     HWND m_hDlg;
     int m_assetId;            // -1 表示新增模式
     Asset m_asset;
+    std::string m_codePrefix;     // 新增模式的编号前缀
+    std::string m_suggestedCode;  // 新增模式预填的编号（保存时才从序列中占用）
 
     std::vector<Category> m_categories;
     std::vector<Department> m_departments;
@@ -88,11 +90,6 @@ private:
      */
     bool ValidateInput();
 
-    /**
-     * @brief 生成下一个资产编号
-     */
-    std::string GetNextAssetCode();
-
     /**
      * @brief 获取用户输入的使用人姓名
      */
@@ -0,0 +1,115 @@
+/**
+ * @file AssetStore.h
+ * @brief 内存资产表
+ *
+ * 启动时整表加载一次，之后由写连接的 update hook 增量维护：
+ * - 资产行变更只重新读取受影响的行
+ * - 分类/员工/部门变更时按字典缓存（ReferenceCache）就地更新显示名
+ * - PRAGMA data_version 变化（其他连接提交）或事务回滚时整表重载
+ */
+
+#ifndef ASSETSTORE_H
+#define ASSETSTORE_H
+
+#include "models.h"
+#include "database.h"
+#include <map>
+#include <unordered_set>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 内存资产表统计
+ */
+struct AssetStoreStats {
+    uint64_t fullLoads;       // 整表加载次数
+    uint64_t rowRefreshes;    // 增量重读的资产行数
+    uint64_t rowRemovals;     // 增量删除的资产行数
+    uint64_t nameRefreshes;   // 显示名刷新次数
+};
+
+/**
+ * @brief 内存资产表（非线程安全，与写连接同线程使用）
+ *
+ * 无搜索文本时，分类/状态过滤与默认排序（ID 降序）直接由内存提供，
+ * 不再执行三表连接查询。
+ */
+class AssetStore : public DatabaseChangeListener {
+public:
+    explicit AssetStore(Database& db);
+    ~AssetStore() override;
+
+    // 禁止拷贝
+    AssetStore(const AssetStore&) = delete;
+    AssetStore& operator=(const AssetStore&) = delete;
+
+    /**
+     * @brief 整表加载并开始监听变更（数据库需已初始化）
+     */
+    bool Load();
+
+    /**
+     * @brief 停止监听并清空
+     */
+    void Unload();
+
+    bool IsLoaded() const { return m_loaded; }
+
+    /**
+     * @brief 应用累积的变更，使内存数据与数据库一致
+     */
+    void Sync();
+
+    /**
+     * @brief 按分类/状态过滤，ID 降序返回（categoryId < 0 或 status 为空表示不过滤）
+     *
+     * 返回指向内存表的指针，不复制资产；指针在下一次 Sync（任何会同步的调用，
+     * 包括再次 Query）或 Unload 之前有效。
+     */
+    std::vector<const Asset*> Query(int categoryId = -1, const std::string& status = "");
+
+    /**
+     * @brief 按 ID 获取资产
+     */
+    bool Get(int id, Asset& asset);
+
+    /**
+     * @brief 资产数量
+     */
+    size_t Size();
+
+    /**
+     * @brief 与数据库逐行比对
+     * @param differences 可选，输出差异描述
+     * @return 完全一致返回 true
+     */
+    bool VerifyConsistency(std::vector<std::string>* differences = nullptr);
+
+    AssetStoreStats GetStats() const { return m_stats; }
+
+    // DatabaseChangeListener
+    void OnRowChanged(int operation, const char* table, sqlite3_int64 rowid) override;
+    void OnRollback() override;
+
+private:
+    Database& m_db;
+    bool m_loaded;
+    bool m_listening;
+    int m_dataVersion;
+
+    // ID 降序即默认显示顺序
+    std::map<int, Asset, std::greater<int>> m_assets;
+
+    // 待应用的变更（hook 中不能访问数据库，只做记录）
+    std::unordered_set<int> m_dirtyAssets;
+    bool m_namesDirty;
+    bool m_needsReload;
+
+    AssetStoreStats m_stats;
+
+    bool Reload();
+    void ResolveNames(Asset& asset) const;
+};
+
+#endif  // ASSETSTORE_H
@@ -0,0 +1,123 @@
+/**
+ * @file AsyncSearchExecutor.h
+ * @brief 后台搜索执行器
+ *
+ * 在独立的只读连接和工作线程上执行搜索，新请求会取消正在执行的旧请求，
+ * 结果带有代号（generation），过期结果直接丢弃。
+ */
+
+#ifndef ASYNCSEARCHEXECUTOR_H
+#define ASYNCSEARCHEXECUTOR_H
+
+#include "models.h"
+#include "database.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 后台搜索结果
+ */
+struct AsyncSearchResult {
+    uint64_t generation;        // 对应 Submit 返回的代号
+    std::vector<Asset> assets;
+};
+
+/**
+ * @brief 后台搜索执行器
+ *
+ * 同一时刻只执行一个请求：Submit 新请求时，排队中的旧请求被替换，
+ * 正在执行的旧请求通过进度回调中止。结果回调在工作线程上调用，
+ * 只会收到提交时仍是最新代号的结果。
+ */
+class AsyncSearchExecutor {
+public:
+    using Task = std::function<std::vector<Asset>(Database&)>;
+    using ResultCallback = std::function<void(AsyncSearchResult&&)>;
+
+    explicit AsyncSearchExecutor(ResultCallback onResult);
+    ~AsyncSearchExecutor();
+
+    // 禁止拷贝
+    AsyncSearchExecutor(const AsyncSearchExecutor&) = delete;
+    AsyncSearchExecutor& operator=(const AsyncSearchExecutor&) = delete;
+
+    /**
+     * @brief 打开工作连接并启动工作线程
+     * @param dbPath 数据库路径（须已由写连接初始化）
+     */
+    bool Start(const std::string& dbPath);
+
+    /**
+     * @brief 取消所有请求并停止工作线程
+     */
+    void Stop();
+
+    /**
+     * @brief 工作线程是否在运行
+     */
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief 提交资产搜索，取代之前的请求
+     * @return 本次请求的代号
+     */
+    uint64_t Submit(const AssetFilter& filter);
+
+    /**
+     * @brief 提交任意查询任务（在工作连接上执行），取代之前的请求
+     * @return 本次请求的代号
+     */
+    uint64_t SubmitTask(Task task);
+
+    /**
+     * @brief 使所有未完成的请求过期（同步刷新前调用，防止旧结果覆盖）
+     */
+    void Cancel();
+
+    /**
+     * @brief 最新的请求代号
+     */
+    uint64_t GetLatestGeneration() const { return m_latestGeneration.load(); }
+
+    /**
+     * @brief 代号是否仍是最新（结果在投递到 UI 线程后应再次检查）
+     */
+    bool IsCurrent(uint64_t generation) const { return generation == m_latestGeneration.load(); }
+
+    /**
+     * @brief 获取最后一个错误信息
+     */
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    Database m_db;
+    ResultCallback m_onResult;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    Task m_pendingTask;
+    uint64_t m_pendingGeneration;
+    bool m_hasPending;
+    bool m_stopping;
+    std::atomic<uint64_t> m_latestGeneration;
+    std::atomic<uint64_t> m_runningGeneration;
+    std::string m_lastError;
+
+    /**
+     * @brief 工作线程主循环
+     */
+    void WorkerLoop();
+
+    /**
+     * @brief SQLite 进度回调：执行中的请求已过期时返回非 0 中止查询
+     */
+    static int ProgressHandler(void* context);
+};
+
+#endif  // ASYNCSEARCHEXECUTOR_H
@@ -8,8 +8,10 @@
 
 #include "models.h"
 #include "database.h"
+#include "CsvExporter.h"
 #include <windows.h>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -33,6 +35,14 @@ public:
      */
     static bool ImportFromCSV(HWND hWnd, Database& db);
 
+    /**
+     * @brief 检查 CSV 文件能否导入（只检查不写入）
+     * @param hWnd 父窗口句柄
+     * @param db 数据库引用（用于检查编号是否已存在）
+     * @return 所有行都可以直接导入时返回 true
+     */
+    static bool ValidateCSV(HWND hWnd, Database& db);
+
     /**
      * @brief 下载 CSV 导入模板
      * @param hWnd 父窗口句柄
@@ -41,20 +51,11 @@ public:
     static bool DownloadTemplate(HWND hWnd);
 
 private:
-    /**
-     * @brief 解析 CSV 行
-     */
-    static std::vector<std::string> ParseCSVLine(const std::string& line);
-
-    /**
-     * @brief 转义 CSV 字段
-     */
-    static std::string EscapeCSVField(const std::string& field);
-
     /**
      * @brief 显示文件选择对话框（保存）
+     * @param encoding 非空时文件类型中增加 GBK 一项，返回所选的编码
      */
-    static bool ShowSaveDialog(HWND hWnd, std::wstring& filePath);
+    static bool ShowSaveDialog(HWND hWnd, std::wstring& filePath, CsvExportEncoding* encoding = nullptr);
 
     /**
      * @brief 显示文件选择对话框（打开）
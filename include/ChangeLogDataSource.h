@@ -0,0 +1,77 @@
+/**
+ * @file ChangeLogDataSource.h
+ * @brief 变更日志分页数据源
+ *
+ * 基于 Database::GetChangeLogsBefore 的键集分页，供虚拟列表按需拉取
+ */
+
+#ifndef CHANGELOGDATASOURCE_H
+#define CHANGELOGDATASOURCE_H
+
+#include "models.h"
+#include "database.h"
+#include <vector>
+
+/**
+ * @brief 变更日志分页数据源
+ *
+ * 按时间倒序保存已加载的行，列表滚动到末尾时调用 EnsureLoaded 追加后续页。
+ * 只保存上一页末行的 (change_time, id)，首屏与翻页代价与日志总量无关。
+ */
+class ChangeLogDataSource {
+public:
+    explicit ChangeLogDataSource(Database& db, int pageSize = 200);
+
+    /**
+     * @brief 更换查询条件并清空已加载的行
+     */
+    void SetFilter(const ChangeLogFilter& filter);
+
+    const ChangeLogFilter& GetFilter() const { return m_filter; }
+
+    /**
+     * @brief 清空已加载的行，下次从最新一条开始
+     */
+    void Reset();
+
+    /**
+     * @brief 加载到至少 count 行（或没有更多数据）
+     * @return 已加载行数
+     */
+    size_t EnsureLoaded(size_t count);
+
+    /**
+     * @brief 再加载一页
+     * @return 本次加载的行数
+     */
+    size_t LoadNextPage();
+
+    /**
+     * @brief 已加载行数
+     */
+    size_t GetLoadedCount() const { return m_rows.size(); }
+
+    /**
+     * @brief 是否可能还有更多数据
+     */
+    bool HasMore() const { return m_hasMore; }
+
+    /**
+     * @brief 获取已加载的行，越界返回 nullptr
+     */
+    const AssetChangeLog* GetRow(size_t index) const {
+        return index < m_rows.size() ? &m_rows[index] : nullptr;
+    }
+
+    int GetPageSize() const { return m_pageSize; }
+
+private:
+    Database& m_db;
+    ChangeLogFilter m_filter;
+    ChangeLogPageKey m_position;
+    std::vector<AssetChangeLog> m_rows;
+    int m_pageSize;
+    bool m_hasMore;
+};
+
+#endif  // CHANGELOGDATASOURCE_H
@@ -10,6 +10,7 @@
 
 #include "models.h"
 #include "database.h"
+#include "ChangeLogDataSource.h"
 #include <windows.h>
 #include <commctrl.h>
 #include <vector>
@@ -38,8 +39,9 @@ private:
     HWND m_hList;
     HWND m_hSearchEdit;
 
-    std::vector<AssetChangeLog> m_logs;
+    ChangeLogDataSource m_source;  // 按需分页加载，列表为虚拟列表（LVS_OWNERDATA）
     int m_filterAssetId;  // -1 表示显示所有
+    bool m_loadPending;   // 已投递加载下一页的消息
 
     /**
      * @brief 对话框过程
@@ -62,10 +64,30 @@ private:
     void LoadChangeLogs();
 
     /**
-     * @brief 刷新列表视图
+     * @brief 刷新列表视图（按已加载行数设置虚拟列表项数）
      */
     void RefreshListView();
 
+    /**
+     * @brief 更新标题中的记录数
+     */
+    void UpdateTitle();
+
+    /**
+     * @brief 加载下一页并追加到列表
+     */
+    void LoadMore();
+
+    /**
+     * @brief 虚拟列表取显示文本
+     */
+    void OnGetDispInfo(NMLVDISPINFOW* info);
+
+    /**
+     * @brief 列表即将显示 [iFrom, iTo]，接近已加载末尾时投递加载下一页
+     */
+    void RequestMore(int lastVisible);
+
     /**
      * @brief 搜索变更日志
      */
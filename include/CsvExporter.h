@@ -0,0 +1,74 @@
+/**
+ * @file CsvExporter.h
+ * @brief CSV 资产导出
+ *
+ * 由 Database::ForEachAsset 逐行回调直接写入 CsvWriter 的缓冲，
+ * 不构造 Asset 对象，也不在内存中保留结果集。
+ * 默认输出 UTF-8（带 BOM），也可输出 GBK（无 BOM）供只认本地代码页的旧版 Excel、ERP 使用；
+ * 两种编码的列都与导入模板一致，可直接重新导入。
+ * 主程序的导出对话框与命令行工具 assetctl 共用。
+ */
+
+#ifndef CSVEXPORTER_H
+#define CSVEXPORTER_H
+
+#include "database.h"
+#include <string>
+
+class CsvWriter;
+
+/**
+ * @brief 导出文件的编码
+ */
+enum class CsvExportEncoding {
+    Utf8Bom,        // UTF-8 带 BOM（默认）
+    Gbk             // GBK（CP936），GBK 中没有的字符写为 '?'
+};
+
+/**
+ * @brief CSV 资产导出器
+ */
+class CsvExporter {
+public:
+    explicit CsvExporter(Database& db, CsvExportEncoding encoding = CsvExportEncoding::Utf8Bom);
+
+    /**
+     * @brief 导出符合条件的资产
+     * @param rows 输出导出的行数
+     * @return 失败时返回 false（GetLastError 给出原因），已写出的部分保留
+     */
+    bool Export(const std::string& path, const AssetFilter& filter, long long& rows);
+
+#ifdef _WIN32
+    bool Export(const std::wstring& path, const AssetFilter& filter, long long& rows);
+#endif
+
+    /**
+     * @brief 写出导入模板（表头、示例行与填写说明）
+     * @param error 失败时返回原因
+     */
+    static bool ExportTemplate(const std::string& path, std::string& error);
+
+#ifdef _WIN32
+    static bool ExportTemplate(const std::wstring& path, std::string& error);
+#endif
+
+    const std::string& GetLastError() const { return m_lastError; }
+
+    /**
+     * @brief 上次导出中 GBK 无法表示而写为 '?' 的字符数（UTF-8 导出时为 0）
+     */
+    long long GetReplacedChars() const { return m_replacedChars; }
+
+private:
+    Database& m_db;
+    CsvExportEncoding m_encoding;
+    long long m_replacedChars;
+    std::string m_lastError;
+
+    bool Run(CsvWriter& writer, const AssetFilter& filter, long long& rows);
+
+    static bool WriteTemplate(CsvWriter& writer, std::string& error);
+};
+
+#endif  // CSVEXPORTER_H
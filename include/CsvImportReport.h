@@ -0,0 +1,60 @@
+/**
+ * @file CsvImportReport.h
+ * @brief CSV 导入/检查的逐行信息报告
+ *
+ * 作为 CsvImportOptions::onMessage 的接收者，信息到达即写入 CsvWriter 的缓冲，
+ * 内存占用与信息条数无关。报告本身是 CSV（UTF-8 带 BOM，列为 行号,信息），
+ * 可以直接用表格软件打开、按行号定位到原文件。
+ */
+
+#ifndef CSVIMPORTREPORT_H
+#define CSVIMPORTREPORT_H
+
+#include "CsvImporter.h"
+#include "CsvWriter.h"
+#include <string>
+
+/**
+ * @brief 逐行信息报告文件（非线程安全，导入与检查都在调用线程上回调）
+ */
+class CsvImportReport {
+public:
+    CsvImportReport();
+
+    /**
+     * @brief 创建报告文件并写入表头
+     */
+    bool Open(const std::string& path);
+
+#ifdef _WIN32
+    bool Open(const std::wstring& path);
+#endif
+
+    /**
+     * @brief 追加一条信息
+     */
+    void Add(const CsvImportMessage& message);
+
+    /**
+     * @brief 写出剩余内容并关闭
+     * @return 期间所有写入都成功时返回 true
+     */
+    bool Close();
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    /**
+     * @brief 已写入的信息条数
+     */
+    long long GetCount() const { return m_count; }
+
+    const std::string& GetLastError() const { return m_writer.GetLastError(); }
+
+private:
+    CsvWriter m_writer;
+    long long m_count;
+
+    void WriteHeader();
+};
+
+#endif  // CSVIMPORTREPORT_H
@@ -0,0 +1,138 @@
+/**
+ * @file CsvImporter.h
+ * @brief CSV 资产导入（流水线）
+ *
+ * 三级流水线，级间以有界队列连接：
+ * - 读线程：内存映射文件，按记录边界切成约 1 MB 的段
+ * - 解析线程（N 个）：解析字段、GBK 转码、去空白、校验字段（名称为空的行只报告，不写入）
+ * - 写入（调用线程）：按段的原始顺序把分类/部门/员工名称解析为 ID（不存在则创建），
+ *   自动编号，每 batchRows 行一个事务批量插入
+ *
+ * 写入固定在调用线程上，AssetStore、ReferenceCache 等监听者的回调线程与串行导入相同；
+ * 按原始顺序写入保证结果（新建名称的 ID、重复编号的取舍、自动编号）与串行导入一致。
+ * workers 为 0 时全部在调用线程上串行执行，用作对照。
+ *
+ * Validate 只检查不写入：解析线程按与导入相同的规则检查字段（名称必填、日期格式、金额、状态），
+ * 调用线程按文件顺序检查编号在文件内和数据库中是否重复，预测的结果与导入一致。
+ * 日期、金额、状态不规范的行默认照常导入（与原有导入规则相同），检查时计入 nonStandardRows；
+ * 设置 strictFields 后这些行导入与检查都按字段有误处理。
+ *
+ * 逐行信息默认收集在结果的 errors 中；设置 onMessage 后按文件顺序逐条回调（调用线程），
+ * 不在内存中累积，可直接写入报告文件（见 CsvImportReport）。
+ */
+
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include "database.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class CsvReader;
+
+/**
+ * @brief 导入或检查产生的一条逐行信息
+ */
+struct CsvImportMessage {
+    long long line = 0;                 // 文件中的物理行号，0 表示与具体行无关
+    std::string text;
+
+    /**
+     * @brief "第 N 行: 内容"，与具体行无关时只有内容
+     */
+    std::string ToString() const;
+};
+
+/**
+ * @brief 导入选项
+ */
+struct CsvImportOptions {
+    int workers = -1;                   // 解析线程数：-1 按 CPU 核数，0 串行
+    size_t batchRows = 5000;            // 每个事务写入的行数
+    size_t chunkBytes = 1 << 20;        // 读线程每段的大小
+    bool strictFields = false;          // 日期、金额、状态不规范的行不导入（默认照常写入）
+    std::function<void(const CsvImportMessage&)> onMessage;    // 设置后逐行信息不再存入 errors
+};
+
+/**
+ * @brief 导入结果
+ */
+struct CsvImportResult {
+    int successCount = 0;
+    int skipCount = 0;                  // 编号已存在而跳过的行
+    int invalidCount = 0;               // 名称为空等字段有误而未导入的行（规则与 Validate 相同）
+    long long rows = 0;                 // 通过校验、提交写入的行数
+    long long messageCount = 0;         // 逐行信息条数（含经 onMessage 送出的）
+    std::vector<std::string> errors;    // 逐行信息（按文件顺序，未设置 onMessage 时）
+};
+
+/**
+ * @brief 检查结果
+ *
+ * 每行只计入一类：字段不合格的行导入时不写入，不再检查编号。
+ * 导入时会写入的行为 validRows + nonStandardRows。
+ */
+struct CsvValidateResult {
+    long long rows = 0;                 // 检查的数据行（不含表头、说明行与空行）
+    long long validRows = 0;            // 可以原样导入的行
+    long long nonStandardRows = 0;      // 日期、金额、状态不规范，但导入时照常写入的行（非严格模式）
+    long long invalidRows = 0;          // 字段不合格、导入时不写入的行
+    long long duplicateRows = 0;        // 编号与文件中前面的行重复
+    long long existingRows = 0;         // 编号在数据库中已存在（导入时会跳过）
+    long long messageCount = 0;
+    std::vector<std::string> errors;    // 逐行信息（按文件顺序，未设置 onMessage 时）
+};
+
+/**
+ * @brief CSV 资产导入器
+ */
+class CsvImporter {
+public:
+    explicit CsvImporter(Database& db, const CsvImportOptions& options = CsvImportOptions());
+
+    /**
+     * @brief 导入文件
+     *
+     * 有 UTF-8 BOM 的按 UTF-8 读取，否则按 GBK 转码。
+     * @return 文件无法打开或读取中断时返回 false（GetLastError 给出原因），
+     *         已提交的批次不回滚；逐行错误记入 result.errors，不影响返回值
+     */
+    bool Import(const std::string& path, CsvImportResult& result);
+
+#ifdef _WIN32
+    bool Import(const std::wstring& path, CsvImportResult& result);
+#endif
+
+    /**
+     * @brief 只检查不写入（不开启事务，不创建分类、员工，不占用编号）
+     *
+     * 内存占用与错误条数无关：除解析队列外只保存文件内编号的哈希与行号（每个不同编号约 32 字节）。
+     * @return 文件无法打开或读取中断时返回 false，检查出的问题不影响返回值
+     */
+    bool Validate(const std::string& path, CsvValidateResult& result);
+
+#ifdef _WIN32
+    bool Validate(const std::wstring& path, CsvValidateResult& result);
+#endif
+
+    /**
+     * @brief 实际使用的解析线程数
+     */
+    int GetWorkerCount() const { return m_workers; }
+
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    Database& m_db;
+    CsvImportOptions m_options;
+    int m_workers;
+    std::string m_lastError;
+
+    bool Run(CsvReader& reader, CsvImportResult& result);
+    bool RunValidate(CsvReader& reader, CsvValidateResult& result);
+};
+
+#endif  // CSVIMPORTER_H
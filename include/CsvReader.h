@@ -0,0 +1,195 @@
+/**
+ * @file CsvReader.h
+ * @brief 流式 CSV 读取器（内存映射，字段零拷贝）
+ *
+ * 按 RFC 4180 解析：
+ * - 字段以逗号分隔，记录以 \r\n、\n 或 \r 结束
+ * - 双引号包围的字段可包含逗号和换行，"" 表示一个双引号
+ * - 空行跳过；文件开头的 UTF-8 BOM 跳过并通过 HasUtf8Bom 报告
+ *
+ * 优先把整个文件映射到内存；映射失败时（管道、32 位进程映射大文件等）退回分块读取。
+ * 字段以 string_view 返回，直接指向映射区或读缓冲，只有含 "" 转义、
+ * 或引号不在字段两端的字段才会复制到内部缓冲。
+ *
+ * 结构字符的查找由 CsvScanner 按 64 字节一块完成（SSE2/AVX2，旧 CPU 退回标量），
+ * 解析器只遍历引号外分隔符的位掩码。
+ *
+ * 分隔符、引号与换行都是 ASCII，GBK 双字节字符的尾字节不会落在这些值上，
+ * 因此 GBK 文件可以直接按字节切分、解析，再转码。
+ */
+
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 一条 CSV 记录
+ *
+ * fields 中的视图在下一次 CsvReader::Next 之前有效。
+ */
+struct CsvRecord {
+    std::vector<std::string_view> fields;
+    long long line = 0;     // 记录起始的物理行号（从 1 开始，引号内的换行也计入）
+};
+
+/**
+ * @brief 按记录边界切分的一段原始数据（多线程解析用）
+ *
+ * 内存映射时是映射区内的视图，分块读取时复制一份；用 CsvReader::OpenChunk 解析。
+ */
+struct CsvChunk {
+    std::string_view mapped;
+    std::string owned;
+    long long firstLine = 1;    // 第一条记录的物理行号
+
+    std::string_view Data() const { return owned.empty() ? mapped : std::string_view(owned); }
+};
+
+/**
+ * @brief 读取方式
+ */
+enum class CsvReadMode {
+    Auto,       // 优先内存映射，失败时分块读取
+    Buffered    // 始终分块读取
+};
+
+/**
+ * @brief 流式 CSV 读取器（非线程安全）
+ */
+class CsvReader {
+public:
+    CsvReader();
+    ~CsvReader();
+
+    // 禁止拷贝
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    /**
+     * @brief 打开文件
+     * @param path UTF-8 路径
+     * @return 成功返回 true，失败时 GetLastError 给出原因
+     */
+    bool Open(const std::string& path, CsvReadMode mode = CsvReadMode::Auto);
+
+#ifdef _WIN32
+    bool Open(const std::wstring& path, CsvReadMode mode = CsvReadMode::Auto);
+#endif
+
+    /**
+     * @brief 解析调用方提供的内存（不复制，data 须在读取期间保持有效）
+     */
+    void OpenMemory(std::string_view data);
+
+    /**
+     * @brief 解析 NextChunk 切出的一段（不检查 BOM，行号从 chunk.firstLine 起算）
+     *
+     * chunk 及其来源的读取器须在解析期间保持有效。
+     */
+    void OpenChunk(const CsvChunk& chunk);
+
+    /**
+     * @brief 关闭文件并释放映射
+     */
+    void Close();
+
+    /**
+     * @brief 读取下一条记录
+     * @return 没有更多记录或读取出错时返回 false（出错时 GetLastError 非空）
+     */
+    bool Next(CsvRecord& record);
+
+    /**
+     * @brief 切出下一段：从当前位置起的若干条完整记录，至少 minBytes 字节（文件末尾除外）
+     *
+     * 只定位记录边界，不构造字段，可与 Next 交替调用。
+     * @return 没有更多数据或读取出错时返回 false
+     */
+    bool NextChunk(size_t minBytes, CsvChunk& chunk);
+
+    bool HasUtf8Bom() const { return m_hasBom; }
+    bool IsMapped() const { return m_mapView != nullptr; }
+
+    /**
+     * @brief 文件大小（字节，分块读取非普通文件时为 0）
+     */
+    uint64_t GetSize() const { return m_totalSize; }
+
+    /**
+     * @brief 已解析的字节数（可用于进度显示）
+     */
+    uint64_t GetBytesConsumed() const { return m_windowOffset + m_pos; }
+
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    /**
+     * @brief 字段在窗口中的位置
+     */
+    struct FieldSpan {
+        size_t offset;
+        size_t length;
+        int quotes;         // 字段内的双引号个数
+    };
+
+    /**
+     * @brief 已分类的 64 字节块（相对窗口的位置），相邻记录共用
+     */
+    struct ScanBlock {
+        size_t pos;
+        size_t length;
+        uint64_t quote;         // 引号
+        uint64_t structural;    // 引号外的分隔符
+        uint64_t quotedLf;      // 引号内的换行（计入行号）
+        uint64_t carry;         // 块末尾在引号内时为全 1
+    };
+
+    enum class ScanResult {
+        Record,     // 得到一条记录
+        Blank,      // 空行
+        NeedMore,   // 窗口内数据不足（仅分块读取）
+        End         // 没有更多数据
+    };
+
+    // 当前可解析的连续数据：映射区，或读缓冲中的有效部分
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos;
+    bool m_eof;                     // 窗口之后没有更多数据
+    uint64_t m_windowOffset;        // 窗口起点在文件中的偏移
+    uint64_t m_totalSize;
+    long long m_line;
+    bool m_hasBom;
+    bool m_started;                 // 是否已处理 BOM
+
+#ifdef _WIN32
+    void* m_file;                   // HANDLE
+    void* m_mapping;                // HANDLE
+#else
+    int m_fd;
+#endif
+    void* m_mapView;
+    size_t m_mapSize;
+
+    std::vector<char> m_buffer;     // 分块读取缓冲
+    ScanBlock m_block;
+    bool m_blockValid;              // 窗口移动后失效
+    std::vector<FieldSpan> m_spans;
+    std::string m_unescaped;        // 需要反转义的字段
+    std::string m_lastError;
+
+    bool OpenHandle(CsvReadMode mode);
+    bool SkipBom();
+    bool Refill();
+    long long ReadSome(char* dest, size_t size);
+
+    void LoadBlock(size_t pos, uint64_t carry);
+    ScanResult ScanRecord(size_t& next, long long& newlines);
+    void BuildFields(CsvRecord& record);
+};
+
+#endif  // CSVREADER_H
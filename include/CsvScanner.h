@@ -0,0 +1,112 @@
+/**
+ * @file CsvScanner.h
+ * @brief CSV 结构字符向量化扫描
+ *
+ * 每次分类 64 字节，得到引号、分隔符（逗号/\r/\n）、换行三个位掩码：
+ * - 引号内区域 = 引号掩码的前缀异或（"" 翻转两次，天然保持在引号内）
+ * - 引号外的分隔符 = 分隔符掩码 & ~引号内区域
+ * 解析器只需按位遍历分隔符，不再逐字节判断。
+ *
+ * 运行时按 CPU 选择实现：AVX2 > SSE2 > 标量。标量实现始终可用，
+ * 也是差分校验（csv_bench --fuzz）的基准。
+ */
+
+#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief 64 字节块的分类结果（第 i 位对应块内第 i 个字节）
+ */
+struct CsvBlockMasks {
+    uint64_t quote;         // "
+    uint64_t separator;     // , \r \n
+    uint64_t lineFeed;      // \n
+};
+
+/**
+ * @brief 分类实现
+ */
+enum class CsvScanKernel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+/**
+ * @brief 结构字符扫描（静态方法，线程安全）
+ */
+class CsvScanner {
+public:
+    /**
+     * @brief 分类一块数据
+     * @param size 块长度，不足 64 字节时高位为 0（不读取越界字节）
+     */
+    static void Classify(const char* data, size_t size, CsvBlockMasks& masks);
+
+    /**
+     * @brief 当前使用的实现（首次调用时按 CPU 选择）
+     */
+    static CsvScanKernel GetKernel();
+
+    /**
+     * @brief 指定实现（基准测试与差分校验用），CPU 不支持时返回 false
+     */
+    static bool SetKernel(CsvScanKernel kernel);
+
+    static bool IsSupported(CsvScanKernel kernel);
+    static const char* GetKernelName(CsvScanKernel kernel);
+
+    /**
+     * @brief 前缀异或：第 i 位为第 0..i 位的异或（引号内区域含开引号，不含闭引号）
+     */
+    static uint64_t PrefixXor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    static int CountBits(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(bits);
+#else
+        // 不使用 __popcnt64：早期 CPU 没有 POPCNT 指令
+        bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+        bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return (int)((bits * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    /**
+     * @brief 最低位 1 的位置（bits 不能为 0）
+     */
+    static int LowestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#elif defined(_M_X64) || defined(_M_ARM64)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return (int)index;
+#else
+        unsigned long index;
+        if (_BitScanForward(&index, (unsigned long)bits)) {
+            return (int)index;
+        }
+        _BitScanForward(&index, (unsigned long)(bits >> 32));
+        return (int)index + 32;
+#endif
+    }
+};
+
+#endif  // CSVSCANNER_H
@@ -0,0 +1,117 @@
+/**
+ * @file CsvWriter.h
+ * @brief 缓冲 CSV 写出器
+ *
+ * 字段直接追加到一块可复用的大缓冲（默认 1 MB），缓冲满时一次写出，
+ * 不经过 iostream，也不为字段或数字创建临时字符串：
+ * - 是否需要加引号按 16 字节一组判断（SSE2，其他平台 8 字节 SWAR），需要时在缓冲内转义
+ * - 数字用 std::to_chars 格式化：整数原样，小数取能精确还原的最短定点表示
+ *   （8999.5 而不是 8999.500000）
+ *
+ * 字段之间的逗号由写出器补上，调用方只需逐个写字段、在行尾调用 EndRecord。
+ */
+
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 缓冲 CSV 写出器（非线程安全）
+ */
+class CsvWriter {
+public:
+    explicit CsvWriter(size_t bufferSize = 1 << 20);
+    ~CsvWriter();
+
+    // 禁止拷贝
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    /**
+     * @brief 创建（或截断）文件
+     * @param path UTF-8 路径
+     * @return 成功返回 true，失败时 GetLastError 给出原因
+     */
+    bool Open(const std::string& path);
+
+#ifdef _WIN32
+    bool Open(const std::wstring& path);
+#endif
+
+    /**
+     * @brief 写出缓冲中剩余的数据并关闭文件
+     * @return 期间所有写入都成功时返回 true
+     */
+    bool Close();
+
+    /**
+     * @brief 写一个字段，按需加引号转义
+     */
+    void WriteField(std::string_view field);
+
+    void WriteField(long long value);
+
+    void WriteField(double value);
+
+    /**
+     * @brief 原样写出（BOM、表头等），不加分隔符也不转义
+     */
+    void WriteRaw(std::string_view data);
+
+    /**
+     * @brief 结束当前记录（写出 \n）
+     */
+    void EndRecord();
+
+    /**
+     * @brief 把缓冲中的数据写入文件
+     */
+    bool Flush();
+
+    /**
+     * @brief 已写出的字节数（含缓冲中未落盘的部分）
+     */
+    uint64_t GetBytesWritten() const { return m_flushed + m_used; }
+
+    bool IsOpen() const;
+
+    /**
+     * @brief 是否已有写入失败（此后的数据都被丢弃，Close 返回 false）
+     */
+    bool HasFailed() const { return m_failed; }
+
+    const std::string& GetLastError() const { return m_lastError; }
+
+    /**
+     * @brief 字段是否含逗号、引号或换行（需要加引号）
+     */
+    static bool NeedsQuote(std::string_view field);
+
+private:
+#ifdef _WIN32
+    void* m_file;                   // HANDLE
+#else
+    int m_fd;
+#endif
+    std::vector<char> m_buffer;
+    size_t m_used;
+    uint64_t m_flushed;
+    bool m_atRecordStart;           // 下一个字段前不需要逗号
+    bool m_failed;                  // 写入失败后丢弃后续数据
+    std::string m_lastError;
+
+    /**
+     * @brief 保证缓冲至少还有 bytes 字节空间，返回写入位置
+     */
+    char* Reserve(size_t bytes);
+
+    void BeginField();
+    bool WriteAll(const char* data, size_t size);
+};
+
+#endif  // CSVWRITER_H
@@ -0,0 +1,64 @@
+/**
+ * @file GbkCodec.h
+ * @brief GBK（CP936）与 UTF-8 互转（查表实现，不依赖操作系统代码页）
+ *
+ * 码表取自 Python 的 gbk 编解码器，与 glibc iconv 的 CP936 一致（gbk_bench --verify 只与 iconv 逐项比较）：
+ * - 0x00-0x7F 为 ASCII，0x80 为欧元符号 U+20AC
+ * - 双字节：首字节 0x81-0xFE，尾字节 0x40-0x7E、0x80-0xFE，共 21791 个已定义字符
+ *
+ * 与 Windows 代码页 936 并不完全相同：Windows 把用户自定义区（0xAAA1-0xAFFE、0xF8A1-0xFEFE、
+ * 0xA140-0xA7A0）映射到私用区 U+E000-U+F8FF，单字节 0xFF 映射到 U+F8F5；这里都不映射，
+ * 按未定义处理。
+ *
+ * 解码时无法识别的字节替换为 U+FFFD：首字节后跟合法尾字节但码位未定义时两个字节一起替换，
+ * 尾字节不合法时只替换首字节，后面的 ASCII（逗号、引号、换行）照常保留。
+ * 编码时 GBK 中没有的字符与非法 UTF-8 字节替换为 '?'。
+ *
+ * ASCII 连续段按 16 字节一组（SSE2，其他平台 8 字节 SWAR）判断后整段复制，
+ * 以 ASCII 为主的数据几乎只有复制的开销。
+ */
+
+#ifndef GBKCODEC_H
+#define GBKCODEC_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class GbkCodec {
+public:
+    /**
+     * @brief GBK 转 UTF-8，结果追加到 utf8
+     * @return 替换为 U+FFFD 的字符数
+     */
+    static size_t ToUtf8(std::string_view gbk, std::string& utf8);
+
+    static std::string ToUtf8(std::string_view gbk);
+
+    /**
+     * @brief UTF-8 转 GBK，结果追加到 gbk
+     * @return 替换为 '?' 的字符数
+     */
+    static size_t FromUtf8(std::string_view utf8, std::string& gbk);
+
+    static std::string FromUtf8(std::string_view utf8);
+
+    /**
+     * @brief 开头连续 ASCII 字节的长度
+     */
+    static size_t AsciiPrefix(const char* data, size_t size);
+
+    static bool IsAscii(std::string_view text) { return AsciiPrefix(text.data(), text.size()) == text.size(); }
+
+    /**
+     * @brief 单个 GBK 双字节码对应的 Unicode 码位，未定义时返回 0
+     */
+    static unsigned int Decode(unsigned char lead, unsigned char trail);
+
+    /**
+     * @brief 单个 BMP 码位对应的 GBK 编码（单字节时小于 0x100），GBK 中没有时返回 0
+     */
+    static unsigned int Encode(unsigned int codePoint);
+};
+
+#endif  // GBKCODEC_H
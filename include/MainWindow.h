@@ -20,6 +20,8 @@
 
 #include "models.h"
 #include "database.h"
+#include "AsyncSearchExecutor.h"
+#include "AssetStore.h"
 
 // 前向声明
 class AssetEditDialog;
@@ -35,6 +37,9 @@ class ChangeLogDialog;
 #define ID_STATUSBAR           1005
 #define ID_TIMER_SEARCH        1006
 
+// 自定义消息：后台搜索完成（lParam 为 AsyncSearchResult*，由接收方释放）
+#define WM_APP_SEARCH_RESULT   (WM_APP + 1)
+
 // 菜单ID定义
 #define IDM_FILE_EXIT          2000
 #define IDM_ASSET_ADD          2100
@@ -45,6 +50,7 @@ class ChangeLogDialog;
 #define IDM_IMPORT_CSV         2300
 #define IDM_EXPORT_CSV         2301
 #define IDM_DOWNLOAD_TEMPLATE  2302
+#define IDM_VALIDATE_CSV       2303
 #define IDM_REFRESH            2400
 #define IDM_CLEAR_FILTERS      2401
 #define IDM_CHANGELOG          2402
@@ -101,7 +107,10 @@ private:
     HWND m_hStatusBar;
 
     Database m_db;
-    std::vector<Asset> m_assets;
+    AsyncSearchExecutor m_searchExecutor;  // 搜索框输入在后台线程执行查询
+    AssetStore m_assetStore;               // 无搜索文本时的列表数据由内存提供
+    std::vector<Asset> m_searchResults;    // 有搜索文本时的查询结果
+    std::vector<const Asset*> m_assets;    // 列表各行，指向 m_assetStore 或 m_searchResults
     std::vector<Category> m_categories;
     int m_selectedAssetId;
 
@@ -140,6 +149,21 @@ private:
      */
     void LoadData();
 
+    /**
+     * @brief 在后台执行搜索（结果通过 WM_APP_SEARCH_RESULT 返回）
+     */
+    void LoadDataAsync();
+
+    /**
+     * @brief 处理后台搜索结果
+     */
+    void OnSearchResult(AsyncSearchResult* result);
+
+    /**
+     * @brief 列表各行改为指向 m_searchResults
+     */
+    void ShowSearchResults();
+
     /**
      * @brief 刷新列表视图
      */
@@ -190,6 +214,11 @@ private:
      */
     void OnImportCSV();
 
+    /**
+     * @brief 检查 CSV（只检查不导入）
+     */
+    void OnValidateCSV();
+
     /**
      * @brief 导出 CSV
      */
@@ -0,0 +1,121 @@
+/**
+ * @file ReadConnectionPool.h
+ * @brief 只读连接池
+ *
+ * 与唯一的写连接并存，在 WAL 模式下让搜索、导出、统计等查询
+ * 可以在任意线程上与写操作并发执行。
+ */
+
+#ifndef READCONNECTIONPOOL_H
+#define READCONNECTIONPOOL_H
+
+#include "database.h"
+#include <memory>
+#include <string>
+
+class ReadConnectionPool;
+
+/**
+ * @brief 连接池的连接与空闲列表，由连接池和借出的租约共同持有
+ */
+struct ReadPoolState;
+
+/**
+ * @brief 只读连接租约
+ *
+ * 持有期间独占一个只读连接，析构时自动归还连接池。
+ * 连接池已关闭（或已销毁）时，归还的连接随即关闭。
+ */
+class ReadLease {
+public:
+    ReadLease() : m_db(nullptr) {}
+    ~ReadLease() { Release(); }
+
+    // 禁止拷贝，允许移动
+    ReadLease(const ReadLease&) = delete;
+    ReadLease& operator=(const ReadLease&) = delete;
+
+    ReadLease(ReadLease&& other) noexcept : m_pool(std::move(other.m_pool)), m_db(other.m_db) {
+        other.m_db = nullptr;
+    }
+
+    ReadLease& operator=(ReadLease&& other) noexcept {
+        if (this != &other) {
+            Release();
+            m_pool = std::move(other.m_pool);
+            m_db = other.m_db;
+            other.m_db = nullptr;
+        }
+        return *this;
+    }
+
+    explicit operator bool() const { return m_db != nullptr; }
+    Database* operator->() const { return m_db; }
+    Database& operator*() const { return *m_db; }
+
+    /**
+     * @brief 提前归还连接
+     */
+    void Release();
+
+private:
+    friend class ReadConnectionPool;
+    ReadLease(std::shared_ptr<ReadPoolState> pool, Database* db) : m_pool(std::move(pool)), m_db(db) {}
+
+    std::shared_ptr<ReadPoolState> m_pool;
+    Database* m_db;
+};
+
+/**
+ * @brief 只读连接池
+ *
+ * Acquire 与租约归还可在任意线程并发调用；Open 不能与 Acquire 并发，
+ * Close 可以（阻塞中的 Acquire 被唤醒并返回空租约）。
+ */
+class ReadConnectionPool {
+public:
+    ReadConnectionPool();
+    ~ReadConnectionPool();
+
+    // 禁止拷贝
+    ReadConnectionPool(const ReadConnectionPool&) = delete;
+    ReadConnectionPool& operator=(const ReadConnectionPool&) = delete;
+
+    /**
+     * @brief 打开 size 个只读连接
+     * @param dbPath 数据库路径（须已由写连接 Initialize 过）
+     * @param size 连接数
+     */
+    bool Open(const std::string& dbPath, int size);
+
+    /**
+     * @brief 关闭连接池
+     *
+     * 空闲连接立即关闭；不等待借出的连接，它们在租约归还时关闭，
+     * 因此持有租约的线程也可以调用（包括析构）。之后 Acquire 返回空租约。
+     */
+    void Close();
+
+    /**
+     * @brief 借出一个连接，全部被占用时阻塞等待
+     * @return 连接池未打开时返回空租约
+     */
+    ReadLease Acquire();
+
+    /**
+     * @brief 连接数
+     */
+    int GetSize() const { return m_size; }
+
+    /**
+     * @brief 获取最后一个错误信息
+     */
+    const std::string& GetLastError() const { return m_lastError; }
+
+private:
+    std::shared_ptr<ReadPoolState> m_state;
+    int m_size;
+    std::string m_lastError;
+};
+
+#endif  // READCONNECTIONPOOL_H
@@ -0,0 +1,148 @@
+/**
+ * @file ReferenceCache.h
+ * @brief 分类、部门、员工字典缓存
+ *
+ * 由 Database 持有（Database::GetReferenceCache），各处的名称与 ID 互查都走这里：
+ * - 启动或首次使用时整表加载三个维度表
+ * - 写连接的 update hook 记录变更的行，下次查找前只重读这些行
+ * - Sync() 检查 PRAGMA data_version，其他连接提交后整表重载
+ *
+ * 查找本身只访问内存；只有存在待应用的变更时才会读取数据库。
+ */
+
+#ifndef REFERENCECACHE_H
+#define REFERENCECACHE_H
+
+#include "models.h"
+#include "database.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief 字典缓存统计
+ */
+struct ReferenceCacheStats {
+    uint64_t fullLoads;       // 整表加载次数
+    uint64_t rowRefreshes;    // 增量重读的行数
+};
+
+/**
+ * @brief 分类/部门/员工字典（非线程安全，与所属 Database 同线程使用）
+ *
+ * 返回的 string_view 在下一次查找或 Sync 之前有效。
+ */
+class ReferenceCache : public DatabaseChangeListener {
+public:
+    explicit ReferenceCache(Database& db);
+    ~ReferenceCache() override;
+
+    // 禁止拷贝
+    ReferenceCache(const ReferenceCache&) = delete;
+    ReferenceCache& operator=(const ReferenceCache&) = delete;
+
+    /**
+     * @brief 与数据库同步：其他连接有提交时整表重载，否则应用本连接的待处理变更
+     *
+     * 在一组查找之前调用一次即可（如打开对话框、开始导入时）。
+     */
+    void Sync();
+
+    /**
+     * @brief 内容版本，每次重载或应用变更后递增（调用方据此判断显示名是否需要刷新）
+     */
+    uint64_t GetVersion() const { return m_version; }
+
+    // ========== 按名称查 ID（未找到返回 -1） ==========
+
+    int FindCategoryId(const std::string& name);
+    int FindDepartmentId(const std::string& name);
+
+    /**
+     * @brief 按 (姓名, 部门) 查找员工，departmentId 为 -1 表示无部门
+     */
+    int FindEmployeeId(const std::string& name, int departmentId);
+
+    /**
+     * @brief 所有同名员工（按 ID 升序）
+     */
+    std::vector<Employee> FindEmployeesByName(const std::string& name);
+
+    // ========== 按 ID 查名称（未找到返回空） ==========
+
+    std::string_view GetCategoryName(int id);
+    std::string_view GetDepartmentName(int id);
+
+    /**
+     * @brief 按 ID 获取员工
+     */
+    bool GetEmployee(int id, Employee& employee);
+
+    ReferenceCacheStats GetStats() const { return m_stats; }
+
+    // DatabaseChangeListener
+    void OnRowChanged(int operation, const char* table, sqlite3_int64 rowid) override;
+    void OnRollback() override;
+
+private:
+    struct EmployeeKey {
+        std::string name;
+        int departmentId;
+
+        bool operator==(const EmployeeKey& other) const {
+            return departmentId == other.departmentId && name == other.name;
+        }
+    };
+
+    struct EmployeeKeyHash {
+        size_t operator()(const EmployeeKey& key) const {
+            return std::hash<std::string>()(key.name) ^ ((size_t)key.departmentId * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    Database& m_db;
+    bool m_listening;
+    int m_dataVersion;
+    uint64_t m_version;
+
+    std::unordered_map<int, std::string> m_categoryNames;
+    std::unordered_map<std::string, int> m_categoryIds;
+    std::unordered_map<int, std::string> m_departmentNames;
+    std::unordered_map<std::string, int> m_departmentIds;
+    std::unordered_map<int, Employee> m_employees;
+    std::unordered_map<EmployeeKey, int, EmployeeKeyHash> m_employeeIds;  // 同键多人时取 ID 最小者
+    std::unordered_map<std::string, std::vector<int>> m_employeesByName;  // ID 升序
+
+    // 待应用的变更（hook 中不能访问数据库，只做记录）
+    std::unordered_set<int> m_dirtyCategories;
+    std::unordered_set<int> m_dirtyDepartments;
+    std::unordered_set<int> m_dirtyEmployees;
+    bool m_hasPending;
+    bool m_needsReload;
+
+    ReferenceCacheStats m_stats;
+
+    void Reload();
+    void ApplyPending();
+
+    /**
+     * @brief 查找前调用：只处理内存中记录的变更，不检查 data_version
+     */
+    void EnsureCurrent() {
+        if (m_hasPending) {
+            ApplyPending();
+        }
+    }
+
+    void PutCategory(int id, const std::string& name);
+    void RemoveCategory(int id);
+    void PutDepartment(int id, const std::string& name);
+    void RemoveDepartment(int id);
+    void PutEmployee(const Employee& employee);
+    void RemoveEmployee(int id);
+};
+
+#endif  // REFERENCECACHE_H
@@ -0,0 +1,107 @@
+/**
+ * @file SchemaMigrator.h
+ * @brief 数据库结构版本迁移
+ *
+ * 以 PRAGMA user_version 记录当前结构版本：
+ * - 每个迁移有一个严格递增的目标版本号，只执行一次
+ * - 每个迁移在独立的 IMMEDIATE 事务中执行，并在同一事务内写入新版本号
+ * - 版本号已是最新时不执行任何 DDL，启动只多一次 PRAGMA 读取
+ *
+ * 大表迁移的写法：
+ * - 回填使用 ExecInBatches 按 rowid 区间分批执行，单条语句的内存占用与表大小无关
+ * - 重建表时先建不带二级索引的新表、复制数据，最后再建索引（批量建索引比逐行维护快得多）
+ */
+
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <sqlite3.h>
+
+/**
+ * @brief 迁移步骤
+ *
+ * apply 在事务内执行，失败时返回 false 并填写 error，整个步骤回滚。
+ */
+struct SchemaMigration {
+    int version;                // 执行后的 user_version
+    std::string description;    // 用于错误信息
+    std::function<bool(sqlite3*, std::string&)> apply;
+};
+
+/**
+ * @brief 迁移执行器
+ */
+class SchemaMigrator {
+public:
+    explicit SchemaMigrator(sqlite3* db) : m_db(db) {}
+
+    /**
+     * @brief 登记迁移步骤（按版本号递增顺序登记）
+     */
+    void Add(int version, const std::string& description,
+             std::function<bool(sqlite3*, std::string&)> apply);
+
+    /**
+     * @brief 已登记的最高版本
+     */
+    int LatestVersion() const {
+        return m_migrations.empty() ? 0 : m_migrations.back().version;
+    }
+
+    /**
+     * @brief 执行所有高于当前版本的迁移
+     *
+     * 数据库版本高于程序支持的版本时拒绝打开，避免旧程序写坏新结构。
+     * @param applied 可选，返回本次实际执行的迁移数量
+     * @return 成功（含无需迁移）返回 true，失败时 GetLastError 给出原因
+     */
+    bool Migrate(int* applied = nullptr);
+
+    /**
+     * @brief 获取最后一个错误信息
+     */
+    const std::string& GetLastError() const { return m_lastError; }
+
+    // ========== 迁移实现可用的辅助函数 ==========
+
+    /**
+     * @brief 读取 PRAGMA user_version，失败返回 -1
+     */
+    static int GetVersion(sqlite3* db);
+
+    /**
+     * @brief 执行一段 SQL（可含多条语句）
+     */
+    static bool Exec(sqlite3* db, const char* sql, std::string& error);
+
+    /**
+     * @brief sqlite_master 中是否存在指定对象
+     * @param type "table" / "index" / "trigger"
+     */
+    static bool ObjectExists(sqlite3* db, const char* type, const char* name);
+
+    /**
+     * @brief 按 rowid 区间分批执行回填语句
+     *
+     * sql 中 ?1、?2 分别绑定区间的下界（不含）和上界（含），
+     * 从 table 的最小 rowid 扫描到最大 rowid，每批 batchRows 个 rowid。
+     */
+    static bool ExecInBatches(sqlite3* db, const char* sql, const char* table,
+                              sqlite3_int64 batchRows, std::string& error);
+
+private:
+    sqlite3* m_db;
+    std::vector<SchemaMigration> m_migrations;
+    std::string m_lastError;
+
+    /**
+     * @brief 在事务中执行单个迁移
+     * @param applied 迁移确实执行（而非已被其他连接完成）时置为 true
+     */
+    bool Apply(const SchemaMigration& migration, bool& applied);
+};
+
+#endif  // SCHEMAMIGRATOR_H
@@ -0,0 +1,161 @@
+/**
+ * @file StatementCache.h
+ * @brief 预编译语句缓存
+ *
+ * 按 SQL 文本缓存 sqlite3_stmt，避免同一语句被反复 prepare/finalize：
+ * - Statement: RAII 句柄，析构时 reset/clear_bindings 归还缓存
+ * - StatementCache: 每个连接一个，按最近使用顺序保留至多 capacity 条，
+ *   满时 finalize 最久未用的空闲语句；在连接关闭前统一 finalize
+ *
+ * SearchAssets 等动态拼接的语句有数百种文本，淘汰保证常用的语句留在缓存中。
+ */
+
+#ifndef STATEMENTCACHE_H
+#define STATEMENTCACHE_H
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <sqlite3.h>
+
+/**
+ * @brief 语句缓存统计
+ */
+struct StatementCacheStats {
+    uint64_t hits;           // 命中次数
+    uint64_t misses;         // 未命中（需要 prepare）次数
+    uint64_t evictions;      // 因缓存已满而 finalize 的语句数
+    uint64_t prepareMicros;  // prepare 累计耗时（微秒）
+    size_t size;             // 当前缓存的语句数
+};
+
+/**
+ * @brief 语句句柄
+ *
+ * 可隐式转换为 sqlite3_stmt*，调用方按原有方式 bind/step 即可。
+ * 缓存语句析构时只 reset 并清除缓存中的使用标记，不缓存的语句析构时 finalize。
+ */
+class Statement {
+public:
+    Statement() : m_stmt(nullptr), m_inUse(nullptr) {}
+    Statement(sqlite3_stmt* stmt, bool* inUse) : m_stmt(stmt), m_inUse(inUse) {}
+    ~Statement() { Release(); }
+
+    // 禁止拷贝，允许移动
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    Statement(Statement&& other) noexcept : m_stmt(other.m_stmt), m_inUse(other.m_inUse) {
+        other.m_stmt = nullptr;
+        other.m_inUse = nullptr;
+    }
+
+    Statement& operator=(Statement&& other) noexcept {
+        if (this != &other) {
+            Release();
+            m_stmt = other.m_stmt;
+            m_inUse = other.m_inUse;
+            other.m_stmt = nullptr;
+            other.m_inUse = nullptr;
+        }
+        return *this;
+    }
+
+    operator sqlite3_stmt*() const { return m_stmt; }
+
+private:
+    sqlite3_stmt* m_stmt;
+    bool* m_inUse;          // 缓存条目的使用标记，不缓存的语句为空
+
+    void Release() {
+        if (!m_stmt) return;
+        if (m_inUse) {
+            sqlite3_reset(m_stmt);
+            sqlite3_clear_bindings(m_stmt);
+            *m_inUse = false;
+            m_inUse = nullptr;
+        } else {
+            sqlite3_finalize(m_stmt);
+        }
+        m_stmt = nullptr;
+    }
+};
+
+/**
+ * @brief 预编译语句缓存（非线程安全，与所属连接同线程使用）
+ */
+class StatementCache {
+public:
+    explicit StatementCache(size_t capacity = 128);
+    ~StatementCache();
+
+    // 禁止拷贝
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    /**
+     * @brief 绑定连接（会先清空旧连接上的缓存）
+     */
+    void Attach(sqlite3* db);
+
+    /**
+     * @brief 获取语句
+     *
+     * 命中时复用缓存语句；同一语句已借出未归还（重入，即使尚未 step）时返回一次性语句。
+     * 未命中且缓存已满时 finalize 最久未用的空闲语句腾出位置，全部借出时返回一次性语句。
+     * prepare 失败返回空句柄。
+     */
+    Statement Acquire(const char* sql);
+    Statement Acquire(const std::string& sql) { return Acquire(sql.c_str()); }
+
+    /**
+     * @brief finalize 所有缓存语句（关闭连接前调用，此时不应有借出的语句）
+     */
+    void Clear();
+
+    /**
+     * @brief 获取统计信息
+     */
+    StatementCacheStats GetStats() const;
+
+    /**
+     * @brief 重置统计计数
+     */
+    void ResetStats();
+
+    /**
+     * @brief 设置 prepare 观察者，每次实际 prepare 时以 SQL 文本调用（用于收集语句）
+     *
+     * observer 为空时移除。
+     */
+    void SetPrepareObserver(std::function<void(const char*)> observer) {
+        m_prepareObserver = std::move(observer);
+    }
+
+private:
+    /**
+     * @brief finalize 最久未用的空闲语句，全部借出时返回 false
+     */
+    bool EvictOne();
+
+    struct Entry {
+        std::string sql;
+        sqlite3_stmt* stmt;
+        bool inUse;                 // 已借出未归还（Statement 析构时清除）
+    };
+
+    sqlite3* m_db;
+    size_t m_capacity;
+    std::list<Entry> m_lru;         // 最近使用的在前；节点地址不变，Statement 持有 inUse 的地址
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;   // 键指向 Entry::sql
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+    uint64_t m_prepareMicros;
+    std::function<void(const char*)> m_prepareObserver;
+};
+
+#endif  // STATEMENTCACHE_H
@@ -12,10 +12,193 @@
 #define DATABASE_H
 
 #include "models.h"
+#include "StatementCache.h"
 #include <vector>
 #include <unordered_map>
+#include <functional>
+#include <string_view>
+#include <optional>
+#include <memory>
 #include <sqlite3.h>
 
+/**
+ * @brief 资产排序字段（顺序与主窗口列表列一致）
+ */
+enum class AssetSortField {
+    Id = 0,
+    Code,
+    Name,
+    Category,
+    User,
+    PurchaseDate,
+    Price,
+    Location,
+    Status,
+    Remark
+};
+
+/**
+ * @brief 资产查询条件
+ */
+struct AssetFilter {
+    std::string searchText;     // 搜索关键词（空表示不限）
+    int categoryId = -1;        // 分类筛选（-1表示全部）
+    std::string status;         // 状态筛选（空字符串表示全部）
+    AssetSortField sortField = AssetSortField::Id;
+    bool ascending = false;     // 默认按 ID 降序
+};
+
+/**
+ * @brief 分页游标位置：上一页最后一行的 (排序键, id)
+ */
+struct AssetPageKey {
+    bool valid = false;         // false 表示从第一页开始
+    std::string text;           // 文本排序键
+    double number = 0.0;        // 数值排序键（ID、金额）
+    int id = 0;
+};
+
+/**
+ * @brief 变更时间范围 [from, to)，Unix 时间戳（秒）
+ *
+ * 变更时间以整数存储，范围条件直接在 (change_time, id) 索引上定位。
+ */
+struct ChangeLogTimeRange {
+    std::optional<long long> from;  // 起始时间（含），空表示不限
+    std::optional<long long> to;    // 结束时间（不含），空表示不限
+
+    /**
+     * @brief 由本地日期 "YYYY-MM-DD" 构造范围，含起止两天全天
+     *
+     * 空字符串或无法解析的日期表示该端不限。
+     */
+    static ChangeLogTimeRange FromLocalDates(const std::string& startDate, const std::string& endDate);
+};
+
+/**
+ * @brief 变更日志查询条件
+ */
+struct ChangeLogFilter {
+    std::string searchText;     // 搜索关键词（资产编号、名称、字段名，空表示不限）
+    ChangeLogTimeRange time;    // 变更时间范围
+    int assetId = -1;           // 资产筛选（-1表示全部）
+};
+
+/**
+ * @brief 变更日志分页游标位置：上一页最后一行的 (change_time, id)
+ */
+struct ChangeLogPageKey {
+    bool valid = false;         // false 表示从最新一条开始
+    long long changeTime = 0;
+    int id = 0;
+};
+
+/**
+ * @brief 资产行视图
+ *
+ * 文本字段直接指向 SQLite 列缓冲区，仅在回调期间有效，需要保留时自行拷贝。
+ */
+struct AssetRowView {
+    int id;
+    std::string_view assetCode;
+    std::string_view name;
+    int categoryId;             // -1 表示无分类
+    int userId;                 // -1 表示无使用人
+    std::string_view purchaseDate;
+    double price;
+    std::string_view location;
+    std::string_view status;
+    std::string_view remark;
+    std::string_view categoryName;
+    std::string_view userName;
+    std::string_view departmentName;
+};
+
+/**
+ * @brief 变更日志行视图（生命周期同 AssetRowView）
+ */
+struct ChangeLogRowView {
+    int id;
+    int assetId;
+    std::string_view assetCode;
+    std::string_view assetName;
+    std::string_view fieldName;
+    std::string_view oldValue;
+    std::string_view newValue;
+    long long changeTime;       // Unix 时间戳（秒）
+};
+
+/**
+ * @brief 批量插入中单行失败的信息
+ */
+struct AssetInsertError {
+    size_t index;           // 在输入数组中的下标
+    bool duplicateCode;     // 是否因资产编号已存在而跳过
+    std::string message;    // 错误描述
+};
+
+/**
+ * @brief 一段连续预留的资产编号：prefix + [first, first + count)，数字部分补零到 width 位
+ */
+struct AssetCodeBlock {
+    std::string prefix;
+    long long first = 0;
+    int count = 0;
+    int width = 0;
+
+    /**
+     * @brief 第 index 个编号（0 <= index < count）
+     */
+    std::string At(int index) const;
+};
+
+/**
+ * @brief 资产汇总的一个分组
+ */
+struct AssetSummaryGroup {
+    int id;                 // 分类/部门 ID，0 表示未分类/无部门；按状态分组时为 0
+    std::string name;       // 状态、分类名或部门名
+    int count;              // 资产数量
+    double totalPrice;      // 总价值
+};
+
+/**
+ * @brief 资产汇总（由触发器维护的聚合表读取）
+ */
+struct AssetSummary {
+    int totalCount;
+    double totalPrice;
+    std::vector<AssetSummaryGroup> byStatus;
+    std::vector<AssetSummaryGroup> byCategory;
+    std::vector<AssetSummaryGroup> byDepartment;
+};
+
+class ReferenceCache;
+
+/**
+ * @brief 数据变更监听接口
+ *
+ * 由写连接的 sqlite3_update_hook / sqlite3_rollback_hook 驱动。
+ * 回调发生在语句执行过程中，实现中不得访问数据库，只应记录变更。
+ */
+class DatabaseChangeListener {
+public:
+    virtual ~DatabaseChangeListener() = default;
+
+    /**
+     * @brief 行变更
+     * @param operation SQLITE_INSERT / SQLITE_UPDATE / SQLITE_DELETE
+     * @param table 表名
+     * @param rowid 行 ID
+     */
+    virtual void OnRowChanged(int operation, const char* table, sqlite3_int64 rowid) = 0;
+
+    /**
+     * @brief 事务回滚（此前通知的变更可能已撤销）
+     */
+    virtual void OnRollback() = 0;
+};
+
 /**
  * @brief 数据库管理类
  *
@@ -31,10 +214,18 @@ public:
     Database& operator=(const Database&) = delete;
 
     /**
-     * @brief 初始化数据库
+     * @brief 初始化数据库（读写连接，负责建表）
+     * @param dbPath 数据库文件路径
      * @return 成功返回 true
      */
-    bool Initialize();
+    bool Initialize(const std::string& dbPath = "assets.db");
+
+    /**
+     * @brief 以只读方式打开已初始化的数据库（供读连接池使用）
+     *
+     * 只读连接上可以调用所有查询接口，写操作会失败。
+     */
+    bool OpenReadOnly(const std::string& dbPath);
 
     /**
      * @brief 关闭数据库连接
@@ -46,6 +237,16 @@ public:
      */
     bool IsOpen() const { return m_db != nullptr; }
 
+    /**
+     * @brief 是否为只读连接
+     */
+    bool IsReadOnly() const { return m_readOnly; }
+
+    /**
+     * @brief 数据库文件路径
+     */
+    const std::string& GetPath() const { return m_path; }
+
     // ========== 分类操作 ==========
 
     /**
@@ -182,6 +383,28 @@ public:
                                     int categoryId = -1,
                                     const std::string& status = "");
 
+    /**
+     * @brief 分页搜索资产（键集分页）
+     *
+     * 按 (排序键, id) 定位到 afterKey 之后，不使用 OFFSET，
+     * 取任意一页的代价只与页大小有关。
+     * @param filter 查询条件和排序方式
+     * @param afterKey 上一页的结束位置（无效表示第一页）
+     * @param pageSize 每页行数
+     * @param nextKey 可选，返回本页最后一行的位置
+     */
+    std::vector<Asset> SearchAssetsPage(const AssetFilter& filter, const AssetPageKey& afterKey,
+                                        int pageSize, AssetPageKey* nextKey = nullptr);
+
+    /**
+     * @brief 流式遍历资产，不构造 Asset 对象
+     * @param filter 查询条件和排序方式
+     * @param visitor 每行回调一次，返回 false 提前结束
+     * @return 查询成功返回 true
+     */
+    bool ForEachAsset(const AssetFilter& filter,
+                      const std::function<bool(const AssetRowView&)>& visitor);
+
     /**
      * @brief 根据ID获取资产
      */
@@ -193,17 +416,58 @@ public:
     bool GetAssetByCode(const std::string& code, Asset& asset);
 
     /**
-     * @brief 获取最后一条资产记录（用于生成编号）
+     * @brief 资产编号是否已存在（只查唯一索引，不读资产行）
+     */
+    bool HasAssetCode(std::string_view code);
+
+    /**
+     * @brief 获取最后一条资产记录
      */
     bool GetLastAsset(Asset& asset);
 
+    /**
+     * @brief 原子地预留一段连续的资产编号
+     *
+     * 每个前缀对应 sequences 表中的一个序列，一条 UPSERT 语句推进序列并返回起始值，
+     * 多个进程同时预留也不会得到重复编号；预留后未使用的编号不回收。
+     * 前缀首次使用时从 1 开始、数字部分 3 位。手工录入或导入的编号由触发器推进序列，
+     * 之后预留的编号不会与之冲突。
+     * @param prefix 编号前缀（如 "ZC"）
+     * @param count 预留数量
+     * @param block 返回预留到的编号段
+     */
+    bool ReserveAssetCodes(const std::string& prefix, int count, AssetCodeBlock& block);
+
+    /**
+     * @brief 前缀的下一个编号（只读，不占用序列）
+     */
+    std::string PeekAssetCode(const std::string& prefix);
+
+    /**
+     * @brief 默认编号前缀：最近添加的资产编号去掉末尾数字，没有资产时为 "ZC"
+     */
+    std::string GetDefaultAssetCodePrefix();
+
     /**
      * @brief 添加资产
      */
     bool AddAsset(Asset& asset);
 
+    /**
+     * @brief 批量添加资产
+     *
+     * 使用多行 VALUES 语句在一个事务内插入（调用方已开启事务时并入其中），
+     * 成功的行回填 id，失败的行 id 置为 -1 并记录到 errors，不影响其余行。
+     * @param assets 待插入的资产
+     * @param errors 可选，接收逐行失败信息
+     * @return 成功插入的行数
+     */
+    int AddAssets(std::vector<Asset>& assets, std::vector<AssetInsertError>* errors = nullptr);
+
     /**
      * @brief 更新资产
+     *
+     * 变更日志由触发器在同一条 UPDATE 中写入（分类、使用人记录名称），调用方无需再写日志。
      */
     bool UpdateAsset(const Asset& asset);
 
@@ -217,10 +481,20 @@ public:
      */
     bool GetAssetStats(int& count, double& totalPrice);
 
+    /**
+     * @brief 获取按状态、分类、部门分组的数量与价值
+     *
+     * 读取触发器维护的 asset_summary 表，耗时只与分组数有关。
+     */
+    bool GetAssetSummary(AssetSummary& summary);
+
     // ========== 变更日志操作 ==========
 
     /**
      * @brief 添加变更日志
+     *
+     * 日志按字典编码存储（字段 ID + 新旧值），assetCode、assetName 不保存，
+     * 读取时由 assetId 关联资产得到。
      */
     bool AddChangeLog(const AssetChangeLog& log);
 
@@ -241,15 +515,35 @@ public:
      */
     std::vector<AssetChangeLog> GetAllChangeLogs(int limit = -1, int offset = 0);
 
+    /**
+     * @brief 按时间倒序分页获取变更日志（键集分页）
+     *
+     * 按 (change_time, id) 定位到 before 之前，不使用 OFFSET，
+     * 取任意一页的代价只与页大小有关。
+     * @param before 上一页的结束位置（无效表示从最新一条开始）
+     * @param pageSize 每页行数
+     * @param filter 查询条件
+     * @param nextKey 可选，返回本页最后一行的位置
+     */
+    std::vector<AssetChangeLog> GetChangeLogsBefore(const ChangeLogPageKey& before, int pageSize,
+                                                    const ChangeLogFilter& filter = ChangeLogFilter(),
+                                                    ChangeLogPageKey* nextKey = nullptr);
+
     /**
      * @brief 搜索变更日志
      * @param searchText 搜索关键词（资产编号、名称、字段名）
-     * @param startDate 开始日期（空字符串表示不限）
-     * @param endDate 结束日期（空字符串表示不限）
+     * @param time 变更时间范围（默认不限）
      */
     std::vector<AssetChangeLog> SearchChangeLogs(const std::string& searchText,
-                                                  const std::string& startDate = "",
-                                                  const std::string& endDate = "");
+                                                  const ChangeLogTimeRange& time = ChangeLogTimeRange());
+
+    /**
+     * @brief 流式遍历变更日志（条件同 SearchChangeLogs，均为空时遍历全部）
+     * @param visitor 每行回调一次，返回 false 提前结束
+     * @return 查询成功返回 true
+     */
+    bool ForEachChangeLog(const std::string& searchText, const ChangeLogTimeRange& time,
+                          const std::function<bool(const ChangeLogRowView&)>& visitor);
 
     /**
      * @brief 获取变更日志总数
@@ -263,6 +557,55 @@ public:
      */
     const std::string& GetLastError() const { return m_lastError; }
 
+    /**
+     * @brief 注册数据变更监听（仅写连接有效，监听者需先于 Database 注销）
+     */
+    void AddChangeListener(DatabaseChangeListener* listener);
+
+    /**
+     * @brief 注销数据变更监听
+     */
+    void RemoveChangeListener(DatabaseChangeListener* listener);
+
+    /**
+     * @brief 分类/部门/员工字典缓存
+     *
+     * 首次调用时加载，之后随本连接的写入增量更新（见 ReferenceCache），随连接关闭释放。
+     */
+    ReferenceCache& GetReferenceCache();
+
+    /**
+     * @brief 读取 PRAGMA data_version
+     *
+     * 其他连接（包括其他进程）提交修改后该值会变化，本连接自身的修改不会。
+     */
+    int GetDataVersion();
+
+    /**
+     * @brief 设置进度回调（每执行约 instructions 条虚拟机指令调用一次）
+     *
+     * 回调返回非 0 时当前语句以 SQLITE_INTERRUPT 中止，用于取消长查询。
+     * handler 为 nullptr 时移除回调。
+     */
+    void SetProgressHandler(int instructions, int (*handler)(void*), void* context);
+
+    /**
+     * @brief 获取预编译语句缓存统计（命中/未命中/prepare 耗时）
+     */
+    StatementCacheStats GetStatementCacheStats() const { return m_stmtCache.GetStats(); }
+
+    /**
+     * @brief 重置语句缓存统计
+     */
+    void ResetStatementCacheStats() { m_stmtCache.ResetStats(); }
+
+    /**
+     * @brief 设置语句观察者，每条 SQL 首次 prepare 时调用（查询计划检查用于收集语句）
+     */
+    void SetStatementObserver(std::function<void(const char*)> observer) {
+        m_stmtCache.SetPrepareObserver(std::move(observer));
+    }
+
     /**
      * @brief 开始事务
      */
@@ -278,9 +621,31 @@ public:
      */
     bool Rollback();
 
+    /**
+     * @brief 开始批量导入（须在事务内调用）
+     *
+     * 停用插入资产时逐行维护全文索引、汇总表和编号序列的触发器，
+     * 由 EndBulkLoad 对本事务插入的行一次性补做。两者之间只允许插入资产。
+     */
+    bool BeginBulkLoad();
+
+    /**
+     * @brief 结束批量导入：补做全文索引、汇总表和编号序列，恢复逐行触发器
+     *
+     * 须在提交前调用；失败时调用方应回滚事务。
+     */
+    bool EndBulkLoad();
+
 private:
     sqlite3* m_db;
+    std::string m_path;
+    bool m_readOnly;
     std::string m_lastError;
+    StatementCache m_stmtCache;  // 按 SQL 文本缓存的预编译语句
+    std::vector<DatabaseChangeListener*> m_changeListeners;
+    std::unique_ptr<ReferenceCache> m_referenceCache;
+    bool m_hasAssetFts;          // assets_fts 全文索引是否可用
+    long long m_bulkLoadFromId;  // 批量导入开始前的最大资产 ID，未在批量导入中为 -1
 
     /**
      * @brief 设置错误信息
@@ -290,14 +655,68 @@ private:
     }
 
     /**
-     * @brief 创建表结构
+     * @brief sqlite3_update_hook 回调，转发给监听者
+     */
+    static void UpdateHook(void* context, int operation, const char* dbName,
+                           const char* table, sqlite3_int64 rowid);
+
+    /**
+     * @brief sqlite3_rollback_hook 回调，转发给监听者
      */
-    bool CreateTables();
+    static void RollbackHook(void* context);
+
+    /**
+     * @brief 执行结构迁移（见 SchemaMigrator），完成后探测全文索引
+     */
+    bool MigrateSchema();
+
+    /**
+     * @brief 资产全文检索索引是否存在（SQLite 未启用 FTS5 时不会创建）
+     */
+    bool DetectSearchIndex();
+
+    /**
+     * @brief 搜索词是否可以走 trigram 全文索引
+     */
+    bool UseAssetFtsMatch(const std::string& searchText) const;
+
+    /**
+     * @brief 生成资产筛选条件（以 " AND ..." 形式追加到 WHERE 1=1 之后）
+     */
+    std::string BuildAssetFilterSql(const std::string& searchText,
+                                    int categoryId, const std::string& status) const;
+
+    /**
+     * @brief 按 BuildAssetFilterSql 的顺序绑定参数
+     * @return 下一个可用的参数序号
+     */
+    int BindAssetFilter(sqlite3_stmt* stmt, int paramIdx, const std::string& searchText,
+                        int categoryId, const std::string& status) const;
+
+    /**
+     * @brief 生成变更日志筛选条件（以 " AND ..." 形式追加）
+     */
+    std::string BuildChangeLogFilterSql(const std::string& searchText,
+                                        const ChangeLogTimeRange& time) const;
+
+    /**
+     * @brief 按 BuildChangeLogFilterSql 的顺序绑定参数
+     * @return 下一个可用的参数序号
+     */
+    int BindChangeLogFilter(sqlite3_stmt* stmt, int paramIdx, const std::string& searchText,
+                            const ChangeLogTimeRange& time) const;
 
     /**
      * @brief 初始化默认数据
      */
     bool InitializeDefaultData();
+
+    /**
+     * @brief 插入 assets[begin, begin + rows)，供 AddAssets 分批调用
+     * @return 成功插入的行数
+     */
+    int InsertAssetRows(std::vector<Asset>& assets, size_t begin, int rows,
+                        std::vector<AssetInsertError>* errors);
 };
 
 #endif  // DATABASE_H
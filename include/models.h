@@ -66,12 +66,12 @@ struct Asset {
 struct AssetChangeLog {
     int id;
     int assetId;            // 关联的资产ID
-    std::string assetCode;  // 资产编号（冗余存储，便于查询）
-    std::string assetName;  // 资产名称（冗余存储）
+    std::string assetCode;  // 资产编号（读取时关联资产表得到，写入时忽略）
+    std::string assetName;  // 资产名称（同上）
     std::string fieldName;  // 变更的字段名
     std::string oldValue;   // 旧值
     std::string newValue;   // 新值
-    std::string changeTime; // 变更时间
+    long long changeTime = 0; // 变更时间（Unix 时间戳，秒；显示时再转换为本地时间）
 };
 
 #endif  // MODELS_H
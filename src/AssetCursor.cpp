@@ -0,0 +1,38 @@
+/**
+ * @file AssetCursor.cpp
+ * @brief 资产分页游标实现
+ */
+
+#include "AssetCursor.h"
+
+AssetCursor::AssetCursor(Database& db, const AssetFilter& filter, int pageSize)
+    : m_db(db)
+    , m_filter(filter)
+    , m_pageSize(pageSize > 0 ? pageSize : 200)
+    , m_hasMore(true)
+{
+}
+
+std::vector<Asset> AssetCursor::FetchNext() {
+    if (!m_hasMore) {
+        return std::vector<Asset>();
+    }
+
+    std::vector<Asset> page = m_db.SearchAssetsPage(m_filter, m_position, m_pageSize, &m_position);
+
+    // 不足一页说明已到末尾，省去一次空查询
+    if ((int)page.size() < m_pageSize) {
+        m_hasMore = false;
+    }
+    return page;
+}
+
+void AssetCursor::Reset() {
+    m_position = AssetPageKey();
+    m_hasMore = true;
+}
+
+void AssetCursor::SetFilter(const AssetFilter& filter) {
+    m_filter = filter;
+    Reset();
+}
@@ -4,10 +4,9 @@
  */
 
 #include "AssetEditDialog.h"
+#include "ReferenceCache.h"
 #include <commctrl.h>
 #include <windowsx.h>
-#include <regex>
-#include <unordered_map>
 
 AssetEditDialog::AssetEditDialog(Database& db)
     : m_db(db)
@@ -41,8 +40,10 @@ bool AssetEditDialog::ShowAdd(HWND hParent, int copyFromId) {
         }
     }
 
-    // 生成新编号
-    m_asset.assetCode = GetNextAssetCode();
+    // 预填下一个编号；只读取序列，取消时不浪费编号
+    m_codePrefix = m_db.GetDefaultAssetCodePrefix();
+    m_suggestedCode = m_db.PeekAssetCode(m_codePrefix);
+    m_asset.assetCode = m_suggestedCode;
 
     INT_PTR result = DialogBoxParamW(
         GetModuleHandle(nullptr),
@@ -135,6 +136,9 @@ void AssetEditDialog::InitDialog() {
     // 设置字体
     HFONT hFont = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
 
+    // 同步字典缓存，保存时按姓名查找使用人
+    m_db.GetReferenceCache().Sync();
+
     // 加载分类列表
     m_categories = m_db.GetAllCategories();
     HWND hComboCat = GetDlgItem(m_hDlg, IDA_COMBO_CATEGORY);
@@ -329,6 +333,11 @@ bool AssetEditDialog::SaveAsset() {
     // 保存到数据库
     bool result;
     if (m_assetId < 0) {
+        // 未修改预填编号时从序列原子地占用一个，其他进程在此期间占用了同一编号时顺延
+        AssetCodeBlock block;
+        if (m_asset.assetCode == m_suggestedCode && m_db.ReserveAssetCodes(m_codePrefix, 1, block)) {
+            m_asset.assetCode = block.At(0);
+        }
         result = m_db.AddAsset(m_asset);
     } else {
         result = m_db.UpdateAsset(m_asset);
@@ -364,33 +373,6 @@ bool AssetEditDialog::ValidateInput() {
     return true;
 }
 
-std::string AssetEditDialog::GetNextAssetCode() {
-    Asset lastAsset;
-    if (m_db.GetLastAsset(lastAsset)) {
-        // 解析最后一个编号
-        std::string code = lastAsset.assetCode;
-        static const std::regex re(R"((\D*)(\d+))");
-        std::smatch match;
-        if (std::regex_match(code, match, re)) {
-            std::string prefix = match[1].str();
-            int number = std::stoi(match[2].str());
-            number++;
-
-            // 计算数字位数
-            std::string numStr = match[2].str();
-            int digits = (int)numStr.length();
-
-            // 格式化新编号
-            char fmt[32];
-            sprintf_s(fmt, "%%s%%0%dd", digits);
-            char newCode[64];
-            sprintf_s(newCode, fmt, prefix.c_str(), number);
-            return std::string(newCode);
-        }
-    }
-    return "ZC001";
-}
-
 std::string AssetEditDialog::GetUserName() {
     wchar_t buf[256];
     GetWindowTextW(GetDlgItem(m_hDlg, IDA_EDIT_USER), buf, 256);
@@ -404,8 +386,9 @@ int AssetEditDialog::FindEmployeeId(const std::string& name, int deptId) {
         return -1;
     }
 
-    // 根据姓名查找员工
-    std::vector<Employee> employees = m_db.GetEmployeesByName(name);
+    // 根据姓名查找员工（字典缓存，不查询数据库）
+    ReferenceCache& refs = m_db.GetReferenceCache();
+    std::vector<Employee> employees = refs.FindEmployeesByName(name);
 
     if (employees.empty()) {
         // 未找到员工
@@ -424,29 +407,21 @@ int AssetEditDialog::FindEmployeeId(const std::string& name, int deptId) {
 
     // 多个同名员工，使用部门筛选
     if (deptId >= 0) {
-        for (const auto& emp : employees) {
-            if (emp.departmentId == deptId) {
-                return emp.id;
-            }
+        int id = refs.FindEmployeeId(name, deptId);
+        if (id >= 0) {
+            return id;
         }
     }
 
-    // 建立部门ID到名称的映射，避免嵌套循环 O(n*m) -> O(n+m)
-    std::unordered_map<int, const std::string*> deptMap;
-    for (const auto& dept : m_departments) {
-        deptMap[dept.id] = &dept.name;
-    }
-
     // 仍有歧义，构建提示消息
     std::string msg;
     msg.reserve(256);  // 预分配内存
     msg = "存在多个姓名为 '" + name + "' 的员工：\n";
     for (const auto& emp : employees) {
         msg += "  - " + emp.name;
-        // 获取部门名称 - O(1) 查找
-        auto it = deptMap.find(emp.departmentId);
-        if (it != deptMap.end()) {
-            msg += " (" + *it->second + ")";
+        std::string_view deptName = refs.GetDepartmentName(emp.departmentId);
+        if (!deptName.empty()) {
+            msg += " (" + std::string(deptName) + ")";
         }
         msg += "\n";
     }
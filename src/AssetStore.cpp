@@ -0,0 +1,237 @@
+/**
+ * @file AssetStore.cpp
+ * @brief 内存资产表实现
+ */
+
+#include "AssetStore.h"
+#include "ReferenceCache.h"
+#include <cstring>
+
+// 待重读的行数超过该值（或超过表大小的 1/8）时整表重载更快
+static const size_t kMaxIncrementalRows = 4096;
+
+AssetStore::AssetStore(Database& db)
+    : m_db(db)
+    , m_loaded(false)
+    , m_listening(false)
+    , m_dataVersion(-1)
+    , m_namesDirty(false)
+    , m_needsReload(false)
+    , m_stats()
+{
+}
+
+AssetStore::~AssetStore() {
+    Unload();
+}
+
+bool AssetStore::Load() {
+    if (!m_db.IsOpen()) {
+        return false;
+    }
+    if (!m_listening) {
+        m_db.AddChangeListener(this);
+        m_listening = true;
+    }
+    return Reload();
+}
+
+void AssetStore::Unload() {
+    if (m_listening) {
+        m_db.RemoveChangeListener(this);
+        m_listening = false;
+    }
+    m_assets.clear();
+    m_dirtyAssets.clear();
+    m_loaded = false;
+}
+
+bool AssetStore::Reload() {
+    m_dirtyAssets.clear();
+    m_namesDirty = false;
+    m_needsReload = false;
+    m_dataVersion = m_db.GetDataVersion();
+
+    m_assets.clear();
+    for (Asset& asset : m_db.GetAllAssets()) {
+        int id = asset.id;
+        m_assets.emplace(id, std::move(asset));
+    }
+
+    m_stats.fullLoads++;
+    m_loaded = true;
+    return true;
+}
+
+void AssetStore::ResolveNames(Asset& asset) const {
+    ReferenceCache& refs = m_db.GetReferenceCache();
+    asset.categoryName = refs.GetCategoryName(asset.categoryId);
+
+    Employee employee;
+    if (refs.GetEmployee(asset.userId, employee)) {
+        asset.userName = employee.name;
+        asset.departmentName = refs.GetDepartmentName(employee.departmentId);
+    } else {
+        asset.userName.clear();
+        asset.departmentName.clear();
+    }
+}
+
+void AssetStore::Sync() {
+    if (!m_loaded) {
+        return;
+    }
+
+    // 其他连接的提交不会触发本连接的 hook
+    if (m_needsReload || m_db.GetDataVersion() != m_dataVersion) {
+        Reload();
+        return;
+    }
+
+    if (m_dirtyAssets.size() > kMaxIncrementalRows ||
+        m_dirtyAssets.size() > m_assets.size() / 8 + 64) {
+        Reload();
+        return;
+    }
+
+    // 先刷新显示名，随后重读的行本身已带最新名称
+    if (m_namesDirty) {
+        m_db.GetReferenceCache().Sync();
+        for (auto& entry : m_assets) {
+            ResolveNames(entry.second);
+        }
+        m_namesDirty = false;
+        m_stats.nameRefreshes++;
+    }
+
+    for (int id : m_dirtyAssets) {
+        Asset asset;
+        if (m_db.GetAssetById(id, asset)) {
+            m_assets[id] = std::move(asset);
+            m_stats.rowRefreshes++;
+        } else if (m_assets.erase(id) > 0) {
+            m_stats.rowRemovals++;
+        }
+    }
+    m_dirtyAssets.clear();
+}
+
+std::vector<const Asset*> AssetStore::Query(int categoryId, const std::string& status) {
+    Sync();
+
+    std::vector<const Asset*> result;
+    if (categoryId < 0 && status.empty()) {
+        result.reserve(m_assets.size());
+    }
+    for (const auto& entry : m_assets) {
+        const Asset& asset = entry.second;
+        if (categoryId >= 0 && asset.categoryId != categoryId) {
+            continue;
+        }
+        if (!status.empty() && asset.status != status) {
+            continue;
+        }
+        result.push_back(&asset);
+    }
+    return result;
+}
+
+bool AssetStore::Get(int id, Asset& asset) {
+    Sync();
+
+    auto it = m_assets.find(id);
+    if (it == m_assets.end()) {
+        return false;
+    }
+    asset = it->second;
+    return true;
+}
+
+size_t AssetStore::Size() {
+    Sync();
+    return m_assets.size();
+}
+
+// 辅助函数：比较两条资产记录，记录不同的字段
+static void DiffAsset(const Asset& stored, const Asset& actual, std::vector<std::string>& fields) {
+    if (stored.assetCode != actual.assetCode) fields.push_back("asset_code");
+    if (stored.name != actual.name) fields.push_back("name");
+    if (stored.categoryId != actual.categoryId) fields.push_back("category_id");
+    if (stored.userId != actual.userId) fields.push_back("user_id");
+    if (stored.purchaseDate != actual.purchaseDate) fields.push_back("purchase_date");
+    if (stored.price != actual.price) fields.push_back("price");
+    if (stored.location != actual.location) fields.push_back("location");
+    if (stored.status != actual.status) fields.push_back("status");
+    if (stored.remark != actual.remark) fields.push_back("remark");
+    if (stored.categoryName != actual.categoryName) fields.push_back("category_name");
+    if (stored.userName != actual.userName) fields.push_back("user_name");
+    if (stored.departmentName != actual.departmentName) fields.push_back("department_name");
+}
+
+bool AssetStore::VerifyConsistency(std::vector<std::string>* differences) {
+    Sync();
+
+    bool consistent = true;
+    auto report = [&](const std::string& message) {
+        consistent = false;
+        if (differences) {
+            differences->push_back(message);
+        }
+    };
+
+    std::vector<Asset> actual = m_db.GetAllAssets();
+    std::unordered_set<int> seen;
+    seen.reserve(actual.size());
+
+    std::vector<std::string> fields;
+    for (const Asset& row : actual) {
+        seen.insert(row.id);
+        auto it = m_assets.find(row.id);
+        if (it == m_assets.end()) {
+            report("资产 " + std::to_string(row.id) + " 缺失");
+            continue;
+        }
+        fields.clear();
+        DiffAsset(it->second, row, fields);
+        if (!fields.empty()) {
+            std::string message = "资产 " + std::to_string(row.id) + " 字段不一致:";
+            for (const std::string& field : fields) {
+                message += " " + field;
+            }
+            report(message);
+        }
+    }
+
+    for (const auto& entry : m_assets) {
+        if (seen.find(entry.first) == seen.end()) {
+            report("资产 " + std::to_string(entry.first) + " 已不存在");
+        }
+    }
+
+    return consistent;
+}
+
+void AssetStore::OnRowChanged(int /*operation*/, const char* table, sqlite3_int64 rowid) {
+    if (m_needsReload) {
+        return;
+    }
+    if (std::strcmp(table, "assets") == 0) {
+        // 超过阈值后整表重载，不必继续记录
+        if (m_dirtyAssets.size() > kMaxIncrementalRows) {
+            m_needsReload = true;
+            m_dirtyAssets.clear();
+        } else {
+            m_dirtyAssets.insert((int)rowid);
+        }
+    } else if (std::strcmp(table, "categories") == 0 ||
+               std::strcmp(table, "employees") == 0 ||
+               std::strcmp(table, "departments") == 0) {
+        m_namesDirty = true;
+    }
+}
+
+void AssetStore::OnRollback() {
+    // 已记录的变更可能被撤销，无法逐行区分
+    m_needsReload = true;
+    m_dirtyAssets.clear();
+}
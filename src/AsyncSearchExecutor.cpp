@@ -0,0 +1,125 @@
+/**
+ * @file AsyncSearchExecutor.cpp
+ * @brief 后台搜索执行器实现
+ */
+
+#include "AsyncSearchExecutor.h"
+
+// 进度回调间隔（虚拟机指令数），约为亚毫秒级的取消延迟
+static const int kProgressInstructions = 1000;
+
+AsyncSearchExecutor::AsyncSearchExecutor(ResultCallback onResult)
+    : m_onResult(std::move(onResult))
+    , m_pendingGeneration(0)
+    , m_hasPending(false)
+    , m_stopping(false)
+    , m_latestGeneration(0)
+    , m_runningGeneration(0)
+{
+}
+
+AsyncSearchExecutor::~AsyncSearchExecutor() {
+    Stop();
+}
+
+bool AsyncSearchExecutor::Start(const std::string& dbPath) {
+    Stop();
+
+    if (!m_db.OpenReadOnly(dbPath)) {
+        m_lastError = m_db.GetLastError();
+        return false;
+    }
+    m_db.SetProgressHandler(kProgressInstructions, ProgressHandler, this);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+        m_hasPending = false;
+    }
+    m_thread = std::thread(&AsyncSearchExecutor::WorkerLoop, this);
+    return true;
+}
+
+void AsyncSearchExecutor::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_hasPending = false;
+        m_pendingTask = nullptr;
+    }
+    // 使正在执行的查询过期，让进度回调尽快中止它
+    m_latestGeneration++;
+    m_wakeup.notify_all();
+    m_thread.join();
+
+    m_db.SetProgressHandler(0, nullptr, nullptr);
+    m_db.Close();
+}
+
+uint64_t AsyncSearchExecutor::Submit(const AssetFilter& filter) {
+    return SubmitTask([filter](Database& db) {
+        return db.SearchAssets(filter.searchText, filter.categoryId, filter.status);
+    });
+}
+
+uint64_t AsyncSearchExecutor::SubmitTask(Task task) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 递增代号后，正在执行的旧请求会在下一次进度回调时中止
+        generation = ++m_latestGeneration;
+        m_pendingTask = std::move(task);
+        m_pendingGeneration = generation;
+        m_hasPending = true;
+    }
+    m_wakeup.notify_one();
+    return generation;
+}
+
+void AsyncSearchExecutor::Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_latestGeneration++;
+    m_hasPending = false;
+    m_pendingTask = nullptr;
+}
+
+void AsyncSearchExecutor::WorkerLoop() {
+    for (;;) {
+        Task task;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this] { return m_stopping || m_hasPending; });
+            if (m_stopping) {
+                return;
+            }
+            task = std::move(m_pendingTask);
+            generation = m_pendingGeneration;
+            m_hasPending = false;
+            m_runningGeneration = generation;
+        }
+
+        // 开始前已被取代则跳过
+        if (!IsCurrent(generation)) {
+            continue;
+        }
+
+        AsyncSearchResult result;
+        result.generation = generation;
+        result.assets = task(m_db);
+
+        // 被中止的查询只返回部分结果，按代号丢弃
+        if (IsCurrent(generation) && m_onResult) {
+            m_onResult(std::move(result));
+        }
+    }
+}
+
+int AsyncSearchExecutor::ProgressHandler(void* context) {
+    AsyncSearchExecutor* self = static_cast<AsyncSearchExecutor*>(context);
+    return self->m_runningGeneration.load() != self->m_latestGeneration.load() ? 1 : 0;
+}
@@ -4,20 +4,24 @@
  */
 
 #include "CSVHelper.h"
+#include "CsvExporter.h"
+#include "CsvImporter.h"
+#include "CsvImportReport.h"
 #include <commdlg.h>
-#include <fstream>
-#include <sstream>
-#include <iomanip>
-#include <algorithm>
-#include <unordered_map>
+#include <cstdio>
+#include <functional>
+#include <thread>
 
-bool CSVHelper::ShowSaveDialog(HWND hWnd, std::wstring& filePath) {
+bool CSVHelper::ShowSaveDialog(HWND hWnd, std::wstring& filePath, CsvExportEncoding* encoding) {
     OPENFILENAMEW ofn = {0};
     wchar_t szFile[MAX_PATH] = {0};
 
     ofn.lStructSize = sizeof(OPENFILENAMEW);
     ofn.hwndOwner = hWnd;
-    ofn.lpstrFilter = L"CSV Files\0*.csv\0All Files\0*.*\0";
+    // 第 2 项为 GBK 编码的 CSV（旧版 Excel 等只认本地代码页的程序）
+    ofn.lpstrFilter = encoding
+        ? L"CSV Files (UTF-8)\0*.csv\0CSV Files (GBK)\0*.csv\0All Files\0*.*\0"
+        : L"CSV Files\0*.csv\0All Files\0*.*\0";
     ofn.lpstrFile = szFile;
     ofn.nMaxFile = MAX_PATH;
     ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT;
@@ -30,6 +34,9 @@ bool CSVHelper::ShowSaveDialog(HWND hWnd, std::wstring& filePath) {
 
     if (GetSaveFileNameW(&ofn)) {
         filePath = szFile;
+        if (encoding) {
+            *encoding = ofn.nFilterIndex == 2 ? CsvExportEncoding::Gbk : CsvExportEncoding::Utf8Bom;
+        }
         return true;
     }
     return false;
@@ -53,364 +60,209 @@ bool CSVHelper::ShowOpenDialog(HWND hWnd, std::wstring& filePath) {
     return false;
 }
 
-std::string CSVHelper::EscapeCSVField(const std::string& field) {
-    // 如果包含逗号、引号或换行，需要用引号包裹并转义
-    bool needQuote = (field.find(',') != std::string::npos) ||
-                     (field.find('"') != std::string::npos) ||
-                     (field.find('\n') != std::string::npos) ||
-                     (field.find('\r') != std::string::npos);
-
-    if (!needQuote) {
-        return field;
-    }
-
-    // 预分配内存：原字符串长度 + 2个引号 + 可能的转义字符
-    std::string result;
-    result.reserve(field.size() + 2 + std::count(field.begin(), field.end(), '"'));
-    result.push_back('"');
-    for (char c : field) {
-        if (c == '"') {
-            result.append("\"\"", 2);  // 转义引号
-        } else {
-            result.push_back(c);
-        }
-    }
-    result.push_back('"');
-    return result;
-}
-
-std::vector<std::string> CSVHelper::ParseCSVLine(const std::string& line) {
-    std::vector<std::string> result;
-    std::string field;
-    field.reserve(64);  // 预分配合理大小
-    bool inQuotes = false;
-
-    for (size_t i = 0; i < line.length(); i++) {
-        char c = line[i];
-
-        if (c == '"') {
-            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
-                // 转义的引号
-                field.push_back('"');
-                i++;
-            } else {
-                inQuotes = !inQuotes;
-            }
-        } else if (c == ',' && !inQuotes) {
-            result.push_back(std::move(field));
-            field.clear();
-            field.reserve(64);
-        } else {
-            field.push_back(c);
-        }
-    }
-    result.push_back(std::move(field));
-
-    return result;
-}
-
 bool CSVHelper::ExportToCSV(HWND hWnd, Database& db) {
     std::wstring filePath;
-    if (!ShowSaveDialog(hWnd, filePath)) {
+    CsvExportEncoding encoding = CsvExportEncoding::Utf8Bom;
+    if (!ShowSaveDialog(hWnd, filePath, &encoding)) {
         return false;
     }
 
-    // 使用宽字符路径打开文件
-    std::ofstream file(filePath.c_str(), std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        MessageBoxW(hWnd, L"无法创建文件", L"错误", MB_OK | MB_ICONERROR);
+    // 逐行写入大缓冲，缓冲满时一次写出
+    CsvExporter exporter(db, encoding);
+    long long rows = 0;
+    if (!exporter.Export(filePath, AssetFilter(), rows)) {
+        const std::string& err = exporter.GetLastError();
+        std::wstring msg = L"导出失败: ";
+        int len = MultiByteToWideChar(65001, 0, err.c_str(), (int)err.size(), nullptr, 0);
+        if (len > 0) {
+            std::wstring werr(len, L'\0');
+            MultiByteToWideChar(65001, 0, err.c_str(), (int)err.size(), &werr[0], len);
+            msg += werr;
+        }
+        MessageBoxW(hWnd, msg.c_str(), L"错误", MB_OK | MB_ICONERROR);
         return false;
     }
-
-    // 写入 UTF-8 BOM
-    const unsigned char bom[] = {0xEF, 0xBB, 0xBF};
-    file.write((const char*)bom, 3);
-
-    // 写入表头
-    file << "资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
-
-    // 获取所有资产
-    std::vector<Asset> assets = db.GetAllAssets();
-
-    for (const auto& asset : assets) {
-        file << EscapeCSVField(asset.assetCode) << ","
-             << EscapeCSVField(asset.name) << ","
-             << EscapeCSVField(asset.categoryName) << ","
-             << EscapeCSVField(asset.userName) << ","
-             << EscapeCSVField(asset.departmentName) << ","
-             << EscapeCSVField(asset.purchaseDate) << ","
-             << EscapeCSVField(std::to_string(asset.price)) << ","
-             << EscapeCSVField(asset.location) << ","
-             << EscapeCSVField(asset.status) << ","
-             << EscapeCSVField(asset.remark) << "\n";
-    }
-
-    file.close();
+    int exportCount = (int)rows;
 
     wchar_t msg[512];
-    swprintf_s(msg, L"已导出 %d 条记录到:\n%s", (int)assets.size(), filePath.c_str());
+    swprintf_s(msg, L"已导出 %d 条记录到:\n%s", exportCount, filePath.c_str());
+    if (exporter.GetReplacedChars() > 0) {
+        wchar_t note[128];
+        swprintf_s(note, L"\n\n%lld 个字符 GBK 无法表示，已写为 ?", exporter.GetReplacedChars());
+        wcscat_s(msg, note);
+    }
     MessageBoxW(hWnd, msg, L"成功", MB_OK | MB_ICONINFORMATION);
 
     return true;
 }
 
-bool CSVHelper::ImportFromCSV(HWND hWnd, Database& db) {
-    std::wstring filePath;
-    if (!ShowOpenDialog(hWnd, filePath)) {
-        return false;
-    }
+// 结果对话框中直接显示的逐行信息条数，其余只写入报告文件
+static const size_t kShownMessages = 10;
 
-    // 使用宽字符路径打开文件
-    std::ifstream file(filePath.c_str(), std::ios::in | std::ios::binary);
-    if (!file.is_open()) {
-        MessageBoxW(hWnd, L"无法打开文件", L"错误", MB_OK | MB_ICONERROR);
-        return false;
+static std::wstring Utf8ToWide(const std::string& text) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), nullptr, 0);
+    std::wstring wide(len > 0 ? len : 0, L'\0');
+    if (len > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), &wide[0], len);
     }
+    return wide;
+}
 
-    // 跳过 UTF-8 BOM
-    unsigned char bom[3] = {0};
-    file.read((char*)bom, 3);
-    bool isUtf8 = (bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF);
-    if (!isUtf8) {
-        file.seekg(0);
+/**
+ * @brief 在后台线程执行 work，完成前禁用主窗口、只处理重绘
+ *
+ * 导入和检查在后台线程使用写连接，主窗口禁用期间不会有其他代码访问数据库；
+ * 定时器、搜索结果等投递消息留在队列中，完成后照常处理。
+ */
+static void RunInBackground(HWND hWnd, const std::function<void()>& work) {
+    HANDLE done = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!done) {
+        work();
+        return;
     }
 
-    // 开始事务
-    db.BeginTransaction();
-
-    int successCount = 0;
-    int skipCount = 0;
-    std::vector<std::string> errors;
+    EnableWindow(hWnd, FALSE);
+    std::thread worker([&work, done] {
+        work();
+        SetEvent(done);
+    });
+
+    while (MsgWaitForMultipleObjects(1, &done, FALSE, INFINITE, QS_PAINT | QS_SENDMESSAGE) ==
+           WAIT_OBJECT_0 + 1) {
+        MSG msg;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE | PM_QS_PAINT)) {
+            DispatchMessageW(&msg);
+        }
+    }
 
-    // 缓存数据并建立哈希表索引
-    std::vector<Category> categories = db.GetAllCategories();
-    std::vector<Department> departments = db.GetAllDepartments();
-    std::vector<Employee> employees = db.GetAllEmployees();
+    worker.join();
+    CloseHandle(done);
+    EnableWindow(hWnd, TRUE);
+    SetForegroundWindow(hWnd);
+}
 
-    // 建立名称到ID的哈希表，将查找复杂度从 O(n) 降低到 O(1)
-    std::unordered_map<std::string, int> categoryMap;
-    for (const auto& cat : categories) {
-        categoryMap[cat.name] = cat.id;
+/**
+ * @brief 逐行信息的接收者：保留前几条用于显示，全部写入报告文件
+ *
+ * 报告在第一条信息到达时才创建并覆盖上一次的报告；没有信息时
+ * 不动已有文件。导入 a.csv 的报告为同目录下的 a.csv.errors.csv。
+ */
+class ImportMessages {
+public:
+    explicit ImportMessages(const std::wstring& csvPath)
+        : m_reportPath(csvPath + L".errors.csv")
+        , m_reportTried(false)
+    {
     }
 
-    std::unordered_map<std::string, int> departmentMap;
-    for (const auto& dept : departments) {
-        departmentMap[dept.name] = dept.id;
+    void Attach(CsvImportOptions& options) {
+        options.onMessage = [this](const CsvImportMessage& message) { Add(message); };
     }
 
-    // 员工查找需要考虑部门，使用 "员工名_部门ID" 作为键
-    std::unordered_map<std::string, int> employeeMap;
-    for (const auto& emp : employees) {
-        std::string key = emp.name + "_" + std::to_string(emp.departmentId);
-        employeeMap[key] = emp.id;
+    /**
+     * @brief 结果对话框中的信息部分：前几条信息，其余条数与报告路径
+     */
+    std::wstring Format(long long total) {
+        bool reportOk = m_report.IsOpen() && m_report.Close();
+        std::wstring text;
+        if (!m_shown.empty()) {
+            text += L"\n\n详细信息：\n";
+            for (const auto& message : m_shown) {
+                text += L"\n" + Utf8ToWide(message);
+            }
+        }
+        if (total > (long long)m_shown.size()) {
+            text += L"\n\n还有 " + std::to_wstring(total - (long long)m_shown.size()) + L" 条信息";
+        }
+        if (reportOk) {
+            text += L"\n\n全部信息已写入：\n" + m_reportPath;
+        }
+        return text;
     }
 
-    std::string line;
-    bool isFirstLine = true;
-    int lineNumber = 0;
-
-    while (std::getline(file, line)) {
-        lineNumber++;
+private:
+    std::wstring m_reportPath;
+    CsvImportReport m_report;
+    bool m_reportTried;
+    std::vector<std::string> m_shown;
 
-        // 跳过空行
-        if (line.empty()) {
-            continue;
-        }
-
-        // 如果不是UTF-8文件,需要从GBK转换为UTF-8
-        if (!isUtf8 && !line.empty()) {
-            // GBK -> UTF-16
-            int wlen = MultiByteToWideChar(936, 0, line.c_str(), -1, nullptr, 0);
-            if (wlen > 0) {
-                std::wstring wstr(wlen, 0);
-                MultiByteToWideChar(936, 0, line.c_str(), -1, &wstr[0], wlen);
-
-                // UTF-16 -> UTF-8
-                int utf8len = WideCharToMultiByte(65001, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
-                if (utf8len > 0) {
-                    std::string utf8str(utf8len, 0);
-                    WideCharToMultiByte(65001, 0, wstr.c_str(), -1, &utf8str[0], utf8len, nullptr, nullptr);
-                    // 移除字符串末尾的null字符
-                    if (!utf8str.empty() && utf8str.back() == '\0') {
-                        utf8str.pop_back();
-                    }
-                    line = utf8str;
-                }
-            }
+    void Add(const CsvImportMessage& message) {
+        if (m_shown.size() < kShownMessages) {
+            m_shown.push_back(message.ToString());
         }
-
-        // 跳过表头
-        if (isFirstLine) {
-            isFirstLine = false;
-            if (line.find("资产编号") != std::string::npos) {
-                continue;
-            }
+        if (!m_reportTried) {
+            m_reportTried = true;
+            m_report.Open(m_reportPath);
         }
-
-        // 解析行
-        std::vector<std::string> fields = ParseCSVLine(line);
-        if (fields.size() < 2) {
-            continue;
+        if (m_report.IsOpen()) {
+            m_report.Add(message);
         }
+    }
+};
 
-        try {
-            std::string assetCode = fields[0];
-            std::string assetName = fields[1];
-
-            // 验证必填项
-            if (assetCode.empty() || assetName.empty()) {
-                continue;
-            }
+bool CSVHelper::ImportFromCSV(HWND hWnd, Database& db) {
+    std::wstring filePath;
+    if (!ShowOpenDialog(hWnd, filePath)) {
+        return false;
+    }
 
-            // 去除首尾空格
-            auto trim = [](const std::string& s) -> std::string {
-                size_t start = s.find_first_not_of(" \t\r\n");
-                if (start == std::string::npos) return std::string();
-                size_t end = s.find_last_not_of(" \t\r\n");
-                return s.substr(start, end - start + 1);
-            };
-
-            assetCode = trim(assetCode);
-            assetName = trim(assetName);
-
-            // 检查是否已存在
-            Asset existing;
-            if (db.GetAssetByCode(assetCode, existing)) {
-                skipCount++;
-                std::string msg = "资产编号 " + assetCode + " 已存在，跳过";
-                errors.push_back(msg);
-                continue;
-            }
+    // 读取、解析与写入分线程流水执行，结果与串行导入一致；逐行信息流式写入报告。
+    // 写入级也在后台线程，界面在导入期间保持重绘
+    ImportMessages messages(filePath);
+    CsvImportOptions options;
+    messages.Attach(options);
+    CsvImporter importer(db, options);
+    CsvImportResult result;
+    bool imported = false;
+    RunInBackground(hWnd, [&] { imported = importer.Import(filePath, result); });
+    if (!imported && result.rows == 0 && result.messageCount == 0) {
+        MessageBoxW(hWnd, L"无法打开文件", L"错误", MB_OK | MB_ICONERROR);
+        return false;
+    }
 
-            // 处理分类
-            int categoryId = -1;
-            if (fields.size() > 2 && !fields[2].empty()) {
-                std::string catName = trim(fields[2]);
-
-                // 使用哈希表查找分类
-                auto it = categoryMap.find(catName);
-                if (it != categoryMap.end()) {
-                    categoryId = it->second;
-                } else {
-                    // 不存在则创建
-                    Category newCat{0, catName};
-                    if (db.AddCategory(newCat)) {
-                        categoryId = newCat.id;
-                        categories.push_back(newCat);
-                        categoryMap[catName] = newCat.id;
-                    }
-                }
-            }
+    // 显示结果
+    wchar_t summary[256];
+    swprintf_s(summary, L"导入完成！\n\n成功导入：%d 条\n跳过：%d 条\n字段有误：%d 条",
+               result.successCount, result.skipCount, result.invalidCount);
+    std::wstring resultMsg = summary + messages.Format(result.messageCount);
 
-            // 处理部门和员工
-            int userId = -1;
-            if (fields.size() > 3 && !fields[3].empty()) {
-                std::string userName = trim(fields[3]);
-                std::string deptName;
-                if (fields.size() > 4) {
-                    deptName = trim(fields[4]);
-                }
-
-                // 使用哈希表查找或创建部门
-                int deptId = -1;
-                if (!deptName.empty()) {
-                    auto it = departmentMap.find(deptName);
-                    if (it != departmentMap.end()) {
-                        deptId = it->second;
-                    } else {
-                        Department newDept{0, deptName};
-                        if (db.AddDepartment(newDept)) {
-                            deptId = newDept.id;
-                            departments.push_back(newDept);
-                            departmentMap[deptName] = newDept.id;
-                        }
-                    }
-                }
-
-                // 使用哈希表查找员工
-                std::string empKey = userName + "_" + std::to_string(deptId);
-                auto it = employeeMap.find(empKey);
-                if (it != employeeMap.end()) {
-                    userId = it->second;
-                } else {
-                    // 不存在则创建
-                    Employee newEmp{0, userName, deptId};
-                    if (db.AddEmployee(newEmp)) {
-                        userId = newEmp.id;
-                        employees.push_back(newEmp);
-                        employeeMap[empKey] = newEmp.id;
-                    }
-                }
-            }
+    MessageBoxW(hWnd, resultMsg.c_str(), L"导入结果", MB_OK | MB_ICONINFORMATION);
 
-            // 其他字段
-            std::string purchaseDate = (fields.size() > 5) ? trim(fields[5]) : "";
-            double price = 0.0;
-            if (fields.size() > 6 && !fields[6].empty()) {
-                price = atof(trim(fields[6]).c_str());
-            }
-            std::string location = (fields.size() > 7) ? trim(fields[7]) : "";
-            std::string status = (fields.size() > 8 && !trim(fields[8]).empty())
-                                ? trim(fields[8]) : "在用";
-            std::string remark = (fields.size() > 9) ? trim(fields[9]) : "";
-
-            // 创建资产
-            Asset asset{0};
-            asset.assetCode = assetCode;
-            asset.name = assetName;
-            asset.categoryId = categoryId;
-            asset.userId = userId;
-            asset.purchaseDate = purchaseDate;
-            asset.price = price;
-            asset.location = location;
-            asset.status = status;
-            asset.remark = remark;
-
-            if (db.AddAsset(asset)) {
-                successCount++;
-            } else {
-                std::string errMsg = "添加资产 " + assetCode + " 失败";
-                std::string dbErr = db.GetLastError();
-                if (!dbErr.empty()) {
-                    errMsg += " (数据库错误: " + dbErr + ")";
-                }
-                errors.push_back(errMsg);
-            }
+    return true;
+}
 
-        } catch (const std::exception& e) {
-            std::string errMsg = std::string("解析行失败: ") + e.what();
-            errors.push_back(errMsg);
-        }
+bool CSVHelper::ValidateCSV(HWND hWnd, Database& db) {
+    std::wstring filePath;
+    if (!ShowOpenDialog(hWnd, filePath)) {
+        return false;
     }
 
-    file.close();
-
-    // 提交事务
-    db.Commit();
-
-    // 显示结果
-    wchar_t resultMsg[1024];
-    swprintf_s(resultMsg, L"导入完成！\n\n成功导入：%d 条\n跳过：%d 条",
-               successCount, skipCount);
-
-    if (!errors.empty() && errors.size() <= 10) {
-        wcscat_s(resultMsg, L"\n\n详细信息：\n");
-        for (const auto& err : errors) {
-            std::wstring werr;
-            int len = MultiByteToWideChar(65001, 0, err.c_str(), -1, nullptr, 0);
-            werr.resize(len);
-            MultiByteToWideChar(65001, 0, err.c_str(), -1, &werr[0], len);
-            wcscat_s(resultMsg, L"\n");
-            wcscat_s(resultMsg, werr.c_str());
-        }
-    } else if (errors.size() > 10) {
-        swprintf_s(resultMsg + wcslen(resultMsg), 200,
-                   L"\n\n还有 %d 条信息", (int)(errors.size() - 10));
+    // 与导入相同的解析流水线，只检查不写入
+    ImportMessages messages(filePath);
+    CsvImportOptions options;
+    messages.Attach(options);
+    CsvImporter importer(db, options);
+    CsvValidateResult result;
+    bool validated = false;
+    RunInBackground(hWnd, [&] { validated = importer.Validate(filePath, result); });
+    if (!validated && result.messageCount == 0) {
+        MessageBoxW(hWnd, L"无法打开文件", L"错误", MB_OK | MB_ICONERROR);
+        return false;
     }
 
-    MessageBoxW(hWnd, resultMsg, L"导入结果", MB_OK | MB_ICONINFORMATION);
+    wchar_t summary[512];
+    swprintf_s(summary,
+               L"检查完成（未写入数据库）\n\n共 %lld 行，可直接导入 %lld 行\n"
+               L"字段不规范（导入时照常写入）：%lld 行\n"
+               L"字段有误：%lld 行\n编号在文件内重复：%lld 行\n编号已存在：%lld 行",
+               result.rows, result.validRows, result.nonStandardRows, result.invalidRows,
+               result.duplicateRows, result.existingRows);
+    std::wstring resultMsg = summary + messages.Format(result.messageCount);
 
-    return true;
+    UINT icon = result.validRows == result.rows ? MB_ICONINFORMATION : MB_ICONWARNING;
+    MessageBoxW(hWnd, resultMsg.c_str(), L"检查结果", MB_OK | icon);
+
+    return result.validRows == result.rows;
 }
 
 bool CSVHelper::DownloadTemplate(HWND hWnd) {
@@ -419,34 +271,12 @@ bool CSVHelper::DownloadTemplate(HWND hWnd) {
         return false;
     }
 
-    // 使用宽字符路径打开文件
-    std::ofstream file(filePath.c_str(), std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
+    std::string error;
+    if (!CsvExporter::ExportTemplate(filePath, error)) {
         MessageBoxW(hWnd, L"无法创建文件", L"错误", MB_OK | MB_ICONERROR);
         return false;
     }
 
-    // 写入 UTF-8 BOM
-    file.write("\xEF\xBB\xBF", 3);
-
-    // 写入表头
-    file << "资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
-
-    // 写入示例数据和说明
-    file << "ZC001,联想笔记本电脑,电脑设备,张三,技术部,2024-01-15,6999,3楼研发部,在用,\n";
-    file << "ZC002,办公桌,办公家具,李四,行政部,2024-01-20,1200,2楼办公室,在用,\n";
-    file << "ZC003,打印机,电子设备,,,2024-02-01,3500,1楼前台,闲置,待分配\n";
-    file << "\n";
-    file << "# 填写说明：\n";
-    file << "# 1. 资产编号和资产名称为必填项\n";
-    file << "# 2. 分类、部门、使用人如果不存在会自动创建\n";
-    file << "# 3. 状态可选：在用、闲置、维修中、已报废\n";
-    file << "# 4. 日期格式：YYYY-MM-DD\n";
-    file << "# 5. 金额为数字，不要包含货币符号\n";
-    file << "# 6. 以 # 开头的行为注释，导入时会被忽略\n";
-
-    file.close();
-
     MessageBoxW(hWnd, L"模板文件已生成！", L"成功", MB_OK | MB_ICONINFORMATION);
     return true;
 }
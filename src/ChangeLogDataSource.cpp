@@ -0,0 +1,49 @@
+/**
+ * @file ChangeLogDataSource.cpp
+ * @brief 变更日志分页数据源实现
+ */
+
+#include "ChangeLogDataSource.h"
+#include <iterator>
+
+ChangeLogDataSource::ChangeLogDataSource(Database& db, int pageSize)
+    : m_db(db)
+    , m_pageSize(pageSize > 0 ? pageSize : 200)
+    , m_hasMore(true)
+{
+}
+
+void ChangeLogDataSource::SetFilter(const ChangeLogFilter& filter) {
+    m_filter = filter;
+    Reset();
+}
+
+void ChangeLogDataSource::Reset() {
+    m_position = ChangeLogPageKey();
+    m_rows.clear();
+    m_hasMore = true;
+}
+
+size_t ChangeLogDataSource::EnsureLoaded(size_t count) {
+    while (m_rows.size() < count && m_hasMore) {
+        LoadNextPage();
+    }
+    return m_rows.size();
+}
+
+size_t ChangeLogDataSource::LoadNextPage() {
+    if (!m_hasMore) {
+        return 0;
+    }
+
+    std::vector<AssetChangeLog> page = m_db.GetChangeLogsBefore(m_position, m_pageSize, m_filter, &m_position);
+
+    // 不足一页说明已到末尾，省去一次空查询
+    if ((int)page.size() < m_pageSize) {
+        m_hasMore = false;
+    }
+
+    size_t loaded = page.size();
+    m_rows.insert(m_rows.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+    return loaded;
+}
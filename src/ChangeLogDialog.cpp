@@ -6,6 +6,34 @@
 #include "ChangeLogDialog.h"
 #include "resource_ids.h"
 #include <windowsx.h>
+#include <algorithm>
+#include <ctime>
+
+// 滚动到已加载末尾时投递，加载下一页
+static const UINT WM_CHANGELOG_LOAD_MORE = WM_APP + 1;
+
+// UTF-8 转宽字符
+static std::wstring Utf8ToWide(const std::string& text) {
+    if (text.empty()) {
+        return std::wstring();
+    }
+    int len = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), nullptr, 0);
+    std::wstring result(len, 0);
+    MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), &result[0], len);
+    return result;
+}
+
+// Unix 时间戳格式化为本地时间 "YYYY-MM-DD HH:MM:SS"（只在显示时转换）
+static std::wstring FormatChangeTime(long long changeTime) {
+    std::time_t t = (std::time_t)changeTime;
+    std::tm local = {};
+    if (localtime_s(&local, &t) != 0) {
+        return std::wstring();
+    }
+    wchar_t buf[32];
+    wcsftime(buf, 32, L"%Y-%m-%d %H:%M:%S", &local);
+    return buf;
+}
 
 // 列表视图列索引
 enum {
@@ -22,7 +50,9 @@ ChangeLogDialog::ChangeLogDialog(Database& db)
     , m_hDlg(nullptr)
     , m_hList(nullptr)
     , m_hSearchEdit(nullptr)
+    , m_source(db)
     , m_filterAssetId(-1)
+    , m_loadPending(false)
 {
 }
 
@@ -93,6 +123,27 @@ INT_PTR ChangeLogDialog::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
             }
             break;
 
+        case WM_NOTIFY: {
+            LPNMHDR pnmhdr = (LPNMHDR)lParam;
+            if (pnmhdr->hwndFrom != m_hList) {
+                break;
+            }
+            if (pnmhdr->code == LVN_GETDISPINFOW) {
+                OnGetDispInfo((NMLVDISPINFOW*)lParam);
+                return TRUE;
+            }
+            if (pnmhdr->code == LVN_ODCACHEHINT) {
+                RequestMore(((NMLVCACHEHINT*)lParam)->iTo);
+                return TRUE;
+            }
+            break;
+        }
+
+        case WM_CHANGELOG_LOAD_MORE:
+            m_loadPending = false;
+            LoadMore();
+            return TRUE;
+
         case WM_SIZE: {
             int width = LOWORD(lParam);
             int height = HIWORD(lParam);
@@ -167,75 +218,83 @@ void ChangeLogDialog::InitDialog() {
 }
 
 void ChangeLogDialog::LoadChangeLogs() {
-    if (m_filterAssetId >= 0) {
-        m_logs = m_db.GetChangeLogsByAssetId(m_filterAssetId);
-    } else {
-        m_logs = m_db.GetAllChangeLogs();
-    }
+    ChangeLogFilter filter;
+    filter.assetId = m_filterAssetId;
+    m_source.SetFilter(filter);
+    m_source.LoadNextPage();
     RefreshListView();
 }
 
 void ChangeLogDialog::RefreshListView() {
-    ListView_DeleteAllItems(m_hList);
-
-    LVITEMW lvi = {0};
-    lvi.mask = LVIF_TEXT;
-
-    for (size_t i = 0; i < m_logs.size(); i++) {
-        const auto& log = m_logs[i];
-
-        // 变更时间
-        lvi.iItem = (int)i;
-        lvi.iSubItem = COL_TIME;
-        std::wstring wTime(log.changeTime.begin(), log.changeTime.end());
-        lvi.pszText = (LPWSTR)wTime.c_str();
-        ListView_InsertItem(m_hList, &lvi);
-
-        // 资产编号
-        std::wstring wCode(log.assetCode.begin(), log.assetCode.end());
-        ListView_SetItemText(m_hList, (int)i, COL_ASSET_CODE, (LPWSTR)wCode.c_str());
-
-        // 资产名称
-        int len = MultiByteToWideChar(CP_UTF8, 0, log.assetName.c_str(), -1, nullptr, 0);
-        std::wstring wName(len, 0);
-        MultiByteToWideChar(CP_UTF8, 0, log.assetName.c_str(), -1, &wName[0], len);
-        ListView_SetItemText(m_hList, (int)i, COL_ASSET_NAME, (LPWSTR)wName.c_str());
-
-        // 变更字段
-        len = MultiByteToWideChar(CP_UTF8, 0, log.fieldName.c_str(), -1, nullptr, 0);
-        std::wstring wField(len, 0);
-        MultiByteToWideChar(CP_UTF8, 0, log.fieldName.c_str(), -1, &wField[0], len);
-        ListView_SetItemText(m_hList, (int)i, COL_FIELD, (LPWSTR)wField.c_str());
-
-        // 原值
-        len = MultiByteToWideChar(CP_UTF8, 0, log.oldValue.c_str(), -1, nullptr, 0);
-        std::wstring wOldVal(len, 0);
-        MultiByteToWideChar(CP_UTF8, 0, log.oldValue.c_str(), -1, &wOldVal[0], len);
-        if (wOldVal.empty() || (wOldVal.size() == 1 && wOldVal[0] == 0)) {
-            wOldVal = L"(空)";
-        }
-        ListView_SetItemText(m_hList, (int)i, COL_OLD_VALUE, (LPWSTR)wOldVal.c_str());
-
-        // 新值
-        len = MultiByteToWideChar(CP_UTF8, 0, log.newValue.c_str(), -1, nullptr, 0);
-        std::wstring wNewVal(len, 0);
-        MultiByteToWideChar(CP_UTF8, 0, log.newValue.c_str(), -1, &wNewVal[0], len);
-        if (wNewVal.empty() || (wNewVal.size() == 1 && wNewVal[0] == 0)) {
-            wNewVal = L"(空)";
-        }
-        ListView_SetItemText(m_hList, (int)i, COL_NEW_VALUE, (LPWSTR)wNewVal.c_str());
-    }
+    m_loadPending = false;
+    ListView_SetItemCountEx(m_hList, (int)m_source.GetLoadedCount(), 0);
+    InvalidateRect(m_hList, nullptr, TRUE);
+    UpdateTitle();
+}
 
-    // 更新状态栏或标题显示记录数
+void ChangeLogDialog::UpdateTitle() {
+    // 更新标题显示记录数：只用已加载的行数，不对日志表整表计数（每加载一页都会调用）
     wchar_t title[256];
-    if (m_filterAssetId >= 0) {
-        swprintf_s(title, L"资产变更日志 - 共 %zu 条记录", m_logs.size());
+    const wchar_t* caption = (m_filterAssetId >= 0) ? L"资产变更日志" : L"所有变更日志";
+    if (m_source.HasMore()) {
+        swprintf_s(title, L"%s - 已加载 %zu 条记录（滚动加载更多）", caption, m_source.GetLoadedCount());
     } else {
-        swprintf_s(title, L"所有变更日志 - 共 %zu 条记录", m_logs.size());
+        swprintf_s(title, L"%s - 共 %zu 条记录", caption, m_source.GetLoadedCount());
     }
     SetWindowTextW(m_hDlg, title);
 }
 
+void ChangeLogDialog::LoadMore() {
+    if (m_source.LoadNextPage() == 0) {
+        return;
+    }
+    // 只追加项数，保留滚动位置和选中状态
+    ListView_SetItemCountEx(m_hList, (int)m_source.GetLoadedCount(),
+                            LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+    UpdateTitle();
+}
+
+void ChangeLogDialog::RequestMore(int lastVisible) {
+    // 距离已加载末尾不足半页时预取下一页，滚动到底之前数据已就绪
+    size_t threshold = m_source.GetLoadedCount() - std::min(m_source.GetLoadedCount(),
+                                                            (size_t)m_source.GetPageSize() / 2);
+    if (!m_loadPending && m_source.HasMore() && lastVisible >= 0 && (size_t)lastVisible >= threshold) {
+        m_loadPending = true;
+        PostMessageW(m_hDlg, WM_CHANGELOG_LOAD_MORE, 0, 0);
+    }
+}
+
+void ChangeLogDialog::OnGetDispInfo(NMLVDISPINFOW* info) {
+    LVITEMW& item = info->item;
+    if (!(item.mask & LVIF_TEXT) || item.pszText == nullptr || item.cchTextMax <= 0) {
+        return;
+    }
+
+    const AssetChangeLog* log = m_source.GetRow((size_t)item.iItem);
+    if (!log) {
+        item.pszText[0] = L'\0';
+        return;
+    }
+    RequestMore(item.iItem);
+
+    std::wstring text;
+    switch (item.iSubItem) {
+        case COL_TIME:       text = FormatChangeTime(log->changeTime); break;
+        case COL_ASSET_CODE: text = Utf8ToWide(log->assetCode); break;
+        case COL_ASSET_NAME: text = Utf8ToWide(log->assetName); break;
+        case COL_FIELD:      text = Utf8ToWide(log->fieldName); break;
+        case COL_OLD_VALUE:
+            text = Utf8ToWide(log->oldValue);
+            if (text.empty()) text = L"(空)";
+            break;
+        case COL_NEW_VALUE:
+            text = Utf8ToWide(log->newValue);
+            if (text.empty()) text = L"(空)";
+            break;
+    }
+    lstrcpynW(item.pszText, text.c_str(), item.cchTextMax);
+}
+
 void ChangeLogDialog::OnSearch() {
     wchar_t wbuf[256] = {0};
     GetWindowTextW(m_hSearchEdit, wbuf, 256);
@@ -248,7 +307,11 @@ void ChangeLogDialog::OnSearch() {
     if (searchText.empty()) {
         LoadChangeLogs();
     } else {
-        m_logs = m_db.SearchChangeLogs(searchText);
+        ChangeLogFilter filter;
+        filter.searchText = searchText;
+        filter.assetId = m_filterAssetId;
+        m_source.SetFilter(filter);
+        m_source.LoadNextPage();
         RefreshListView();
     }
 }
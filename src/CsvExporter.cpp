@@ -0,0 +1,143 @@
+/**
+ * @file CsvExporter.cpp
+ * @brief CSV 资产导出实现
+ */
+
+#include "CsvExporter.h"
+#include "CsvWriter.h"
+#include "GbkCodec.h"
+
+// 导出文件与导入模板共用的表头
+static const char kHeader[] = "资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
+
+CsvExporter::CsvExporter(Database& db, CsvExportEncoding encoding)
+    : m_db(db)
+    , m_encoding(encoding)
+    , m_replacedChars(0)
+{
+}
+
+bool CsvExporter::Export(const std::string& path, const AssetFilter& filter, long long& rows) {
+    CsvWriter writer;
+    if (!writer.Open(path)) {
+        m_lastError = writer.GetLastError();
+        rows = 0;
+        return false;
+    }
+    return Run(writer, filter, rows);
+}
+
+#ifdef _WIN32
+bool CsvExporter::Export(const std::wstring& path, const AssetFilter& filter, long long& rows) {
+    CsvWriter writer;
+    if (!writer.Open(path)) {
+        m_lastError = writer.GetLastError();
+        rows = 0;
+        return false;
+    }
+    return Run(writer, filter, rows);
+}
+#endif
+
+bool CsvExporter::ExportTemplate(const std::string& path, std::string& error) {
+    CsvWriter writer(4096);
+    if (!writer.Open(path)) {
+        error = writer.GetLastError();
+        return false;
+    }
+    return WriteTemplate(writer, error);
+}
+
+#ifdef _WIN32
+bool CsvExporter::ExportTemplate(const std::wstring& path, std::string& error) {
+    CsvWriter writer(4096);
+    if (!writer.Open(path)) {
+        error = writer.GetLastError();
+        return false;
+    }
+    return WriteTemplate(writer, error);
+}
+#endif
+
+bool CsvExporter::WriteTemplate(CsvWriter& writer, std::string& error) {
+    // UTF-8 BOM 与表头
+    writer.WriteRaw("\xEF\xBB\xBF");
+    writer.WriteRaw(kHeader);
+
+    // 示例数据和说明
+    writer.WriteRaw("ZC001,联想笔记本电脑,电脑设备,张三,技术部,2024-01-15,6999,3楼研发部,在用,\n");
+    writer.WriteRaw("ZC002,办公桌,办公家具,李四,行政部,2024-01-20,1200,2楼办公室,在用,\n");
+    writer.WriteRaw("ZC003,打印机,电子设备,,,2024-02-01,3500,1楼前台,闲置,待分配\n");
+    writer.WriteRaw("\n");
+    writer.WriteRaw("# 填写说明：\n");
+    writer.WriteRaw("# 1. 资产名称为必填项，资产编号留空时自动编号\n");
+    writer.WriteRaw("# 2. 分类、部门、使用人如果不存在会自动创建\n");
+    writer.WriteRaw("# 3. 状态可选：在用、闲置、维修中、已报废\n");
+    writer.WriteRaw("# 4. 日期格式：YYYY-MM-DD\n");
+    writer.WriteRaw("# 5. 金额为数字，不要包含货币符号\n");
+    writer.WriteRaw("# 6. 以 # 开头的行为注释，导入时会被忽略\n");
+
+    if (!writer.Close()) {
+        error = writer.GetLastError();
+        return false;
+    }
+    return true;
+}
+
+bool CsvExporter::Run(CsvWriter& writer, const AssetFilter& filter, long long& rows) {
+    m_lastError.clear();
+    m_replacedChars = 0;
+    rows = 0;
+
+    bool gbk = m_encoding == CsvExportEncoding::Gbk;
+    if (gbk) {
+        // GBK 文件没有 BOM，导入时按内容识别
+        writer.WriteRaw(GbkCodec::FromUtf8(kHeader));
+    } else {
+        // UTF-8 BOM 与表头
+        writer.WriteRaw("\xEF\xBB\xBF");
+        writer.WriteRaw(kHeader);
+    }
+
+    // GBK 字节中的逗号、引号、换行只会是 ASCII 本身（尾字节不小于 0x40），
+    // 转码后的字段照常判断是否加引号。纯 ASCII 字段不转码
+    std::string converted;
+    auto writeText = [&](std::string_view field) {
+        if (!gbk || GbkCodec::IsAscii(field)) {
+            writer.WriteField(field);
+            return;
+        }
+        converted.clear();
+        m_replacedChars += (long long)GbkCodec::FromUtf8(field, converted);
+        writer.WriteField(converted);
+    };
+
+    // 流式遍历资产逐行写出，不在内存中保留整个结果集
+    bool ok = m_db.ForEachAsset(filter, [&](const AssetRowView& row) {
+        writeText(row.assetCode);
+        writeText(row.name);
+        writeText(row.categoryName);
+        writeText(row.userName);
+        writeText(row.departmentName);
+        writeText(row.purchaseDate);
+        writer.WriteField(row.price);
+        writeText(row.location);
+        writeText(row.status);
+        writeText(row.remark);
+        writer.EndRecord();
+        rows++;
+        // 写入失败（磁盘满等）后不再继续查询，由 Close 给出原因
+        return !writer.HasFailed();
+    });
+    if (!ok) {
+        m_lastError = m_db.GetLastError();
+        writer.Close();
+        return false;
+    }
+
+    if (!writer.Close()) {
+        m_lastError = writer.GetLastError();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file CsvImportReport.cpp
+ * @brief CSV 导入/检查的逐行信息报告实现
+ */
+
+#include "CsvImportReport.h"
+
+CsvImportReport::CsvImportReport()
+    : m_writer(64 * 1024)
+    , m_count(0)
+{
+}
+
+bool CsvImportReport::Open(const std::string& path) {
+    m_count = 0;
+    if (!m_writer.Open(path)) {
+        return false;
+    }
+    WriteHeader();
+    return true;
+}
+
+#ifdef _WIN32
+bool CsvImportReport::Open(const std::wstring& path) {
+    m_count = 0;
+    if (!m_writer.Open(path)) {
+        return false;
+    }
+    WriteHeader();
+    return true;
+}
+#endif
+
+void CsvImportReport::WriteHeader() {
+    m_writer.WriteRaw("\xEF\xBB\xBF");
+    m_writer.WriteRaw("行号,信息\n");
+}
+
+void CsvImportReport::Add(const CsvImportMessage& message) {
+    // 与具体行无关的信息（读取中断、提交失败）行号留空
+    if (message.line > 0) {
+        m_writer.WriteField(message.line);
+    } else {
+        m_writer.WriteField(std::string_view());
+    }
+    m_writer.WriteField(message.text);
+    m_writer.EndRecord();
+    m_count++;
+}
+
+bool CsvImportReport::Close() {
+    return m_writer.Close();
+}
@@ -0,0 +1,833 @@
+/**
+ * @file CsvImporter.cpp
+ * @brief CSV 资产导入（流水线）实现
+ */
+
+#include "CsvImporter.h"
+#include "CsvReader.h"
+#include "GbkCodec.h"
+#include "ReferenceCache.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+// 每个解析线程在各队列中最多积压的段数：足够让各级重叠，又限制已读未写的数据量
+static const size_t kQueueChunksPerWorker = 2;
+
+// 自动选择时的解析线程数上限（写入是单线程，更多解析线程没有收益）
+static const int kMaxAutoWorkers = 8;
+
+/**
+ * @brief 有界阻塞队列：满时 Push 等待，空时 Pop 等待；Close 后 Pop 取完剩余元素返回 false
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(capacity), m_closed(false) {}
+
+    bool Push(T&& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool Pop(T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<T> m_items;
+    size_t m_capacity;
+    bool m_closed;
+};
+
+/**
+ * @brief 解析线程输出的一行（名称尚未解析为 ID）
+ */
+struct ImportRow {
+    long long line = 0;
+    std::string error;              // 非空表示该行不导入（检查模式下为该行的问题）
+    std::string warning;            // 字段不规范但导入时照常写入（非严格模式）
+    Asset asset{};
+    std::string categoryName;
+    std::string userName;
+    std::string departmentName;
+};
+
+struct ChunkTask {
+    uint64_t seq = 0;
+    CsvChunk chunk;
+};
+
+struct ParsedChunk {
+    uint64_t seq = 0;
+    std::vector<ImportRow> rows;
+};
+
+std::string CsvImportMessage::ToString() const {
+    return line > 0 ? "第 " + std::to_string(line) + " 行: " + text : text;
+}
+
+/**
+ * @brief 逐行信息的去向：设置了 onMessage 时逐条回调，否则存入结果的 errors
+ */
+class MessageSink {
+public:
+    MessageSink(const std::function<void(const CsvImportMessage&)>& callback,
+                std::vector<std::string>& errors, long long& count)
+        : m_callback(callback)
+        , m_errors(errors)
+        , m_count(count)
+    {
+    }
+
+    void Add(long long line, std::string text) {
+        m_count++;
+        CsvImportMessage message;
+        message.line = line;
+        message.text = std::move(text);
+        if (m_callback) {
+            m_callback(message);
+        } else {
+            m_errors.push_back(message.ToString());
+        }
+    }
+
+private:
+    const std::function<void(const CsvImportMessage&)>& m_callback;
+    std::vector<std::string>& m_errors;
+    long long& m_count;
+};
+
+// ========== 解析 ==========
+
+/**
+ * @brief 去除首尾空白
+ */
+static std::string_view Trim(std::string_view s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) return std::string_view();
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(start, end - start + 1);
+}
+
+/**
+ * @brief 是否为 YYYY-MM-DD 格式的有效日期
+ */
+static bool IsValidDate(std::string_view text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+        return false;
+    }
+    int year = 0, month = 0, day = 0;
+    auto number = [&text](size_t pos, size_t len, int& value) {
+        const char* end = text.data() + pos + len;
+        auto parsed = std::from_chars(text.data() + pos, end, value);
+        return parsed.ec == std::errc() && parsed.ptr == end;
+    };
+    if (!number(0, 4, year) || !number(5, 2, month) || !number(8, 2, day)) {
+        return false;
+    }
+    static const int kDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1) {
+        return false;
+    }
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return day <= kDaysInMonth[month - 1] + (month == 2 && leap ? 1 : 0);
+}
+
+/**
+ * @brief 检查日期、金额、状态是否规范，问题以 "；" 连接追加到 problems
+ *
+ * 不规范的字段导入时默认照原规则写入（日期、状态原样保存，金额按 atof 取前缀），
+ * 只有 CsvImportOptions::strictFields 时整行不导入。
+ */
+static void CheckFields(std::string_view date, std::string_view price, std::string_view status,
+                        std::string& problems) {
+    auto fail = [&problems](const std::string& text) {
+        if (!problems.empty()) {
+            problems += "；";
+        }
+        problems += text;
+    };
+
+    if (!date.empty() && !IsValidDate(date)) {
+        fail("购入日期 " + std::string(date) + " 不是 YYYY-MM-DD 格式的有效日期");
+    }
+    if (!price.empty()) {
+        double value = 0;
+        const char* end = price.data() + price.size();
+        auto parsed = std::from_chars(price.data(), end, value);
+        if (parsed.ec != std::errc() || parsed.ptr != end || !std::isfinite(value)) {
+            fail("金额 " + std::string(price) + " 不是数字");
+        } else if (value < 0) {
+            fail("金额 " + std::string(price) + " 为负数");
+        }
+    }
+    if (!status.empty()) {
+        static const char* const kStatuses[] = {"在用", "闲置", "维修中", "已报废"};
+        bool known = false;
+        for (const char* candidate : kStatuses) {
+            if (status == candidate) {
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            fail("状态 " + std::string(status) + " 不是在用、闲置、维修中、已报废之一");
+        }
+    }
+}
+
+/**
+ * @brief 解析一段记录
+ * @param firstChunk 文件的第一段（首条记录可能是表头）
+ * @param validate 只检查：每条数据行都输出（只带编号与问题描述），不构造资产
+ * @param strict 日期、金额、状态不规范的行不导入
+ */
+static void ParseChunk(const CsvChunk& chunk, bool firstChunk, bool isUtf8, bool validate, bool strict,
+                       std::vector<ImportRow>& rows) {
+    // 不是 UTF-8 文件时整段从 GBK 转为 UTF-8 再解析（纯 ASCII 的段无需转换）。
+    // 分隔符、引号与换行不会是 GBK 的尾字节，转码不改变字段与记录的边界
+    CsvChunk utf8Chunk;
+    const CsvChunk* source = &chunk;
+    if (!isUtf8 && !GbkCodec::IsAscii(chunk.Data())) {
+        GbkCodec::ToUtf8(chunk.Data(), utf8Chunk.owned);
+        utf8Chunk.firstLine = chunk.firstLine;
+        source = &utf8Chunk;
+    }
+
+    CsvReader reader;
+    reader.OpenChunk(*source);
+
+    CsvRecord record;
+    bool isFirstRecord = firstChunk;
+
+    while (reader.Next(record)) {
+        const std::vector<std::string_view>& fields = record.fields;
+
+        // 跳过表头
+        if (isFirstRecord) {
+            isFirstRecord = false;
+            if (fields[0].find("资产编号") != std::string_view::npos) {
+                continue;
+            }
+        }
+
+        // 以 # 开头的行为模板中的说明
+        if (!fields[0].empty() && fields[0][0] == '#') {
+            continue;
+        }
+
+        // 越界的列视为空
+        auto field = [&fields](size_t index) -> std::string_view {
+            return index < fields.size() ? Trim(fields[index]) : std::string_view();
+        };
+
+        if (fields.size() < 2) {
+            // 空行忽略；只有一列内容的行报告
+            if (!field(0).empty()) {
+                ImportRow row;
+                row.line = record.line;
+                row.error = "只有 1 列，至少需要资产编号和资产名称两列";
+                rows.push_back(std::move(row));
+            }
+            continue;
+        }
+
+        // 导入与检查按同一组规则判断：名称为空的行不导入；日期、金额、状态不规范的行
+        // 默认照常导入（检查时单独报告），严格模式下不导入
+        ImportRow row;
+        row.line = record.line;
+        row.asset.assetCode = std::string(field(0));
+        std::string problems;
+        CheckFields(field(5), field(6), field(8), problems);
+        if (field(1).empty()) {
+            row.error = problems.empty() ? std::string("资产名称为空") : "资产名称为空；" + problems;
+        } else if (strict) {
+            row.error = std::move(problems);
+        } else {
+            row.warning = std::move(problems);
+        }
+        if (validate || !row.error.empty()) {
+            // 检查模式只需要编号与问题描述
+            rows.push_back(std::move(row));
+            continue;
+        }
+
+        try {
+            row.asset.name = std::string(field(1));
+            row.categoryName = std::string(field(2));
+            row.userName = std::string(field(3));
+            row.departmentName = std::string(field(4));
+            row.asset.purchaseDate = std::string(field(5));
+            if (!field(6).empty()) {
+                row.asset.price = atof(std::string(field(6)).c_str());
+            }
+            row.asset.location = std::string(field(7));
+            std::string_view status = field(8);
+            row.asset.status = status.empty() ? std::string("在用") : std::string(status);
+            row.asset.remark = std::string(field(9));
+        } catch (const std::exception& e) {
+            row.error = std::string("解析失败: ") + e.what();
+        }
+        rows.push_back(std::move(row));
+    }
+}
+
+// ========== 写入 ==========
+
+/**
+ * @brief 写入级：按文件顺序接收行，解析名称并分批提交
+ */
+class ImportWriter {
+public:
+    ImportWriter(Database& db, size_t batchRows, CsvImportResult& result, MessageSink& messages)
+        : m_db(db)
+        , m_refs(db.GetReferenceCache())
+        , m_batchRows(batchRows)
+        , m_result(result)
+        , m_messages(messages)
+        , m_inTransaction(false)
+    {
+        // 名称到 ID 的查找走字典缓存；导入中新建的分类、部门、员工由 update hook 增量并入
+        m_refs.Sync();
+        // 编号留空的行按默认前缀自动编号，每批从序列一次预留所需数量
+        m_codePrefix = m_db.GetDefaultAssetCodePrefix();
+        m_rows.reserve(batchRows);
+        m_batchCodes.reserve(batchRows);
+        m_pending.reserve(batchRows);
+        m_pendingLines.reserve(batchRows);
+        m_batchLines.reserve(batchRows);
+    }
+
+    void Add(ImportRow& row) {
+        if (!row.error.empty()) {
+            m_result.invalidCount++;
+            m_messages.Add(row.line, std::move(row.error));
+            return;
+        }
+
+        // 名称留到提交时解析，编号已存在的行不会新建分类、部门、员工
+        m_rows.push_back(std::move(row));
+        m_result.rows++;
+        if (m_rows.size() >= m_batchRows) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        if (m_rows.empty()) {
+            return;
+        }
+
+        // 新建的分类、部门、员工与资产在同一个事务中提交；
+        // 事务内停用逐行的全文索引、汇总、序列触发器，提交前按批补做
+        if (!m_inTransaction) {
+            m_inTransaction = m_db.BeginTransaction();
+        }
+        bool bulkLoad = m_inTransaction && m_db.BeginBulkLoad();
+
+        // 先按编号剔除库中已有或本批内重复的行，只为要写入的行解析名称。
+        // 跳过与逐行失败先记在本批，提交成功后才计数、输出；整批回滚时改为逐行报告未导入
+        int batchSkips = 0;
+        m_batchCodes.clear();
+        m_batchLines.clear();
+        m_batchMessages.clear();
+        for (auto& row : m_rows) {
+            m_batchLines.push_back(row.line);
+            Asset& asset = row.asset;
+            if (!asset.assetCode.empty() &&
+                (m_db.HasAssetCode(asset.assetCode) || !m_batchCodes.insert(asset.assetCode).second)) {
+                batchSkips++;
+                AddBatchMessage(row.line, "资产编号 " + asset.assetCode + " 已存在，跳过");
+                continue;
+            }
+            asset.categoryId = row.categoryName.empty() ? -1 : ResolveCategory(row.categoryName);
+            asset.userId = row.userName.empty() ? -1 : ResolveEmployee(row.userName, row.departmentName);
+            m_pending.push_back(std::move(asset));
+            m_pendingLines.push_back(row.line);
+        }
+        m_rows.clear();
+
+        // 编号预留失败时不写入，编号为空的行不能落库
+        std::string batchError;
+        int missingCodes = 0;
+        for (const auto& asset : m_pending) {
+            if (asset.assetCode.empty()) missingCodes++;
+        }
+        AssetCodeBlock block;
+        if (missingCodes > 0) {
+            if (m_db.ReserveAssetCodes(m_codePrefix, missingCodes, block)) {
+                int next = 0;
+                for (auto& asset : m_pending) {
+                    if (asset.assetCode.empty()) asset.assetCode = block.At(next++);
+                }
+            } else {
+                batchError = "预留资产编号失败";
+            }
+        }
+
+        int inserted = 0;
+        if (batchError.empty()) {
+            m_insertErrors.clear();
+            inserted = m_db.AddAssets(m_pending, &m_insertErrors);
+            for (const auto& err : m_insertErrors) {
+                const std::string& code = m_pending[err.index].assetCode;
+                long long line = m_pendingLines[err.index];
+                if (err.duplicateCode) {
+                    batchSkips++;
+                    AddBatchMessage(line, "资产编号 " + code + " 已存在，跳过");
+                } else {
+                    std::string errMsg = "添加资产 " + code + " 失败";
+                    if (!err.message.empty()) {
+                        errMsg += " (数据库错误: " + err.message + ")";
+                    }
+                    AddBatchMessage(line, std::move(errMsg));
+                }
+            }
+        }
+
+        bool rolledBack = false;
+        if (m_inTransaction) {
+            m_inTransaction = false;
+            if (batchError.empty() && ((bulkLoad && !m_db.EndBulkLoad()) || !m_db.Commit())) {
+                batchError = "提交失败";
+            }
+            rolledBack = !batchError.empty();
+        }
+        if (!batchError.empty()) {
+            batchError += " (数据库错误: " + m_db.GetLastError() + ")";
+            if (rolledBack) {
+                m_db.Rollback();
+                batchError += "，本批已回滚";
+            }
+        }
+
+        if (batchError.empty()) {
+            m_result.successCount += inserted;
+            m_result.skipCount += batchSkips;
+            for (auto& message : m_batchMessages) {
+                m_messages.Add(message.line, std::move(message.text));
+            }
+        } else {
+            // 整批各行都未导入（计入失败），之前记下的跳过与逐行信息不再成立
+            for (long long line : m_batchLines) {
+                m_messages.Add(line, batchError + "，本行未导入");
+            }
+        }
+        m_pending.clear();
+        m_pendingLines.clear();
+    }
+
+private:
+    Database& m_db;
+    ReferenceCache& m_refs;
+    size_t m_batchRows;
+    CsvImportResult& m_result;
+    MessageSink& m_messages;
+    std::string m_codePrefix;
+    std::vector<ImportRow> m_rows;              // 待提交的行，名称尚未解析
+    std::unordered_set<std::string> m_batchCodes;
+    std::vector<Asset> m_pending;
+    std::vector<long long> m_pendingLines;     // 与 m_pending 一一对应的行号
+    std::vector<AssetInsertError> m_insertErrors;
+    std::vector<long long> m_batchLines;       // 本批所有行的行号（含跳过的行）
+    std::vector<CsvImportMessage> m_batchMessages;  // 本批提交成功后才输出的逐行信息
+    bool m_inTransaction;
+
+    void AddBatchMessage(long long line, std::string text) {
+        CsvImportMessage message;
+        message.line = line;
+        message.text = std::move(text);
+        m_batchMessages.push_back(std::move(message));
+    }
+
+    int ResolveCategory(const std::string& name) {
+        int id = m_refs.FindCategoryId(name);
+        if (id < 0) {
+            // 不存在则创建
+            Category category{0, name};
+            if (m_db.AddCategory(category)) {
+                id = category.id;
+            }
+        }
+        return id;
+    }
+
+    int ResolveEmployee(const std::string& userName, const std::string& deptName) {
+        // 查找或创建部门
+        int deptId = -1;
+        if (!deptName.empty()) {
+            deptId = m_refs.FindDepartmentId(deptName);
+            if (deptId < 0) {
+                Department dept{0, deptName};
+                if (m_db.AddDepartment(dept)) {
+                    deptId = dept.id;
+                }
+            }
+        }
+
+        // 按 (姓名, 部门) 查找员工，不存在则创建
+        int userId = m_refs.FindEmployeeId(userName, deptId);
+        if (userId < 0) {
+            Employee employee{0, userName, deptId};
+            if (m_db.AddEmployee(employee)) {
+                userId = employee.id;
+            }
+        }
+        return userId;
+    }
+};
+
+// ========== 检查 ==========
+
+/**
+ * @brief 文件内编号去重：只保存编号的 64 位哈希与首次出现的行号
+ *
+ * 开放寻址，每个槽 16 字节，装载率不超过一半。
+ *
+ * 不保存编号文本。两个不同编号哈希相同的概率在百万行量级约为 1e-8，可以忽略。
+ */
+class CodeIndex {
+public:
+    CodeIndex() : m_slots(1 << 12), m_count(0) {}
+
+    /**
+     * @brief 编号已出现过时返回首次出现的行号，否则记录下来并返回 0
+     */
+    long long Insert(std::string_view code, long long line) {
+        if ((m_count + 1) * 2 > m_slots.size()) {
+            Grow();
+        }
+        uint64_t hash = Hash(code);
+        size_t mask = m_slots.size() - 1;
+        for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = m_slots[i];
+            if (slot.line == 0) {
+                slot.hash = hash;
+                slot.line = line;
+                m_count++;
+                return 0;
+            }
+            if (slot.hash == hash) {
+                return slot.line;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        long long line = 0;         // 0 表示空槽（行号从 1 开始）
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_count;
+
+    // FNV-1a 后做一次 splitmix64 混合，低位也分布均匀
+    static uint64_t Hash(std::string_view text) {
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (unsigned char c : text) {
+            h = (h ^ c) * 0x100000001B3ULL;
+        }
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    void Grow() {
+        std::vector<Slot> old(m_slots.size() * 2);
+        old.swap(m_slots);
+        size_t mask = m_slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.line == 0) {
+                continue;
+            }
+            size_t i = (size_t)slot.hash & mask;
+            while (m_slots[i].line != 0) {
+                i = (i + 1) & mask;
+            }
+            m_slots[i] = slot;
+        }
+    }
+};
+
+/**
+ * @brief 检查级：按文件顺序接收行，报告字段问题与重复编号，不写数据库
+ */
+class ImportValidator {
+public:
+    ImportValidator(Database& db, CsvValidateResult& result, MessageSink& messages)
+        : m_db(db)
+        , m_result(result)
+        , m_messages(messages)
+    {
+    }
+
+    void Add(ImportRow& row) {
+        m_result.rows++;
+        if (!row.error.empty()) {
+            // 字段有误的行导入时不写入，也不占用编号
+            m_result.invalidRows++;
+            m_messages.Add(row.line, std::move(row.error));
+            return;
+        }
+
+        // 编号留空的行导入时自动编号，不会重复
+        const std::string& code = row.asset.assetCode;
+        if (!code.empty()) {
+            long long firstLine = m_codes.Insert(code, row.line);
+            if (firstLine > 0) {
+                m_result.duplicateRows++;
+                m_messages.Add(row.line, "资产编号 " + code + " 与第 " + std::to_string(firstLine) + " 行重复");
+                return;
+            }
+            if (m_db.HasAssetCode(code)) {
+                m_result.existingRows++;
+                m_messages.Add(row.line, "资产编号 " + code + " 已存在");
+                return;
+            }
+        }
+
+        if (!row.warning.empty()) {
+            m_result.nonStandardRows++;
+            m_messages.Add(row.line, "字段不规范（导入时照常写入）: " + row.warning);
+            return;
+        }
+        m_result.validRows++;
+    }
+
+private:
+    Database& m_db;
+    CsvValidateResult& m_result;
+    MessageSink& m_messages;
+    CodeIndex m_codes;
+};
+
+// ========== 流水线 ==========
+
+/**
+ * @brief 读、解析两级流水，解析出的行按文件顺序交给调用线程上的 consume
+ * @param first 已在调用线程上切出的第一段
+ */
+template <typename Consume>
+static void ParseInOrder(CsvReader& reader, CsvChunk& first, size_t chunkBytes, int workerCount,
+                         bool isUtf8, bool validate, bool strict, Consume&& consume) {
+    if (workerCount == 0) {
+        // 串行：与流水线共用解析和写入代码，作为结果对照
+        std::vector<ImportRow> rows;
+        bool firstChunk = true;
+        CsvChunk chunk = std::move(first);
+        do {
+            rows.clear();
+            ParseChunk(chunk, firstChunk, isUtf8, validate, strict, rows);
+            firstChunk = false;
+            for (ImportRow& row : rows) {
+                consume(row);
+            }
+        } while (reader.NextChunk(chunkBytes, chunk));
+        return;
+    }
+
+    size_t capacity = (size_t)workerCount * kQueueChunksPerWorker;
+    BoundedQueue<ChunkTask> tasks(capacity);
+    BoundedQueue<ParsedChunk> parsed(capacity);
+    std::atomic<int> running(workerCount);
+
+    std::thread readerThread([&]() {
+        ChunkTask task;
+        task.chunk = std::move(first);
+        do {
+            uint64_t seq = task.seq;
+            if (!tasks.Push(std::move(task))) {
+                break;
+            }
+            task = ChunkTask();
+            task.seq = seq + 1;
+        } while (reader.NextChunk(chunkBytes, task.chunk));
+        tasks.Close();
+    });
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back([&]() {
+            ChunkTask task;
+            while (tasks.Pop(task)) {
+                ParsedChunk out;
+                out.seq = task.seq;
+                ParseChunk(task.chunk, task.seq == 0, isUtf8, validate, strict, out.rows);
+                parsed.Push(std::move(out));
+            }
+            if (--running == 0) {
+                parsed.Close();
+            }
+        });
+    }
+
+    // 解析线程完成的顺序不定，按段号恢复文件顺序
+    std::map<uint64_t, std::vector<ImportRow>> ready;
+    uint64_t nextSeq = 0;
+    ParsedChunk out;
+    while (parsed.Pop(out)) {
+        ready.emplace(out.seq, std::move(out.rows));
+        for (auto it = ready.find(nextSeq); it != ready.end(); it = ready.find(nextSeq)) {
+            for (ImportRow& row : it->second) {
+                consume(row);
+            }
+            ready.erase(it);
+            nextSeq++;
+        }
+    }
+
+    readerThread.join();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+
+CsvImporter::CsvImporter(Database& db, const CsvImportOptions& options)
+    : m_db(db)
+    , m_options(options)
+    , m_workers(options.workers)
+{
+    if (m_options.batchRows == 0) {
+        m_options.batchRows = 1;
+    }
+    if (m_workers < 0) {
+        // 读线程与写入各占一个核
+        int cores = (int)std::thread::hardware_concurrency();
+        m_workers = std::min(std::max(cores - 2, 1), kMaxAutoWorkers);
+    }
+}
+
+bool CsvImporter::Import(const std::string& path, CsvImportResult& result) {
+    CsvReader reader;
+    if (!reader.Open(path)) {
+        m_lastError = reader.GetLastError();
+        return false;
+    }
+    return Run(reader, result);
+}
+
+#ifdef _WIN32
+bool CsvImporter::Import(const std::wstring& path, CsvImportResult& result) {
+    CsvReader reader;
+    if (!reader.Open(path)) {
+        m_lastError = reader.GetLastError();
+        return false;
+    }
+    return Run(reader, result);
+}
+#endif
+
+bool CsvImporter::Validate(const std::string& path, CsvValidateResult& result) {
+    CsvReader reader;
+    if (!reader.Open(path)) {
+        m_lastError = reader.GetLastError();
+        return false;
+    }
+    return RunValidate(reader, result);
+}
+
+#ifdef _WIN32
+bool CsvImporter::Validate(const std::wstring& path, CsvValidateResult& result) {
+    CsvReader reader;
+    if (!reader.Open(path)) {
+        m_lastError = reader.GetLastError();
+        return false;
+    }
+    return RunValidate(reader, result);
+}
+#endif
+
+bool CsvImporter::Run(CsvReader& reader, CsvImportResult& result) {
+    result = CsvImportResult();
+    m_lastError.clear();
+    MessageSink messages(m_options.onMessage, result.errors, result.messageCount);
+    ImportWriter writer(m_db, m_options.batchRows, result, messages);
+
+    // 第一段在调用线程上切出，之后才知道文件是否带 BOM
+    CsvChunk first;
+    if (!reader.NextChunk(m_options.chunkBytes, first)) {
+        m_lastError = reader.GetLastError();
+        if (!m_lastError.empty()) {
+            messages.Add(0, m_lastError);
+            return false;
+        }
+        return true;
+    }
+
+    ParseInOrder(reader, first, m_options.chunkBytes, m_workers, reader.HasUtf8Bom(), false,
+                 m_options.strictFields,
+                 [&writer](ImportRow& row) { writer.Add(row); });
+    writer.Flush();
+
+    // 读取中断时已提交的批次保留，原因同时记入逐行信息
+    m_lastError = reader.GetLastError();
+    if (!m_lastError.empty()) {
+        messages.Add(0, m_lastError);
+        return false;
+    }
+    return true;
+}
+
+bool CsvImporter::RunValidate(CsvReader& reader, CsvValidateResult& result) {
+    result = CsvValidateResult();
+    m_lastError.clear();
+    MessageSink messages(m_options.onMessage, result.errors, result.messageCount);
+    ImportValidator validator(m_db, result, messages);
+
+    CsvChunk first;
+    if (!reader.NextChunk(m_options.chunkBytes, first)) {
+        m_lastError = reader.GetLastError();
+        if (!m_lastError.empty()) {
+            messages.Add(0, m_lastError);
+            return false;
+        }
+        return true;
+    }
+
+    ParseInOrder(reader, first, m_options.chunkBytes, m_workers, reader.HasUtf8Bom(), true,
+                 m_options.strictFields,
+                 [&validator](ImportRow& row) { validator.Add(row); });
+
+    m_lastError = reader.GetLastError();
+    if (!m_lastError.empty()) {
+        messages.Add(0, m_lastError);
+        return false;
+    }
+    return true;
+}
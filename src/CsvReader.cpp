@@ -0,0 +1,508 @@
+/**
+ * @file CsvReader.cpp
+ * @brief 流式 CSV 读取器实现
+ */
+
+#include "CsvReader.h"
+#include "CsvScanner.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// 分块读取的初始缓冲大小；单条记录超过缓冲时按倍数扩大
+static const size_t kBufferSize = 1 << 20;
+
+// 单次读取上限（ReadFile 的长度参数为 32 位）
+static const size_t kMaxReadSize = 1 << 30;
+
+CsvReader::CsvReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_eof(true)
+    , m_windowOffset(0)
+    , m_totalSize(0)
+    , m_line(1)
+    , m_hasBom(false)
+    , m_started(false)
+#ifdef _WIN32
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+    , m_mapView(nullptr)
+    , m_mapSize(0)
+    , m_block()
+    , m_blockValid(false)
+{
+}
+
+CsvReader::~CsvReader() {
+    Close();
+}
+
+void CsvReader::Close() {
+#ifdef _WIN32
+    if (m_mapView) {
+        UnmapViewOfFile(m_mapView);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_mapView) {
+        munmap(m_mapView, m_mapSize);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+    m_mapView = nullptr;
+    m_mapSize = 0;
+
+    m_data = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    m_eof = true;
+    m_windowOffset = 0;
+    m_totalSize = 0;
+    m_line = 1;
+    m_hasBom = false;
+    m_started = false;
+    m_blockValid = false;
+    std::vector<char>().swap(m_buffer);
+}
+
+#ifdef _WIN32
+
+bool CsvReader::Open(const std::string& path, CsvReadMode mode) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), (int)path.size(), nullptr, 0);
+    std::wstring wpath(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), (int)path.size(), &wpath[0], len);
+    return Open(wpath, mode);
+}
+
+bool CsvReader::Open(const std::wstring& path, CsvReadMode mode) {
+    Close();
+    m_lastError.clear();
+
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_lastError = "无法打开文件 (错误码 " + std::to_string(::GetLastError()) + ")";
+        return false;
+    }
+    return OpenHandle(mode);
+}
+
+bool CsvReader::OpenHandle(CsvReadMode mode) {
+    LARGE_INTEGER size;
+    bool regular = GetFileType(m_file) == FILE_TYPE_DISK && GetFileSizeEx(m_file, &size);
+    m_totalSize = regular ? (uint64_t)size.QuadPart : 0;
+
+    if (regular && m_totalSize == 0) {
+        // 空文件无法映射
+        m_eof = true;
+        return true;
+    }
+
+    if (regular && mode == CsvReadMode::Auto && m_totalSize <= (uint64_t)SIZE_MAX) {
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping) {
+            m_mapView = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (m_mapView) {
+                m_mapSize = (size_t)m_totalSize;
+                m_data = (const char*)m_mapView;
+                m_size = m_mapSize;
+                m_eof = true;
+                return true;
+            }
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+    }
+
+    m_buffer.resize(kBufferSize);
+    m_data = m_buffer.data();
+    m_eof = false;
+    return true;
+}
+
+long long CsvReader::ReadSome(char* dest, size_t size) {
+    DWORD read = 0;
+    if (!ReadFile(m_file, dest, (DWORD)std::min(size, kMaxReadSize), &read, nullptr)) {
+        DWORD error = ::GetLastError();
+        if (error == ERROR_BROKEN_PIPE || error == ERROR_HANDLE_EOF) {
+            return 0;
+        }
+        m_lastError = "读取文件失败 (错误码 " + std::to_string(error) + ")";
+        return -1;
+    }
+    return (long long)read;
+}
+
+#else
+
+bool CsvReader::Open(const std::string& path, CsvReadMode mode) {
+    Close();
+    m_lastError.clear();
+
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_lastError = std::string("无法打开文件: ") + std::strerror(errno);
+        return false;
+    }
+    return OpenHandle(mode);
+}
+
+bool CsvReader::OpenHandle(CsvReadMode mode) {
+    struct stat st;
+    bool regular = fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode);
+    m_totalSize = regular ? (uint64_t)st.st_size : 0;
+
+    if (regular && m_totalSize == 0) {
+        // 空文件无法映射
+        m_eof = true;
+        return true;
+    }
+
+    if (regular && mode == CsvReadMode::Auto && m_totalSize <= (uint64_t)SIZE_MAX) {
+        void* view = mmap(nullptr, (size_t)m_totalSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (view != MAP_FAILED) {
+            // 顺序访问：提示内核加大预读
+            madvise(view, (size_t)m_totalSize, MADV_SEQUENTIAL);
+            m_mapView = view;
+            m_mapSize = (size_t)m_totalSize;
+            m_data = (const char*)view;
+            m_size = m_mapSize;
+            m_eof = true;
+            return true;
+        }
+    }
+
+    m_buffer.resize(kBufferSize);
+    m_data = m_buffer.data();
+    m_eof = false;
+    return true;
+}
+
+long long CsvReader::ReadSome(char* dest, size_t size) {
+    for (;;) {
+        ssize_t n = ::read(m_fd, dest, std::min(size, kMaxReadSize));
+        if (n >= 0) {
+            return (long long)n;
+        }
+        if (errno != EINTR) {
+            m_lastError = std::string("读取文件失败: ") + std::strerror(errno);
+            return -1;
+        }
+    }
+}
+
+#endif
+
+void CsvReader::OpenMemory(std::string_view data) {
+    Close();
+    m_lastError.clear();
+    m_data = data.data();
+    m_size = data.size();
+    m_totalSize = data.size();
+    m_eof = true;
+}
+
+bool CsvReader::Refill() {
+    // 未解析完的部分移到缓冲开头，缓冲被一条记录占满时扩大
+    size_t remaining = m_size - m_pos;
+    if (m_pos > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_pos, remaining);
+        m_windowOffset += m_pos;
+        m_pos = 0;
+    }
+    if (remaining == m_buffer.size()) {
+        m_buffer.resize(m_buffer.size() * 2);
+    }
+    m_data = m_buffer.data();
+    m_size = remaining;
+    m_blockValid = false;
+
+    // 读满缓冲：read 对管道可能只返回部分数据
+    while (m_size < m_buffer.size()) {
+        long long n = ReadSome(m_buffer.data() + m_size, m_buffer.size() - m_size);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            m_eof = true;
+            break;
+        }
+        m_size += (size_t)n;
+    }
+    return true;
+}
+
+void CsvReader::LoadBlock(size_t pos, uint64_t carry) {
+    size_t length = std::min<size_t>(64, m_size - pos);
+    CsvBlockMasks masks;
+    CsvScanner::Classify(m_data + pos, length, masks);
+
+    uint64_t valid = length == 64 ? ~0ULL : ((1ULL << length) - 1);
+    uint64_t inside = (CsvScanner::PrefixXor(masks.quote) ^ carry) & valid;
+
+    m_block.pos = pos;
+    m_block.length = length;
+    m_block.quote = masks.quote;
+    m_block.structural = masks.separator & ~inside;
+    m_block.quotedLf = masks.lineFeed & inside;
+    m_block.carry = ((inside >> (length - 1)) & 1) ? ~0ULL : 0;
+    m_blockValid = true;
+}
+
+CsvReader::ScanResult CsvReader::ScanRecord(size_t& next, long long& newlines) {
+    newlines = 0;
+    m_spans.clear();
+
+    if (m_pos >= m_size) {
+        return m_eof ? ScanResult::End : ScanResult::NeedMore;
+    }
+
+    // 记录总是从引号外开始：缓存失效时从当前位置重新分块，进位为 0
+    if (!m_blockValid || m_pos < m_block.pos) {
+        LoadBlock(m_pos, 0);
+    }
+    while (m_pos >= m_block.pos + m_block.length) {
+        LoadBlock(m_block.pos + m_block.length, m_block.carry);
+    }
+
+    // 屏蔽块内属于之前记录的位
+    uint64_t consumed = (1ULL << (m_pos - m_block.pos)) - 1;
+    uint64_t structural = m_block.structural & ~consumed;
+    uint64_t quotes = m_block.quote & ~consumed;
+    uint64_t quotedLf = m_block.quotedLf & ~consumed;
+
+    size_t fieldStart = m_pos;
+    int fieldQuotes = 0;
+
+    for (;;) {
+        while (structural) {
+            int bit = CsvScanner::LowestBit(structural);
+            structural &= structural - 1;
+            size_t pos = m_block.pos + (size_t)bit;
+            uint64_t before = (1ULL << bit) - 1;
+
+            fieldQuotes += CsvScanner::CountBits(quotes & before);
+            quotes &= ~before;
+            m_spans.push_back({fieldStart, pos - fieldStart, fieldQuotes});
+
+            if (m_data[pos] == ',') {
+                fieldStart = pos + 1;
+                fieldQuotes = 0;
+                continue;
+            }
+
+            // \r\n、\n 或单独的 \r
+            newlines += CsvScanner::CountBits(quotedLf & before) + 1;
+            next = pos + 1;
+            if (m_data[pos] == '\r') {
+                if (next == m_size && !m_eof) {
+                    return ScanResult::NeedMore;
+                }
+                if (next < m_size && m_data[next] == '\n') {
+                    next++;
+                }
+            }
+
+            if (m_spans.size() == 1 && m_spans[0].length == 0) {
+                return ScanResult::Blank;
+            }
+            return ScanResult::Record;
+        }
+
+        fieldQuotes += CsvScanner::CountBits(quotes);
+        newlines += CsvScanner::CountBits(quotedLf);
+
+        size_t blockEnd = m_block.pos + m_block.length;
+        if (blockEnd == m_size) {
+            if (!m_eof) {
+                return ScanResult::NeedMore;
+            }
+            // 最后一行没有换行（引号未闭合时余下内容都属于最后一个字段）
+            m_spans.push_back({fieldStart, m_size - fieldStart, fieldQuotes});
+            next = m_size;
+            if (m_spans.size() == 1 && m_spans[0].length == 0) {
+                return ScanResult::Blank;
+            }
+            return ScanResult::Record;
+        }
+
+        LoadBlock(blockEnd, m_block.carry);
+        structural = m_block.structural;
+        quotes = m_block.quote;
+        quotedLf = m_block.quotedLf;
+    }
+}
+
+void CsvReader::BuildFields(CsvRecord& record) {
+    record.fields.clear();
+
+    // 先预留全部反转义字段所需空间，保证之后追加时不会重新分配
+    size_t unescapedSize = 0;
+    for (const FieldSpan& span : m_spans) {
+        if (span.quotes > 0) {
+            unescapedSize += span.length;
+        }
+    }
+    m_unescaped.clear();
+    m_unescaped.reserve(unescapedSize);
+
+    for (const FieldSpan& span : m_spans) {
+        const char* raw = m_data + span.offset;
+
+        if (span.quotes == 0) {
+            record.fields.emplace_back(raw, span.length);
+            continue;
+        }
+        if (span.quotes == 2 && span.length >= 2 && raw[0] == '"' && raw[span.length - 1] == '"') {
+            // 最常见的引号字段："..."，内部无转义
+            record.fields.emplace_back(raw + 1, span.length - 2);
+            continue;
+        }
+
+        // "" 转义，或引号出现在字段中间（如 ab"c,d"e）
+        size_t start = m_unescaped.size();
+        bool inQuotes = false;
+        for (size_t i = 0; i < span.length; i++) {
+            char c = raw[i];
+            if (c == '"') {
+                if (inQuotes && i + 1 < span.length && raw[i + 1] == '"') {
+                    m_unescaped.push_back('"');
+                    i++;
+                } else {
+                    inQuotes = !inQuotes;
+                }
+            } else {
+                m_unescaped.push_back(c);
+            }
+        }
+        record.fields.emplace_back(m_unescaped.data() + start, m_unescaped.size() - start);
+    }
+}
+
+bool CsvReader::SkipBom() {
+    while (!m_started) {
+        // BOM 可能跨越第一次读取的边界
+        if (m_size - m_pos < 3 && !m_eof) {
+            if (!Refill()) {
+                return false;
+            }
+            continue;
+        }
+        m_started = true;
+        if (m_size - m_pos >= 3 && std::memcmp(m_data + m_pos, "\xEF\xBB\xBF", 3) == 0) {
+            m_hasBom = true;
+            m_pos += 3;
+        }
+    }
+    return true;
+}
+
+bool CsvReader::Next(CsvRecord& record) {
+    if (!m_lastError.empty() || !SkipBom()) {
+        return false;
+    }
+
+    for (;;) {
+        size_t next = m_pos;
+        long long newlines = 0;
+        ScanResult result = ScanRecord(next, newlines);
+
+        if (result == ScanResult::NeedMore) {
+            if (!Refill()) {
+                return false;
+            }
+            continue;
+        }
+        if (result == ScanResult::End) {
+            return false;
+        }
+
+        long long line = m_line;
+        m_line += newlines;
+        if (result == ScanResult::Blank) {
+            m_pos = next;
+            continue;
+        }
+
+        record.line = line;
+        BuildFields(record);
+        m_pos = next;
+        return true;
+    }
+}
+
+bool CsvReader::NextChunk(size_t minBytes, CsvChunk& chunk) {
+    chunk.mapped = std::string_view();
+    chunk.owned.clear();
+    if (!m_lastError.empty() || !SkipBom()) {
+        return false;
+    }
+
+    // 分块读取时窗口会移动，逐条复制；映射区与外部内存不会移动，直接取视图
+    bool copy = !m_buffer.empty();
+    size_t start = m_pos;
+    size_t bytes = 0;
+    chunk.firstLine = m_line;
+
+    while (bytes < minBytes) {
+        size_t next = m_pos;
+        long long newlines = 0;
+        ScanResult result = ScanRecord(next, newlines);
+
+        if (result == ScanResult::NeedMore) {
+            if (!Refill()) {
+                return false;
+            }
+            continue;
+        }
+        if (result == ScanResult::End) {
+            break;
+        }
+
+        // 空行也留在段内，保证解析时行号连续
+        if (copy) {
+            chunk.owned.append(m_data + m_pos, next - m_pos);
+        }
+        bytes += next - m_pos;
+        m_line += newlines;
+        m_pos = next;
+    }
+
+    if (!copy) {
+        chunk.mapped = std::string_view(m_data + start, bytes);
+    }
+    return bytes > 0;
+}
+
+void CsvReader::OpenChunk(const CsvChunk& chunk) {
+    OpenMemory(chunk.Data());
+    m_started = true;
+    m_line = chunk.firstLine;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file CsvScanner.cpp
+ * @brief CSV 结构字符向量化扫描实现
+ */
+
+#include "CsvScanner.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CSV_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang 按函数启用指令集，其余代码仍按基线编译；MSVC 无需声明即可使用内建函数
+#if defined(__GNUC__) || defined(__clang__)
+#define CSV_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CSV_TARGET(isa)
+#endif
+
+using ClassifyFn = void (*)(const char*, CsvBlockMasks&);
+
+// ========== 标量实现 ==========
+
+// 不足 64 字节的尾块逐字节处理
+static void ClassifyScalarPartial(const char* data, size_t size, CsvBlockMasks& masks) {
+    uint64_t quote = 0;
+    uint64_t separator = 0;
+    uint64_t lineFeed = 0;
+    for (size_t i = 0; i < size; i++) {
+        char c = data[i];
+        uint64_t bit = 1ULL << i;
+        quote |= (c == '"') ? bit : 0;
+        separator |= (c == ',' || c == '\n' || c == '\r') ? bit : 0;
+        lineFeed |= (c == '\n') ? bit : 0;
+    }
+    masks.quote = quote;
+    masks.separator = separator;
+    masks.lineFeed = lineFeed;
+}
+
+// 按 8 字节一组比较（SWAR）：字节等于 c 时该字节最高位为 1，不会误报
+static inline uint64_t MatchBytes(uint64_t word, unsigned char c) {
+    uint64_t x = word ^ (0x0101010101010101ULL * c);
+    uint64_t t = ((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | x;
+    return ~t & 0x8080808080808080ULL;
+}
+
+// 把每个字节的最高位收集成 8 位（第 i 字节对应第 i 位，按小端序加载）
+static inline uint64_t GatherBits(uint64_t matches) {
+    return ((matches >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+static void ClassifyScalar(const char* data, CsvBlockMasks& masks) {
+    uint64_t quote = 0;
+    uint64_t separator = 0;
+    uint64_t lineFeed = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t word;
+        std::memcpy(&word, data + i * 8, 8);
+        uint64_t lf = MatchBytes(word, '\n');
+        uint64_t sep = MatchBytes(word, ',') | MatchBytes(word, '\r') | lf;
+        quote |= GatherBits(MatchBytes(word, '"')) << (i * 8);
+        separator |= GatherBits(sep) << (i * 8);
+        lineFeed |= GatherBits(lf) << (i * 8);
+    }
+    masks.quote = quote;
+    masks.separator = separator;
+    masks.lineFeed = lineFeed;
+}
+
+// ========== SSE2 / AVX2 实现 ==========
+
+#ifdef CSV_SCANNER_X86
+
+CSV_TARGET("sse2")
+static void ClassifySse2(const char* data, CsvBlockMasks& masks) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    uint64_t quoteBits = 0;
+    uint64_t separatorBits = 0;
+    uint64_t lineFeedBits = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i * 16));
+        __m128i isLf = _mm_cmpeq_epi8(chunk, lf);
+        __m128i isSep = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                                                  _mm_cmpeq_epi8(chunk, cr)), isLf);
+        int shift = i * 16;
+        quoteBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)) << shift;
+        separatorBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(isSep) << shift;
+        lineFeedBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(isLf) << shift;
+    }
+    masks.quote = quoteBits;
+    masks.separator = separatorBits;
+    masks.lineFeed = lineFeedBits;
+}
+
+CSV_TARGET("avx2")
+static void ClassifyAvx2(const char* data, CsvBlockMasks& masks) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    __m256i lo = _mm256_loadu_si256((const __m256i*)data);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(data + 32));
+
+    __m256i lfLo = _mm256_cmpeq_epi8(lo, lf);
+    __m256i lfHi = _mm256_cmpeq_epi8(hi, lf);
+    __m256i sepLo = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, comma),
+                                                    _mm256_cmpeq_epi8(lo, cr)), lfLo);
+    __m256i sepHi = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(hi, comma),
+                                                    _mm256_cmpeq_epi8(hi, cr)), lfHi);
+
+    masks.quote = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote)) |
+                  ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)) << 32);
+    masks.separator = (uint64_t)(uint32_t)_mm256_movemask_epi8(sepLo) |
+                      ((uint64_t)(uint32_t)_mm256_movemask_epi8(sepHi) << 32);
+    masks.lineFeed = (uint64_t)(uint32_t)_mm256_movemask_epi8(lfLo) |
+                     ((uint64_t)(uint32_t)_mm256_movemask_epi8(lfHi) << 32);
+}
+
+#endif  // CSV_SCANNER_X86
+
+// ========== 运行时选择 ==========
+
+#ifdef CSV_SCANNER_X86
+
+static bool CpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;    // x86-64 基线
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // 还需操作系统保存 YMM 寄存器（OSXSAVE + XCR0 的 SSE/AVX 位）
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // 内建检测已包含操作系统支持检查
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // CSV_SCANNER_X86
+
+static ClassifyFn KernelFunction(CsvScanKernel kernel) {
+    switch (kernel) {
+#ifdef CSV_SCANNER_X86
+    case CsvScanKernel::Avx2:
+        return ClassifyAvx2;
+    case CsvScanKernel::Sse2:
+        return ClassifySse2;
+#endif
+    default:
+        return ClassifyScalar;
+    }
+}
+
+static CsvScanKernel DetectKernel() {
+    if (CsvScanner::IsSupported(CsvScanKernel::Avx2)) {
+        return CsvScanKernel::Avx2;
+    }
+    if (CsvScanner::IsSupported(CsvScanKernel::Sse2)) {
+        return CsvScanKernel::Sse2;
+    }
+    return CsvScanKernel::Scalar;
+}
+
+// 当前实现；函数内静态变量保证首次检测只执行一次
+static std::atomic<CsvScanKernel>& CurrentKernel() {
+    static std::atomic<CsvScanKernel> kernel(DetectKernel());
+    return kernel;
+}
+
+static std::atomic<ClassifyFn>& CurrentFunction() {
+    static std::atomic<ClassifyFn> function(KernelFunction(CurrentKernel().load()));
+    return function;
+}
+
+bool CsvScanner::IsSupported(CsvScanKernel kernel) {
+    switch (kernel) {
+    case CsvScanKernel::Scalar:
+        return true;
+#ifdef CSV_SCANNER_X86
+    case CsvScanKernel::Sse2:
+        return CpuHasSse2();
+    case CsvScanKernel::Avx2:
+        return CpuHasAvx2();
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* CsvScanner::GetKernelName(CsvScanKernel kernel) {
+    switch (kernel) {
+    case CsvScanKernel::Sse2:
+        return "sse2";
+    case CsvScanKernel::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+CsvScanKernel CsvScanner::GetKernel() {
+    return CurrentKernel().load(std::memory_order_relaxed);
+}
+
+bool CsvScanner::SetKernel(CsvScanKernel kernel) {
+    if (!IsSupported(kernel)) {
+        return false;
+    }
+    CurrentKernel().store(kernel, std::memory_order_relaxed);
+    CurrentFunction().store(KernelFunction(kernel), std::memory_order_relaxed);
+    return true;
+}
+
+void CsvScanner::Classify(const char* data, size_t size, CsvBlockMasks& masks) {
+    if (size >= 64) {
+        CurrentFunction().load(std::memory_order_relaxed)(data, masks);
+    } else {
+        ClassifyScalarPartial(data, size, masks);
+    }
+}
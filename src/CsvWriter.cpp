@@ -0,0 +1,273 @@
+/**
+ * @file CsvWriter.cpp
+ * @brief 缓冲 CSV 写出器实现
+ */
+
+#include "CsvWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_WRITER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// 单次写入上限（WriteFile 的长度参数为 32 位）
+static const size_t kMaxWriteSize = 1 << 30;
+
+// 定点格式的 double 最长约 310 个字符（1e308）
+static const size_t kMaxNumberLength = 350;
+
+CsvWriter::CsvWriter(size_t bufferSize)
+#ifdef _WIN32
+    : m_file(INVALID_HANDLE_VALUE)
+#else
+    : m_fd(-1)
+#endif
+    , m_buffer(std::max<size_t>(bufferSize, 4096))
+    , m_used(0)
+    , m_flushed(0)
+    , m_atRecordStart(true)
+    , m_failed(false)
+{
+}
+
+CsvWriter::~CsvWriter() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool CsvWriter::Open(const std::string& path) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), (int)path.size(), nullptr, 0);
+    std::wstring wpath(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), (int)path.size(), &wpath[0], len);
+    return Open(wpath);
+}
+
+bool CsvWriter::Open(const std::wstring& path) {
+    Close();
+    m_lastError.clear();
+
+    m_file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+                         CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_lastError = "无法创建文件 (错误码 " + std::to_string(::GetLastError()) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool CsvWriter::IsOpen() const {
+    return m_file != INVALID_HANDLE_VALUE;
+}
+
+bool CsvWriter::WriteAll(const char* data, size_t size) {
+    while (size > 0) {
+        DWORD written = 0;
+        if (!WriteFile(m_file, data, (DWORD)std::min(size, kMaxWriteSize), &written, nullptr)) {
+            m_lastError = "写入文件失败 (错误码 " + std::to_string(::GetLastError()) + ")";
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+#else
+
+bool CsvWriter::Open(const std::string& path) {
+    Close();
+    m_lastError.clear();
+
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        m_lastError = std::string("无法创建文件: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool CsvWriter::IsOpen() const {
+    return m_fd >= 0;
+}
+
+bool CsvWriter::WriteAll(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(m_fd, data, std::min(size, kMaxWriteSize));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            m_lastError = std::string("写入文件失败: ") + std::strerror(errno);
+            return false;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+#endif
+
+bool CsvWriter::Close() {
+    bool ok = true;
+    if (IsOpen()) {
+        ok = Flush();
+#ifdef _WIN32
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (::close(m_fd) != 0 && !m_failed) {
+            m_lastError = std::string("写入文件失败: ") + std::strerror(errno);
+            ok = false;
+        }
+        m_fd = -1;
+#endif
+    }
+    ok = ok && !m_failed;
+    m_used = 0;
+    m_flushed = 0;
+    m_atRecordStart = true;
+    m_failed = false;
+    return ok;
+}
+
+bool CsvWriter::Flush() {
+    if (m_failed || !IsOpen()) {
+        m_used = 0;
+        return !m_failed;
+    }
+    if (m_used > 0 && !WriteAll(m_buffer.data(), m_used)) {
+        m_failed = true;
+        m_used = 0;
+        return false;
+    }
+    m_flushed += m_used;
+    m_used = 0;
+    return true;
+}
+
+char* CsvWriter::Reserve(size_t bytes) {
+    if (m_buffer.size() - m_used < bytes) {
+        Flush();
+        // 单个字段比整个缓冲还大时扩大缓冲
+        if (m_buffer.size() < bytes) {
+            m_buffer.resize(bytes);
+        }
+    }
+    return m_buffer.data() + m_used;
+}
+
+void CsvWriter::BeginField() {
+    if (!m_atRecordStart) {
+        *Reserve(1) = ',';
+        m_used++;
+    }
+    m_atRecordStart = false;
+}
+
+bool CsvWriter::NeedsQuote(std::string_view field) {
+    const char* data = field.data();
+    size_t size = field.size();
+    size_t i = 0;
+#ifdef CSV_WRITER_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+        if (_mm_movemask_epi8(hits) != 0) {
+            return true;
+        }
+    }
+#else
+    // 字节等于 c 时该字节最高位为 1
+    auto match = [](uint64_t word, unsigned char c) {
+        uint64_t x = word ^ (0x0101010101010101ULL * c);
+        return ~(((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | x) & 0x8080808080808080ULL;
+    };
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        if (match(word, ',') | match(word, '"') | match(word, '\r') | match(word, '\n')) {
+            return true;
+        }
+    }
+#endif
+    for (; i < size; i++) {
+        char c = data[i];
+        if (c == ',' || c == '"' || c == '\r' || c == '\n') {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CsvWriter::WriteField(std::string_view field) {
+    BeginField();
+
+    if (!NeedsQuote(field)) {
+        std::memcpy(Reserve(field.size()), field.data(), field.size());
+        m_used += field.size();
+        return;
+    }
+
+    // 最坏情况每个字符都是引号
+    char* out = Reserve(field.size() * 2 + 2);
+    char* begin = out;
+    *out++ = '"';
+    const char* p = field.data();
+    const char* end = p + field.size();
+    while (p < end) {
+        const char* quote = (const char*)std::memchr(p, '"', end - p);
+        const char* stop = quote ? quote + 1 : end;
+        std::memcpy(out, p, stop - p);
+        out += stop - p;
+        if (quote) {
+            *out++ = '"';   // 转义引号
+        }
+        p = stop;
+    }
+    *out++ = '"';
+    m_used += out - begin;
+}
+
+void CsvWriter::WriteField(long long value) {
+    BeginField();
+    char* out = Reserve(24);
+    m_used += std::to_chars(out, out + 24, value).ptr - out;
+}
+
+void CsvWriter::WriteField(double value) {
+    BeginField();
+    char* out = Reserve(kMaxNumberLength);
+    m_used += std::to_chars(out, out + kMaxNumberLength, value, std::chars_format::fixed).ptr - out;
+}
+
+void CsvWriter::WriteRaw(std::string_view data) {
+    std::memcpy(Reserve(data.size()), data.data(), data.size());
+    m_used += data.size();
+}
+
+void CsvWriter::EndRecord() {
+    *Reserve(1) = '\n';
+    m_used++;
+    m_atRecordStart = true;
+}
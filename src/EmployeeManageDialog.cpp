@@ -4,9 +4,9 @@
  */
 
 #include "EmployeeManageDialog.h"
+#include "ReferenceCache.h"
 #include <commctrl.h>
 #include <windowsx.h>
-#include <unordered_map>
 #include <algorithm>
 
 EmployeeManageDialog::EmployeeManageDialog(Database& db)
@@ -239,11 +239,9 @@ void EmployeeManageDialog::LoadEmployees() {
 void EmployeeManageDialog::RefreshList() {
     ListView_DeleteAllItems(m_hList);
 
-    // 建立部门ID到名称的映射，避免重复查找
-    std::unordered_map<int, const std::string*> deptMap;
-    for (const auto& dept : m_departments) {
-        deptMap[dept.id] = &dept.name;
-    }
+    // 部门名称从字典缓存查找
+    ReferenceCache& refs = m_db.GetReferenceCache();
+    refs.Sync();
 
     // 批量获取所有员工的资产数量，避免 N+1 查询
     m_assetCounts = m_db.GetAllEmployeeAssetCounts();
@@ -261,12 +259,9 @@ void EmployeeManageDialog::RefreshList() {
         ListView_InsertItem(m_hList, &lvi);
 
         // 部门名称 - O(1) 查找
-        auto it = deptMap.find(m_employees[i].departmentId);
-        if (it != deptMap.end()) {
-            MultiByteToWideChar(65001, 0, it->second->c_str(), -1, buf, 256);
-        } else {
-            buf[0] = L'\0';
-        }
+        std::string_view deptName = refs.GetDepartmentName(m_employees[i].departmentId);
+        int len = MultiByteToWideChar(65001, 0, deptName.data(), (int)deptName.size(), buf, 255);
+        buf[len] = L'\0';
         ListView_SetItemText(m_hList, i, 1, buf);
 
         // 设备数量 - O(1) 查找
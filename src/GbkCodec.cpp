@@ -0,0 +1,244 @@
+/**
+ * @file GbkCodec.cpp
+ * @brief GBK（CP936）与 UTF-8 互转实现
+ */
+
+#include "GbkCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GBK_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// CP936 双字节码 -> Unicode，按 (首字节 - 0x81) * 190 + 尾字节序号 索引
+static const uint16_t kGbkToUnicode[126 * 190] = {
+#include "GbkTable.inc"
+};
+
+static const unsigned int kReplacement = 0xFFFD;
+
+// 尾字节序号：0x40-0x7E 为 0-62，0x80-0xFE 为 63-189，其余不是合法尾字节
+static inline int TrailIndex(unsigned char trail) {
+    if (trail >= 0x40 && trail <= 0x7E) return trail - 0x40;
+    if (trail >= 0x80 && trail <= 0xFE) return trail - 0x41;
+    return -1;
+}
+
+// Unicode（BMP）-> GBK 编码，首次使用时由解码表反推
+static const uint16_t* UnicodeToGbk() {
+    static const std::vector<uint16_t> table = [] {
+        std::vector<uint16_t> result(0x10000, 0);
+        for (int lead = 0; lead < 126; lead++) {
+            for (int trail = 0; trail < 190; trail++) {
+                uint16_t codePoint = kGbkToUnicode[lead * 190 + trail];
+                if (codePoint != 0 && result[codePoint] == 0) {
+                    int trailByte = trail < 63 ? trail + 0x40 : trail + 0x41;
+                    result[codePoint] = (uint16_t)(((lead + 0x81) << 8) | trailByte);
+                }
+            }
+        }
+        result[0x20AC] = 0x80;
+        return result;
+    }();
+    return table.data();
+}
+
+unsigned int GbkCodec::Decode(unsigned char lead, unsigned char trail) {
+    int index = TrailIndex(trail);
+    if (lead < 0x81 || lead > 0xFE || index < 0) {
+        return 0;
+    }
+    return kGbkToUnicode[(lead - 0x81) * 190 + index];
+}
+
+unsigned int GbkCodec::Encode(unsigned int codePoint) {
+    if (codePoint < 0x80) {
+        return codePoint;
+    }
+    return codePoint < 0x10000 ? UnicodeToGbk()[codePoint] : 0;
+}
+
+size_t GbkCodec::AsciiPrefix(const char* data, size_t size) {
+    size_t i = 0;
+#ifdef GBK_CODEC_SSE2
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        if (_mm_movemask_epi8(chunk) != 0) {
+            break;
+        }
+    }
+#else
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+    }
+#endif
+    // 剩余部分或含非 ASCII 的一组逐字节定位
+    for (; i < size; i++) {
+        if ((unsigned char)data[i] >= 0x80) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// ========== GBK -> UTF-8 ==========
+
+/**
+ * @brief 写入 0x80-0xFFFF 范围码位的 UTF-8 编码
+ */
+static inline char* PutUtf8(char* out, unsigned int codePoint) {
+    if (codePoint < 0x800) {
+        out[0] = (char)(0xC0 | (codePoint >> 6));
+        out[1] = (char)(0x80 | (codePoint & 0x3F));
+        return out + 2;
+    }
+    out[0] = (char)(0xE0 | (codePoint >> 12));
+    out[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (codePoint & 0x3F));
+    return out + 3;
+}
+
+size_t GbkCodec::ToUtf8(std::string_view gbk, std::string& utf8) {
+    const unsigned char* p = (const unsigned char*)gbk.data();
+    const unsigned char* end = p + gbk.size();
+    size_t start = utf8.size();
+    size_t replaced = 0;
+
+    // 双字节字符变为 3 字节，先按 1.5 倍预留；单字节替换为 U+FFFD 时可能不够，再按需扩大
+    utf8.resize(start + gbk.size() + gbk.size() / 2 + 4);
+    char* base = &utf8[0];
+    char* out = base + start;
+    char* limit = base + utf8.size();
+
+    auto reserve = [&](size_t bytes) {
+        if ((size_t)(limit - out) < bytes) {
+            size_t used = out - base;
+            utf8.resize(std::max(utf8.size() * 2, used + bytes));
+            base = &utf8[0];
+            out = base + used;
+            limit = base + utf8.size();
+        }
+    };
+
+    while (p < end) {
+        size_t ascii = AsciiPrefix((const char*)p, end - p);
+        if (ascii > 0) {
+            reserve(ascii);
+            std::memcpy(out, p, ascii);
+            out += ascii;
+            p += ascii;
+        }
+
+        // 非 ASCII 部分逐字符转换，直到下一个 ASCII 字节
+        while (p < end && *p >= 0x80) {
+            reserve(3);
+            unsigned int codePoint = 0;
+            size_t length = 1;
+            if (*p == 0x80) {
+                codePoint = 0x20AC;
+            } else if (*p != 0xFF && p + 1 < end) {
+                int index = TrailIndex(p[1]);
+                if (index >= 0) {
+                    codePoint = kGbkToUnicode[(*p - 0x81) * 190 + index];
+                    length = 2;
+                }
+            }
+            if (codePoint == 0) {
+                codePoint = kReplacement;
+                replaced++;
+            }
+            out = PutUtf8(out, codePoint);
+            p += length;
+        }
+    }
+
+    utf8.resize(out - base);
+    return replaced;
+}
+
+std::string GbkCodec::ToUtf8(std::string_view gbk) {
+    std::string utf8;
+    ToUtf8(gbk, utf8);
+    return utf8;
+}
+
+// ========== UTF-8 -> GBK ==========
+
+static inline bool IsContinuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+size_t GbkCodec::FromUtf8(std::string_view utf8, std::string& gbk) {
+    const unsigned char* p = (const unsigned char*)utf8.data();
+    const unsigned char* end = p + utf8.size();
+    size_t start = gbk.size();
+    size_t replaced = 0;
+    const uint16_t* table = UnicodeToGbk();
+
+    // 每个 UTF-8 序列至多产生同样多的字节，按输入长度预留即可
+    gbk.resize(start + utf8.size());
+    char* base = &gbk[0];
+    char* out = base + start;
+
+    while (p < end) {
+        size_t ascii = AsciiPrefix((const char*)p, end - p);
+        std::memcpy(out, p, ascii);
+        out += ascii;
+        p += ascii;
+
+        while (p < end && *p >= 0x80) {
+            unsigned char c = *p;
+            unsigned int codePoint = 0;
+            size_t length = 1;
+            if (c >= 0xC2 && c <= 0xDF && end - p >= 2 && IsContinuation(p[1])) {
+                codePoint = ((c & 0x1F) << 6) | (p[1] & 0x3F);
+                length = 2;
+            } else if (c >= 0xE0 && c <= 0xEF && end - p >= 3 && IsContinuation(p[1]) && IsContinuation(p[2])) {
+                codePoint = ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+                // 过长编码与代理区不是合法 UTF-8
+                if (codePoint >= 0x800 && (codePoint < 0xD800 || codePoint > 0xDFFF)) {
+                    length = 3;
+                } else {
+                    codePoint = 0;
+                }
+            } else if (c >= 0xF0 && c <= 0xF4 && end - p >= 4 && IsContinuation(p[1]) &&
+                       IsContinuation(p[2]) && IsContinuation(p[3])) {
+                unsigned int supplementary = ((c & 0x07) << 18) | ((p[1] & 0x3F) << 12) |
+                                             ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+                // 辅助平面字符合法但 GBK 中没有
+                if (supplementary >= 0x10000 && supplementary <= 0x10FFFF) {
+                    length = 4;
+                }
+            }
+
+            unsigned int code = codePoint ? table[codePoint] : 0;
+            if (code == 0) {
+                *out++ = '?';
+                replaced++;
+            } else if (code < 0x100) {
+                *out++ = (char)code;
+            } else {
+                *out++ = (char)(code >> 8);
+                *out++ = (char)(code & 0xFF);
+            }
+            p += length;
+        }
+    }
+
+    gbk.resize(out - base);
+    return replaced;
+}
+
+std::string GbkCodec::FromUtf8(std::string_view utf8) {
+    std::string gbk;
+    FromUtf8(utf8, gbk);
+    return gbk;
+}
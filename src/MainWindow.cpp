@@ -27,6 +27,14 @@ MainWindow::MainWindow()
     , m_hCategoryCombo(nullptr)
     , m_hStatusCombo(nullptr)
     , m_hStatusBar(nullptr)
+    , m_searchExecutor([this](AsyncSearchResult&& result) {
+        // 工作线程回调：转交 UI 线程处理，投递失败（窗口已销毁）时自行释放
+        AsyncSearchResult* payload = new AsyncSearchResult(std::move(result));
+        if (!m_hWnd || !PostMessage(m_hWnd, WM_APP_SEARCH_RESULT, 0, (LPARAM)payload)) {
+            delete payload;
+        }
+    })
+    , m_assetStore(m_db)
     , m_selectedAssetId(-1)
     , m_sortColumn(-1)
     , m_sortAscending(true)
@@ -95,8 +103,12 @@ bool MainWindow::Create(HINSTANCE hInstance) {
         return false;
     }
 
+    m_assetStore.Load();
     LoadData();
 
+    // 后台搜索使用独立的只读连接，启动失败时退回同步搜索
+    m_searchExecutor.Start(m_db.GetPath());
+
     ShowWindow(m_hWnd, SW_SHOW);
     UpdateWindow(m_hWnd);
 
@@ -109,6 +121,7 @@ void MainWindow::CreateMenus() {
     // 文件菜单
     HMENU hFileMenu = CreatePopupMenu();
     AppendMenuW(hFileMenu, MF_STRING, IDM_IMPORT_CSV, L"导入 CSV...");
+    AppendMenuW(hFileMenu, MF_STRING, IDM_VALIDATE_CSV, L"检查 CSV（不导入）...");
     AppendMenuW(hFileMenu, MF_STRING, IDM_EXPORT_CSV, L"导出 CSV...");
     AppendMenuW(hFileMenu, MF_STRING, IDM_DOWNLOAD_TEMPLATE, L"下载导入模板...");
     AppendMenuW(hFileMenu, MF_SEPARATOR, 0, nullptr);
@@ -284,11 +297,57 @@ void MainWindow::LoadData() {
     std::string status;
 
     GetSearchConditions(searchText, categoryId, status);
-    m_assets = m_db.SearchAssets(searchText, categoryId, status);
+
+    // 同步刷新优先，丢弃尚未返回的后台搜索结果
+    m_searchExecutor.Cancel();
+    if (searchText.empty() && m_assetStore.IsLoaded()) {
+        m_searchResults.clear();
+        m_assets = m_assetStore.Query(categoryId, status);
+    } else {
+        m_searchResults = m_db.SearchAssets(searchText, categoryId, status);
+        ShowSearchResults();
+    }
     RefreshListView();
     UpdateStatusBar();
 }
 
+void MainWindow::LoadDataAsync() {
+    if (!m_db.IsOpen()) {
+        return;
+    }
+
+    AssetFilter filter;
+    GetSearchConditions(filter.searchText, filter.categoryId, filter.status);
+
+    // 清空搜索框时内存数据即可满足，无需后台查询
+    if (filter.searchText.empty() && m_assetStore.IsLoaded()) {
+        LoadData();
+    } else if (m_searchExecutor.IsRunning()) {
+        m_searchExecutor.Submit(filter);
+    } else {
+        LoadData();
+    }
+}
+
+void MainWindow::OnSearchResult(AsyncSearchResult* result) {
+    // 投递期间又有新的搜索或同步刷新，结果已过期
+    if (m_searchExecutor.IsCurrent(result->generation)) {
+        m_searchResults = std::move(result->assets);
+        ShowSearchResults();
+        RefreshListView();
+        UpdateStatusBar();
+    }
+    delete result;
+}
+
+void MainWindow::ShowSearchResults() {
+    m_assets.clear();
+    m_assets.reserve(m_searchResults.size());
+    for (const auto& asset : m_searchResults) {
+        m_assets.push_back(&asset);
+    }
+}
+
 void MainWindow::RefreshListView() {
     // 禁用重绘，提升大量数据时的刷新性能
     SendMessage(m_hListView, WM_SETREDRAW, FALSE, 0);
@@ -297,7 +356,7 @@ void MainWindow::RefreshListView() {
 
     wchar_t buf[256];
     for (size_t i = 0; i < m_assets.size(); i++) {
-        const Asset& asset = m_assets[i];
+        const Asset& asset = *m_assets[i];
 
         LVITEMW lvi = {};
         lvi.mask = LVIF_TEXT;
@@ -381,10 +440,32 @@ void MainWindow::RefreshCategoryCombo() {
 }
 
 void MainWindow::UpdateStatusBar() {
+    std::string searchText;
+    int categoryId = -1;
+    std::string status;
+    GetSearchConditions(searchText, categoryId, status);
+
     int count = (int)m_assets.size();
     double total = 0.0;
-    for (const auto& asset : m_assets) {
-        total += asset.price;
+
+    // 无搜索文本且至多一个过滤条件时，总价值直接取自汇总表
+    AssetSummary summary;
+    if (searchText.empty() && (categoryId < 0 || status.empty()) && m_db.GetAssetSummary(summary)) {
+        if (categoryId >= 0) {
+            for (const auto& group : summary.byCategory) {
+                if (group.id == categoryId) total = group.totalPrice;
+            }
+        } else if (!status.empty()) {
+            for (const auto& group : summary.byStatus) {
+                if (group.name == status) total = group.totalPrice;
+            }
+        } else {
+            total = summary.totalPrice;
+        }
+    } else {
+        for (const Asset* asset : m_assets) {
+            total += asset->price;
+        }
     }
 
     wchar_t buf[256];
@@ -477,6 +558,10 @@ void MainWindow::OnImportCSV() {
     }
 }
 
+void MainWindow::OnValidateCSV() {
+    CSVHelper::ValidateCSV(m_hWnd, m_db);
+}
+
 void MainWindow::OnExportCSV() {
     CSVHelper::ExportToCSV(m_hWnd, m_db);
 }
@@ -575,7 +660,7 @@ LRESULT MainWindow::HandleMessage(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lP
                     if (pnmlv->uNewState & LVIS_SELECTED) {
                         int idx = pnmlv->iItem;
                         if (idx >= 0 && idx < (int)m_assets.size()) {
-                            m_selectedAssetId = m_assets[idx].id;
+                            m_selectedAssetId = m_assets[idx]->id;
                         }
                     }
                 } else if (pnmhdr->code == NM_DBLCLK) {
@@ -619,6 +704,10 @@ LRESULT MainWindow::HandleMessage(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lP
                     OnImportCSV();
                     break;
 
+                case IDM_VALIDATE_CSV:
+                    OnValidateCSV();
+                    break;
+
                 case IDM_EXPORT_CSV:
                     OnExportCSV();
                     break;
@@ -673,15 +762,22 @@ LRESULT MainWindow::HandleMessage(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lP
         case WM_TIMER:
             if (wParam == ID_TIMER_SEARCH) {
                 KillTimer(m_hWnd, ID_TIMER_SEARCH);
-                LoadData();
+                LoadDataAsync();
             }
             return 0;
 
+        case WM_APP_SEARCH_RESULT:
+            OnSearchResult((AsyncSearchResult*)lParam);
+            return 0;
+
         case WM_CLOSE:
             DestroyWindow(m_hWnd);
             return 0;
 
         case WM_DESTROY:
+            m_searchExecutor.Stop();
+            m_assets.clear();
+            m_assetStore.Unload();
             PostQuitMessage(0);
             return 0;
 
@@ -729,10 +825,10 @@ void MainWindow::SortAssets() {
         return;
     }
 
-    std::sort(m_assets.begin(), m_assets.end(), [this](const Asset& a, const Asset& b) {
+    std::sort(m_assets.begin(), m_assets.end(), [this](const Asset* a, const Asset* b) {
         // 根据排序方向选择比较的左右操作数
-        const Asset& left = m_sortAscending ? a : b;
-        const Asset& right = m_sortAscending ? b : a;
+        const Asset& left = m_sortAscending ? *a : *b;
+        const Asset& right = m_sortAscending ? *b : *a;
 
         switch (m_sortColumn) {
             case COL_ID:
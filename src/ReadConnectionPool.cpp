@@ -0,0 +1,115 @@
+/**
+ * @file ReadConnectionPool.cpp
+ * @brief 只读连接池实现
+ */
+
+#include "ReadConnectionPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+struct ReadPoolState {
+    std::vector<std::unique_ptr<Database>> connections;    // 全部连接（含借出的）
+    std::vector<Database*> idle;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool closing = false;
+};
+
+void ReadLease::Release() {
+    if (m_pool && m_db) {
+        std::unique_ptr<Database> closed;
+        {
+            std::lock_guard<std::mutex> lock(m_pool->mutex);
+            if (m_pool->closing) {
+                // 连接池已关闭：取出该连接，在锁外关闭
+                auto& connections = m_pool->connections;
+                auto it = std::find_if(connections.begin(), connections.end(),
+                                       [this](const std::unique_ptr<Database>& db) { return db.get() == m_db; });
+                if (it != connections.end()) {
+                    closed = std::move(*it);
+                    connections.erase(it);
+                }
+            } else {
+                m_pool->idle.push_back(m_db);
+            }
+        }
+        m_pool->available.notify_all();
+    }
+    m_pool.reset();
+    m_db = nullptr;
+}
+
+ReadConnectionPool::ReadConnectionPool() : m_size(0) {
+}
+
+ReadConnectionPool::~ReadConnectionPool() {
+    Close();
+}
+
+bool ReadConnectionPool::Open(const std::string& dbPath, int size) {
+    Close();
+
+    // 每次打开使用新的状态，上一次借出未还的连接归还到已关闭的旧状态
+    auto state = std::make_shared<ReadPoolState>();
+    for (int i = 0; i < size; i++) {
+        auto db = std::make_unique<Database>();
+        if (!db->OpenReadOnly(dbPath)) {
+            m_lastError = db->GetLastError();
+            return false;
+        }
+        state->idle.push_back(db.get());
+        state->connections.push_back(std::move(db));
+    }
+    m_state = std::move(state);
+    m_size = size;
+    return true;
+}
+
+void ReadConnectionPool::Close() {
+    if (!m_state) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<Database>> closed;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->closing = true;
+
+        // 只关闭空闲连接；借出的连接由租约归还时关闭，这里不等待
+        auto& connections = m_state->connections;
+        for (Database* db : m_state->idle) {
+            auto it = std::find_if(connections.begin(), connections.end(),
+                                   [db](const std::unique_ptr<Database>& conn) { return conn.get() == db; });
+            if (it != connections.end()) {
+                closed.push_back(std::move(*it));
+                connections.erase(it);
+            }
+        }
+        m_state->idle.clear();
+    }
+    // 状态保留到下次 Open 或析构，并发的 Acquire 仍可安全读取它并得到空租约
+    m_state->available.notify_all();
+    m_size = 0;
+}
+
+ReadLease ReadConnectionPool::Acquire() {
+    std::shared_ptr<ReadPoolState> state = m_state;
+    if (!state) {
+        return ReadLease();
+    }
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->available.wait(lock, [&state] {
+        return state->closing || state->connections.empty() || !state->idle.empty();
+    });
+
+    if (state->closing || state->idle.empty()) {
+        return ReadLease();
+    }
+
+    Database* db = state->idle.back();
+    state->idle.pop_back();
+    return ReadLease(std::move(state), db);
+}
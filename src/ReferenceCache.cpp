@@ -0,0 +1,279 @@
+/**
+ * @file ReferenceCache.cpp
+ * @brief 分类、部门、员工字典缓存实现
+ */
+
+#include "ReferenceCache.h"
+#include <algorithm>
+#include <cstring>
+
+// 待重读的行数超过该值时整表重载更快
+static const size_t kMaxIncrementalRows = 1024;
+
+ReferenceCache::ReferenceCache(Database& db)
+    : m_db(db)
+    , m_listening(false)
+    , m_dataVersion(-1)
+    , m_version(0)
+    , m_hasPending(false)
+    , m_needsReload(false)
+    , m_stats()
+{
+    // 只读连接不会收到 hook 通知，只能依赖 Sync 中的 data_version 检查
+    m_db.AddChangeListener(this);
+    m_listening = true;
+    Reload();
+}
+
+ReferenceCache::~ReferenceCache() {
+    if (m_listening) {
+        m_db.RemoveChangeListener(this);
+    }
+}
+
+void ReferenceCache::Sync() {
+    // 其他连接的提交不会触发本连接的 hook
+    if (m_db.GetDataVersion() != m_dataVersion) {
+        Reload();
+        return;
+    }
+    EnsureCurrent();
+}
+
+void ReferenceCache::Reload() {
+    m_dirtyCategories.clear();
+    m_dirtyDepartments.clear();
+    m_dirtyEmployees.clear();
+    m_hasPending = false;
+    m_needsReload = false;
+    m_dataVersion = m_db.GetDataVersion();
+
+    m_categoryNames.clear();
+    m_categoryIds.clear();
+    for (const Category& category : m_db.GetAllCategories()) {
+        PutCategory(category.id, category.name);
+    }
+
+    m_departmentNames.clear();
+    m_departmentIds.clear();
+    for (const Department& dept : m_db.GetAllDepartments()) {
+        PutDepartment(dept.id, dept.name);
+    }
+
+    m_employees.clear();
+    m_employeeIds.clear();
+    m_employeesByName.clear();
+    std::vector<Employee> employees = m_db.GetAllEmployees();
+    m_employees.reserve(employees.size());
+    m_employeeIds.reserve(employees.size());
+    m_employeesByName.reserve(employees.size());
+    for (const Employee& employee : employees) {
+        PutEmployee(employee);
+    }
+
+    m_stats.fullLoads++;
+    m_version++;
+}
+
+void ReferenceCache::ApplyPending() {
+    m_hasPending = false;
+    size_t dirty = m_dirtyCategories.size() + m_dirtyDepartments.size() + m_dirtyEmployees.size();
+    if (m_needsReload || dirty > kMaxIncrementalRows) {
+        Reload();
+        return;
+    }
+
+    // 先移除旧值再按 ID 重读：重命名、删除、新增统一处理
+    for (int id : m_dirtyCategories) {
+        RemoveCategory(id);
+        Category category;
+        if (m_db.GetCategoryById(id, category)) {
+            PutCategory(category.id, category.name);
+        }
+    }
+    for (int id : m_dirtyDepartments) {
+        RemoveDepartment(id);
+        Department dept;
+        if (m_db.GetDepartmentById(id, dept)) {
+            PutDepartment(dept.id, dept.name);
+        }
+    }
+    for (int id : m_dirtyEmployees) {
+        RemoveEmployee(id);
+        Employee employee;
+        if (m_db.GetEmployeeById(id, employee)) {
+            PutEmployee(employee);
+        }
+    }
+
+    m_stats.rowRefreshes += dirty;
+    m_dirtyCategories.clear();
+    m_dirtyDepartments.clear();
+    m_dirtyEmployees.clear();
+    m_version++;
+}
+
+// ========== 索引维护 ==========
+
+void ReferenceCache::PutCategory(int id, const std::string& name) {
+    m_categoryNames[id] = name;
+    m_categoryIds.emplace(name, id);
+}
+
+void ReferenceCache::RemoveCategory(int id) {
+    auto it = m_categoryNames.find(id);
+    if (it == m_categoryNames.end()) {
+        return;
+    }
+    auto byName = m_categoryIds.find(it->second);
+    if (byName != m_categoryIds.end() && byName->second == id) {
+        m_categoryIds.erase(byName);
+    }
+    m_categoryNames.erase(it);
+}
+
+void ReferenceCache::PutDepartment(int id, const std::string& name) {
+    m_departmentNames[id] = name;
+    m_departmentIds.emplace(name, id);
+}
+
+void ReferenceCache::RemoveDepartment(int id) {
+    auto it = m_departmentNames.find(id);
+    if (it == m_departmentNames.end()) {
+        return;
+    }
+    auto byName = m_departmentIds.find(it->second);
+    if (byName != m_departmentIds.end() && byName->second == id) {
+        m_departmentIds.erase(byName);
+    }
+    m_departmentNames.erase(it);
+}
+
+void ReferenceCache::PutEmployee(const Employee& employee) {
+    m_employees[employee.id] = employee;
+
+    std::vector<int>& ids = m_employeesByName[employee.name];
+    ids.insert(std::lower_bound(ids.begin(), ids.end(), employee.id), employee.id);
+
+    auto inserted = m_employeeIds.emplace(EmployeeKey{employee.name, employee.departmentId}, employee.id);
+    if (!inserted.second && employee.id < inserted.first->second) {
+        inserted.first->second = employee.id;
+    }
+}
+
+void ReferenceCache::RemoveEmployee(int id) {
+    auto it = m_employees.find(id);
+    if (it == m_employees.end()) {
+        return;
+    }
+    const Employee& employee = it->second;
+
+    auto byName = m_employeesByName.find(employee.name);
+    if (byName != m_employeesByName.end()) {
+        std::vector<int>& ids = byName->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+
+        // 该键指向被移除的员工时，改指向同名同部门的下一位
+        EmployeeKey key{employee.name, employee.departmentId};
+        auto byKey = m_employeeIds.find(key);
+        if (byKey != m_employeeIds.end() && byKey->second == id) {
+            m_employeeIds.erase(byKey);
+            for (int otherId : ids) {
+                auto other = m_employees.find(otherId);
+                if (other != m_employees.end() && other->second.departmentId == employee.departmentId) {
+                    m_employeeIds.emplace(std::move(key), otherId);
+                    break;
+                }
+            }
+        }
+
+        if (ids.empty()) {
+            m_employeesByName.erase(byName);
+        }
+    }
+    m_employees.erase(it);
+}
+
+// ========== 查找 ==========
+
+int ReferenceCache::FindCategoryId(const std::string& name) {
+    EnsureCurrent();
+    auto it = m_categoryIds.find(name);
+    return it != m_categoryIds.end() ? it->second : -1;
+}
+
+int ReferenceCache::FindDepartmentId(const std::string& name) {
+    EnsureCurrent();
+    auto it = m_departmentIds.find(name);
+    return it != m_departmentIds.end() ? it->second : -1;
+}
+
+int ReferenceCache::FindEmployeeId(const std::string& name, int departmentId) {
+    EnsureCurrent();
+    auto it = m_employeeIds.find(EmployeeKey{name, departmentId});
+    return it != m_employeeIds.end() ? it->second : -1;
+}
+
+std::vector<Employee> ReferenceCache::FindEmployeesByName(const std::string& name) {
+    EnsureCurrent();
+    std::vector<Employee> result;
+    auto it = m_employeesByName.find(name);
+    if (it != m_employeesByName.end()) {
+        result.reserve(it->second.size());
+        for (int id : it->second) {
+            auto employee = m_employees.find(id);
+            if (employee != m_employees.end()) {
+                result.push_back(employee->second);
+            }
+        }
+    }
+    return result;
+}
+
+std::string_view ReferenceCache::GetCategoryName(int id) {
+    EnsureCurrent();
+    auto it = m_categoryNames.find(id);
+    return it != m_categoryNames.end() ? std::string_view(it->second) : std::string_view();
+}
+
+std::string_view ReferenceCache::GetDepartmentName(int id) {
+    EnsureCurrent();
+    auto it = m_departmentNames.find(id);
+    return it != m_departmentNames.end() ? std::string_view(it->second) : std::string_view();
+}
+
+bool ReferenceCache::GetEmployee(int id, Employee& employee) {
+    EnsureCurrent();
+    auto it = m_employees.find(id);
+    if (it == m_employees.end()) {
+        return false;
+    }
+    employee = it->second;
+    return true;
+}
+
+// ========== 变更通知 ==========
+
+void ReferenceCache::OnRowChanged(int /*operation*/, const char* table, sqlite3_int64 rowid) {
+    if (m_needsReload) {
+        return;
+    }
+    std::unordered_set<int>* dirty = nullptr;
+    if (std::strcmp(table, "categories") == 0) {
+        dirty = &m_dirtyCategories;
+    } else if (std::strcmp(table, "departments") == 0) {
+        dirty = &m_dirtyDepartments;
+    } else if (std::strcmp(table, "employees") == 0) {
+        dirty = &m_dirtyEmployees;
+    } else {
+        return;
+    }
+    dirty->insert((int)rowid);
+    m_hasPending = true;
+}
+
+void ReferenceCache::OnRollback() {
+    // 已记录的变更可能被撤销，无法逐行区分
+    m_needsReload = true;
+    m_hasPending = true;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file SchemaMigrator.cpp
+ * @brief 数据库结构版本迁移实现
+ */
+
+#include "SchemaMigrator.h"
+
+void SchemaMigrator::Add(int version, const std::string& description,
+                         std::function<bool(sqlite3*, std::string&)> apply) {
+    m_migrations.push_back({version, description, std::move(apply)});
+}
+
+bool SchemaMigrator::Migrate(int* applied) {
+    if (applied) *applied = 0;
+
+    int current = GetVersion(m_db);
+    if (current < 0) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    // 快速路径：已是最新版本，不执行任何 DDL
+    int latest = LatestVersion();
+    if (current == latest) {
+        return true;
+    }
+    if (current > latest) {
+        m_lastError = "数据库版本 (" + std::to_string(current) +
+                      ") 高于程序支持的版本 (" + std::to_string(latest) + ")，请升级程序";
+        return false;
+    }
+
+    for (const SchemaMigration& migration : m_migrations) {
+        if (migration.version <= current) {
+            continue;
+        }
+        bool ran = false;
+        if (!Apply(migration, ran)) {
+            return false;
+        }
+        if (ran && applied) {
+            (*applied)++;
+        }
+    }
+    return true;
+}
+
+bool SchemaMigrator::Apply(const SchemaMigration& migration, bool& applied) {
+    applied = false;
+    std::string error;
+
+    // IMMEDIATE：先取得写锁，再确认版本，避免两个进程同时执行同一迁移
+    if (!Exec(m_db, "BEGIN IMMEDIATE;", error)) {
+        m_lastError = "迁移 " + std::to_string(migration.version) + " (" +
+                      migration.description + ") 失败: " + error;
+        return false;
+    }
+
+    bool ok = true;
+    int version = GetVersion(m_db);
+    if (version < 0) {
+        error = sqlite3_errmsg(m_db);
+        ok = false;
+    } else if (version < migration.version) {
+        ok = migration.apply(m_db, error);
+        if (ok) {
+            // PRAGMA 不支持参数绑定，版本号为程序内常量
+            std::string setVersion = "PRAGMA user_version = " + std::to_string(migration.version) + ";";
+            ok = Exec(m_db, setVersion.c_str(), error);
+        }
+        applied = ok;
+    }
+
+    if (ok) {
+        ok = Exec(m_db, "COMMIT;", error);
+    }
+
+    if (!ok) {
+        sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        applied = false;
+        m_lastError = "迁移 " + std::to_string(migration.version) + " (" +
+                      migration.description + ") 失败: " + error;
+        return false;
+    }
+    return true;
+}
+
+int SchemaMigrator::GetVersion(sqlite3* db) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK) {
+        return -1;
+    }
+    int version = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : -1;
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+bool SchemaMigrator::Exec(sqlite3* db, const char* sql, std::string& error) {
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        error = errMsg ? errMsg : sqlite3_errmsg(db);
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool SchemaMigrator::ObjectExists(sqlite3* db, const char* type, const char* name) {
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT 1 FROM sqlite_master WHERE type = ? AND name = ?;";
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, type, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, name, -1, SQLITE_STATIC);
+    bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return exists;
+}
+
+bool SchemaMigrator::ExecInBatches(sqlite3* db, const char* sql, const char* table,
+                                   sqlite3_int64 batchRows, std::string& error) {
+    // 表名来自程序内常量
+    std::string rangeSql = std::string("SELECT MIN(rowid), MAX(rowid) FROM ") + table + ";";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, rangeSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+    if (sqlite3_step(stmt) != SQLITE_ROW || sqlite3_column_type(stmt, 0) == SQLITE_NULL) {
+        // 空表无需回填
+        sqlite3_finalize(stmt);
+        return true;
+    }
+    sqlite3_int64 minRowid = sqlite3_column_int64(stmt, 0);
+    sqlite3_int64 maxRowid = sqlite3_column_int64(stmt, 1);
+    sqlite3_finalize(stmt);
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+
+    bool ok = true;
+    for (sqlite3_int64 low = minRowid - 1; low < maxRowid; low += batchRows) {
+        sqlite3_bind_int64(stmt, 1, low);
+        sqlite3_bind_int64(stmt, 2, low + batchRows);
+        int rc = sqlite3_step(stmt);
+        while (rc == SQLITE_ROW) {
+            rc = sqlite3_step(stmt);
+        }
+        if (rc != SQLITE_DONE) {
+            error = sqlite3_errmsg(db);
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return ok;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file StatementCache.cpp
+ * @brief 预编译语句缓存实现
+ */
+
+#include "StatementCache.h"
+#include <chrono>
+
+StatementCache::StatementCache(size_t capacity)
+    : m_db(nullptr)
+    , m_capacity(capacity)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_prepareMicros(0)
+{
+}
+
+StatementCache::~StatementCache() {
+    Clear();
+}
+
+void StatementCache::Attach(sqlite3* db) {
+    Clear();
+    m_db = db;
+}
+
+Statement StatementCache::Acquire(const char* sql) {
+    if (!m_db) {
+        return Statement();
+    }
+
+    auto it = m_index.find(std::string_view(sql));
+    if (it != m_index.end()) {
+        // 已缓存且未借出则直接复用；已借出（重入调用）则退化为一次性语句。
+        // 不能用 sqlite3_stmt_busy 判断：已绑定参数但尚未 step 的语句不算 busy
+        Entry& entry = *it->second;
+        if (!entry.inUse) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            entry.inUse = true;
+            m_hits++;
+            return Statement(entry.stmt, &entry.inUse);
+        }
+    }
+
+    m_misses++;
+    bool cacheable = it == m_index.end() && m_capacity > 0 &&
+                     (m_lru.size() < m_capacity || EvictOne());
+
+    if (m_prepareObserver) {
+        m_prepareObserver(sql);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    auto start = std::chrono::steady_clock::now();
+    int rc = sqlite3_prepare_v3(m_db, sql, -1, cacheable ? SQLITE_PREPARE_PERSISTENT : 0,
+                                &stmt, nullptr);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_prepareMicros += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+    if (rc != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return Statement();
+    }
+
+    if (cacheable) {
+        m_lru.push_front(Entry{sql, stmt, true});
+        Entry& entry = m_lru.front();
+        m_index.emplace(entry.sql, m_lru.begin());
+        return Statement(stmt, &entry.inUse);
+    }
+    return Statement(stmt, nullptr);
+}
+
+bool StatementCache::EvictOne() {
+    for (auto it = m_lru.end(); it != m_lru.begin();) {
+        --it;
+        if (!it->inUse) {
+            sqlite3_finalize(it->stmt);
+            m_index.erase(it->sql);
+            m_lru.erase(it);
+            m_evictions++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StatementCache::Clear() {
+    for (Entry& entry : m_lru) {
+        sqlite3_finalize(entry.stmt);
+    }
+    m_index.clear();
+    m_lru.clear();
+}
+
+StatementCacheStats StatementCache::GetStats() const {
+    StatementCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.prepareMicros = m_prepareMicros;
+    stats.size = m_lru.size();
+    return stats;
+}
+
+void StatementCache::ResetStats() {
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+    m_prepareMicros = 0;
+}
@@ -4,16 +4,22 @@
  */
 
 #include "database.h"
-#include <sstream>
-#include <iomanip>
+#include "SchemaMigrator.h"
+#include "ReferenceCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+// 批量插入时每条 INSERT 语句包含的行数（9 列 x 100 行 = 900 个参数，低于旧版 999 上限）
+static const int kAssetInsertBatchRows = 100;
 
 // 辅助函数：从 sqlite3_stmt 构建 Asset 对象
 static void BuildAssetFromStmt(sqlite3_stmt* stmt, Asset& asset) {
     asset.id = sqlite3_column_int(stmt, 0);
     asset.assetCode = (const char*)sqlite3_column_text(stmt, 1);
     asset.name = (const char*)sqlite3_column_text(stmt, 2);
-    asset.categoryId = sqlite3_column_int(stmt, 3);
-    asset.userId = sqlite3_column_int(stmt, 4);
+    asset.categoryId = sqlite3_column_type(stmt, 3) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 3);
+    asset.userId = sqlite3_column_type(stmt, 4) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 4);
     const char* purchaseDate = (const char*)sqlite3_column_text(stmt, 5);
     asset.purchaseDate = purchaseDate ? purchaseDate : "";
     asset.price = sqlite3_column_double(stmt, 6);
@@ -31,17 +37,74 @@ static void BuildAssetFromStmt(sqlite3_stmt* stmt, Asset& asset) {
     asset.departmentName = deptName ? deptName : "";
 }
 
-Database::Database() : m_db(nullptr) {
+// 辅助函数：从 sqlite3_stmt 构建 AssetChangeLog 对象
+static void BuildChangeLogFromStmt(sqlite3_stmt* stmt, AssetChangeLog& log) {
+    log.id = sqlite3_column_int(stmt, 0);
+    log.assetId = sqlite3_column_int(stmt, 1);
+    log.assetCode = (const char*)sqlite3_column_text(stmt, 2);
+    log.assetName = (const char*)sqlite3_column_text(stmt, 3);
+    log.fieldName = (const char*)sqlite3_column_text(stmt, 4);
+    const char* oldVal = (const char*)sqlite3_column_text(stmt, 5);
+    const char* newVal = (const char*)sqlite3_column_text(stmt, 6);
+    log.oldValue = oldVal ? oldVal : "";
+    log.newValue = newVal ? newVal : "";
+    log.changeTime = sqlite3_column_int64(stmt, 7);
+}
+
+// 辅助函数：读取文本列为视图，NULL 视为空串（或 fallback）
+static std::string_view ColumnView(sqlite3_stmt* stmt, int col, std::string_view fallback = std::string_view()) {
+    const char* text = (const char*)sqlite3_column_text(stmt, col);
+    if (!text) return fallback;
+    return std::string_view(text, (size_t)sqlite3_column_bytes(stmt, col));
+}
+
+// 辅助函数：从 firstParam 开始绑定资产的 9 个可写列
+// 使用 SQLITE_STATIC，调用方需保证 asset 在 sqlite3_step 结束前有效
+static void BindAssetColumns(sqlite3_stmt* stmt, int firstParam, const Asset& asset) {
+    sqlite3_bind_text(stmt, firstParam, asset.assetCode.c_str(), (int)asset.assetCode.size(), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, firstParam + 1, asset.name.c_str(), (int)asset.name.size(), SQLITE_STATIC);
+    if (asset.categoryId >= 0) {
+        sqlite3_bind_int(stmt, firstParam + 2, asset.categoryId);
+    } else {
+        sqlite3_bind_null(stmt, firstParam + 2);
+    }
+    if (asset.userId >= 0) {
+        sqlite3_bind_int(stmt, firstParam + 3, asset.userId);
+    } else {
+        sqlite3_bind_null(stmt, firstParam + 3);
+    }
+    sqlite3_bind_text(stmt, firstParam + 4, asset.purchaseDate.c_str(), (int)asset.purchaseDate.size(), SQLITE_STATIC);
+    sqlite3_bind_double(stmt, firstParam + 5, asset.price);
+    sqlite3_bind_text(stmt, firstParam + 6, asset.location.c_str(), (int)asset.location.size(), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, firstParam + 7, asset.status.c_str(), (int)asset.status.size(), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, firstParam + 8, asset.remark.c_str(), (int)asset.remark.size(), SQLITE_STATIC);
+}
+
+// 辅助函数：生成 rows 行的批量插入语句
+// ON CONFLICT 只跳过编号重复的行，其他约束失败仍按语句错误报告
+// RETURNING 带回实际插入行的 id 和编号
+static std::string BuildAssetInsertSql(int rows) {
+    std::string sql;
+    sql.reserve(200 + rows * 20);
+    sql = "INSERT INTO assets (asset_code, name, category_id, user_id, purchase_date, "
+          "price, location, status, remark) VALUES ";
+    for (int i = 0; i < rows; i++) {
+        if (i > 0) sql += ",";
+        sql += "(?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    }
+    sql += " ON CONFLICT(asset_code) DO NOTHING RETURNING id, asset_code;";
+    return sql;
+}
+
+Database::Database() : m_db(nullptr), m_readOnly(false), m_hasAssetFts(false), m_bulkLoadFromId(-1) {
 }
 
 Database::~Database() {
     Close();
 }
 
-bool Database::Initialize() {
-    const char* dbPath = "assets.db";
-
-    int rc = sqlite3_open(dbPath, &m_db);
+bool Database::Initialize(const std::string& dbPath) {
+    int rc = sqlite3_open(dbPath.c_str(), &m_db);
     if (rc != SQLITE_OK) {
         m_lastError = sqlite3_errmsg(m_db);
         sqlite3_close(m_db);
@@ -49,6 +112,13 @@ bool Database::Initialize() {
         return false;
     }
 
+    m_path = dbPath;
+    m_readOnly = false;
+    m_stmtCache.Attach(m_db);
+
+    // 读连接池与写连接并发访问时，等待锁而不是立即返回 SQLITE_BUSY
+    sqlite3_busy_timeout(m_db, 5000);
+
     // 启用外键约束
     char* errMsg = nullptr;
     rc = sqlite3_exec(m_db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, &errMsg);
@@ -63,7 +133,8 @@ bool Database::Initialize() {
     sqlite3_exec(m_db, "PRAGMA synchronous = NORMAL;", nullptr, nullptr, &errMsg);
     sqlite3_exec(m_db, "PRAGMA cache_size = 10000;", nullptr, nullptr, &errMsg);
 
-    if (!CreateTables()) {
+    // 按 user_version 执行尚未执行的结构迁移，已是最新版本时不执行 DDL
+    if (!MigrateSchema()) {
         return false;
     }
 
@@ -74,50 +145,60 @@ bool Database::Initialize() {
     return true;
 }
 
+bool Database::OpenReadOnly(const std::string& dbPath) {
+    // 只读连接由单个线程独占使用，无需连接级互斥
+    int rc = sqlite3_open_v2(dbPath.c_str(), &m_db,
+                             SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+    if (rc != SQLITE_OK) {
+        m_lastError = m_db ? sqlite3_errmsg(m_db) : "无法打开数据库";
+        sqlite3_close(m_db);
+        m_db = nullptr;
+        return false;
+    }
+
+    m_path = dbPath;
+    m_readOnly = true;
+    m_stmtCache.Attach(m_db);
+    sqlite3_busy_timeout(m_db, 5000);
+    sqlite3_exec(m_db, "PRAGMA cache_size = 10000;", nullptr, nullptr, nullptr);
+
+    // 表结构由写连接负责迁移，这里只探测全文索引是否存在
+    m_hasAssetFts = DetectSearchIndex();
+
+    return true;
+}
+
 void Database::Close() {
+    // 缓存在析构时注销监听，需在连接关闭前释放
+    m_referenceCache.reset();
     if (m_db) {
+        // 缓存的语句必须先 finalize，否则 sqlite3_close 返回 SQLITE_BUSY
+        m_stmtCache.Clear();
         sqlite3_close(m_db);
         m_db = nullptr;
     }
 }
 
-bool Database::CreateTables() {
-    char* errMsg = nullptr;
-    int rc;
+// ========== 结构迁移 ==========
+//
+// 每个迁移只执行一次，由 SchemaMigrator 包在事务中并写入 user_version。
+// 已发布的迁移不再修改，结构变更一律追加新的版本号。
+// user_version 为 0 的旧库可能已有部分表，因此早期迁移保持 IF NOT EXISTS 并在回填前检查。
 
-    // 创建分类表
-    const char* createCategoryTable = R"(
+// 迁移 1：基础表及索引
+static bool MigrateBaseTables(sqlite3* db, std::string& error) {
+    const char* createTables = R"(
         CREATE TABLE IF NOT EXISTS categories (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL UNIQUE
         );
-    )";
-
-    rc = sqlite3_exec(m_db, createCategoryTable, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        m_lastError = errMsg;
-        sqlite3_free(errMsg);
-        return false;
-    }
 
-    // 创建部门表
-    const char* createDepartmentTable = R"(
         CREATE TABLE IF NOT EXISTS departments (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL UNIQUE,
             created_at INTEGER DEFAULT (strftime('%s', 'now'))
         );
-    )";
-
-    rc = sqlite3_exec(m_db, createDepartmentTable, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        m_lastError = errMsg;
-        sqlite3_free(errMsg);
-        return false;
-    }
 
-    // 创建员工表
-    const char* createEmployeeTable = R"(
         CREATE TABLE IF NOT EXISTS employees (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL,
@@ -126,17 +207,7 @@ bool Database::CreateTables() {
             updated_at INTEGER DEFAULT (strftime('%s', 'now')),
             FOREIGN KEY (department_id) REFERENCES departments(id) ON DELETE SET NULL
         );
-    )";
-
-    rc = sqlite3_exec(m_db, createEmployeeTable, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        m_lastError = errMsg;
-        sqlite3_free(errMsg);
-        return false;
-    }
 
-    // 创建资产表
-    const char* createAssetTable = R"(
         CREATE TABLE IF NOT EXISTS assets (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             asset_code TEXT NOT NULL UNIQUE,
@@ -153,28 +224,295 @@ bool Database::CreateTables() {
             FOREIGN KEY (category_id) REFERENCES categories(id) ON DELETE SET NULL,
             FOREIGN KEY (user_id) REFERENCES employees(id) ON DELETE SET NULL
         );
+
+        CREATE TABLE IF NOT EXISTS asset_change_logs (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            asset_id INTEGER NOT NULL,
+            asset_code TEXT NOT NULL,
+            asset_name TEXT NOT NULL,
+            field_name TEXT NOT NULL,
+            old_value TEXT,
+            new_value TEXT,
+            change_time TEXT DEFAULT (datetime('now', 'localtime')),
+            FOREIGN KEY (asset_id) REFERENCES assets(id) ON DELETE CASCADE
+        );
+
+        CREATE INDEX IF NOT EXISTS idx_assets_category ON assets(category_id);
+        CREATE INDEX IF NOT EXISTS idx_assets_user ON assets(user_id);
+        CREATE INDEX IF NOT EXISTS idx_assets_status ON assets(status);
+
+        -- 分页排序索引：键集分页按 (排序键, rowid) 顺序读取，首屏无需全表排序
+        CREATE INDEX IF NOT EXISTS idx_assets_name ON assets(name);
+        CREATE INDEX IF NOT EXISTS idx_assets_price ON assets(price);
+        CREATE INDEX IF NOT EXISTS idx_assets_purchase_date ON assets(COALESCE(purchase_date, ''));
+        CREATE INDEX IF NOT EXISTS idx_assets_location ON assets(COALESCE(location, ''));
+
+        CREATE INDEX IF NOT EXISTS idx_changelog_asset ON asset_change_logs(asset_id);
+        CREATE INDEX IF NOT EXISTS idx_changelog_time ON asset_change_logs(change_time);
+    )";
+
+    return SchemaMigrator::Exec(db, createTables, error);
+}
+
+// 辅助函数：当前 SQLite 能否建资产全文检索索引（需要 FTS5 模块；trigram 分词自 3.34 起提供）
+static bool SearchIndexSupported(sqlite3* db) {
+    if (sqlite3_libversion_number() < 3034000) {
+        return false;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT 1 FROM pragma_module_list WHERE name = 'fts5';",
+                           -1, &stmt, nullptr) != SQLITE_OK) {
+        // 编译时去掉了内省 PRAGMA，退回检查编译选项
+        return sqlite3_compileoption_used("ENABLE_FTS5") != 0;
+    }
+    bool supported = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return supported;
+}
+
+// 迁移 2：资产全文检索索引
+// SQLite 未启用 FTS5 时跳过，搜索退化为 LIKE 扫描；之后由支持 FTS5 的程序打开时补建（见 MigrateSchema）
+static bool MigrateSearchIndex(sqlite3* db, std::string& error) {
+    // 旧版本已建好的索引不再回填
+    bool exists = SchemaMigrator::ObjectExists(db, "table", "assets_fts");
+
+    // 资产搜索影子索引：rowid 即 assets.id，trigram 分词支持中文任意子串匹配
+    const char* createSearchIndex = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS assets_fts USING fts5(
+            asset_code, name, remark, user_name,
+            tokenize = 'trigram'
+        );
     )";
 
-    rc = sqlite3_exec(m_db, createAssetTable, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        m_lastError = errMsg;
-        sqlite3_free(errMsg);
+    std::string createError;
+    if (!SchemaMigrator::Exec(db, createSearchIndex, createError)) {
+        if (createError.find("no such module") != std::string::npos ||
+            createError.find("tokenizer") != std::string::npos) {
+            return true;
+        }
+        error = createError;
         return false;
     }
 
-    // 创建索引
-    sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS idx_assets_category ON assets(category_id);", nullptr, nullptr, &errMsg);
-    sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS idx_assets_user ON assets(user_id);", nullptr, nullptr, &errMsg);
-    sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS idx_assets_status ON assets(status);", nullptr, nullptr, &errMsg);
+    if (!exists) {
+        // 先分批回填再合并段，最后才建同步触发器（事务内不会有并发写入）
+        const char* backfill = R"(
+            INSERT INTO assets_fts (rowid, asset_code, name, remark, user_name)
+            SELECT a.id, a.asset_code, a.name, COALESCE(a.remark, ''), COALESCE(e.name, '')
+            FROM assets a
+            LEFT JOIN employees e ON a.user_id = e.id
+            WHERE a.id > ?1 AND a.id <= ?2;
+        )";
+        if (!SchemaMigrator::ExecInBatches(db, backfill, "assets", 50000, error) ||
+            !SchemaMigrator::Exec(db, "INSERT INTO assets_fts (assets_fts) VALUES ('optimize');", error)) {
+            return false;
+        }
+    }
+
+    const char* createTriggers = R"(
+        CREATE TRIGGER IF NOT EXISTS trg_assets_fts_insert AFTER INSERT ON assets BEGIN
+            INSERT INTO assets_fts (rowid, asset_code, name, remark, user_name)
+            VALUES (new.id, new.asset_code, new.name, COALESCE(new.remark, ''),
+                    COALESCE((SELECT name FROM employees WHERE id = new.user_id), ''));
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_assets_fts_update
+        AFTER UPDATE OF asset_code, name, remark, user_id ON assets BEGIN
+            UPDATE assets_fts
+            SET asset_code = new.asset_code, name = new.name, remark = COALESCE(new.remark, ''),
+                user_name = COALESCE((SELECT name FROM employees WHERE id = new.user_id), '')
+            WHERE rowid = new.id;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_assets_fts_delete AFTER DELETE ON assets BEGIN
+            DELETE FROM assets_fts WHERE rowid = old.id;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_employees_fts_rename
+        AFTER UPDATE OF name ON employees BEGIN
+            UPDATE assets_fts SET user_name = new.name
+            WHERE rowid IN (SELECT id FROM assets WHERE user_id = new.id);
+        END;
+    )";
 
-    // 创建变更日志表
-    const char* createChangeLogTable = R"(
-        CREATE TABLE IF NOT EXISTS asset_change_logs (
+    return SchemaMigrator::Exec(db, createTriggers, error);
+}
+
+// 迁移 3：资产汇总表及维护触发器
+static bool MigrateAssetSummary(sqlite3* db, std::string& error) {
+    bool exists = SchemaMigrator::ObjectExists(db, "table", "asset_summary");
+
+    // 维度：1=状态（键为状态文本），2=分类，3=使用人所在部门（键为 ID，0 表示无）
+    // 部门由 employees 间接决定，员工调动或删除时整体迁移其名下资产
+    const char* createSummary = R"(
+        CREATE TABLE IF NOT EXISTS asset_summary (
+            dimension INTEGER NOT NULL,
+            group_key NOT NULL,
+            asset_count INTEGER NOT NULL DEFAULT 0,
+            total_price REAL NOT NULL DEFAULT 0,
+            PRIMARY KEY (dimension, group_key)
+        ) WITHOUT ROWID;
+
+        CREATE TRIGGER IF NOT EXISTS trg_assets_summary_insert AFTER INSERT ON assets BEGIN
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            VALUES (1, COALESCE(new.status, ''), 1, COALESCE(new.price, 0)),
+                   (2, COALESCE(new.category_id, 0), 1, COALESCE(new.price, 0)),
+                   (3, COALESCE((SELECT department_id FROM employees WHERE id = new.user_id), 0),
+                    1, COALESCE(new.price, 0))
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + 1, total_price = total_price + excluded.total_price;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_assets_summary_delete AFTER DELETE ON assets BEGIN
+            UPDATE asset_summary
+            SET asset_count = asset_count - 1, total_price = total_price - COALESCE(old.price, 0)
+            WHERE (dimension = 1 AND group_key = COALESCE(old.status, ''))
+               OR (dimension = 2 AND group_key = COALESCE(old.category_id, 0))
+               OR (dimension = 3 AND group_key =
+                   COALESCE((SELECT department_id FROM employees WHERE id = old.user_id), 0));
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_assets_summary_update
+        AFTER UPDATE OF status, category_id, user_id, price ON assets BEGIN
+            UPDATE asset_summary
+            SET asset_count = asset_count - 1, total_price = total_price - COALESCE(old.price, 0)
+            WHERE (dimension = 1 AND group_key = COALESCE(old.status, ''))
+               OR (dimension = 2 AND group_key = COALESCE(old.category_id, 0))
+               OR (dimension = 3 AND group_key =
+                   COALESCE((SELECT department_id FROM employees WHERE id = old.user_id), 0));
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            VALUES (1, COALESCE(new.status, ''), 1, COALESCE(new.price, 0)),
+                   (2, COALESCE(new.category_id, 0), 1, COALESCE(new.price, 0)),
+                   (3, COALESCE((SELECT department_id FROM employees WHERE id = new.user_id), 0),
+                    1, COALESCE(new.price, 0))
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + 1, total_price = total_price + excluded.total_price;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_employees_summary_move
+        AFTER UPDATE OF department_id ON employees
+        WHEN old.department_id IS NOT new.department_id BEGIN
+            UPDATE asset_summary
+            SET asset_count = asset_count - (SELECT COUNT(*) FROM assets WHERE user_id = new.id),
+                total_price = total_price -
+                    (SELECT COALESCE(SUM(price), 0) FROM assets WHERE user_id = new.id)
+            WHERE dimension = 3 AND group_key = COALESCE(old.department_id, 0);
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            SELECT 3, COALESCE(new.department_id, 0), COUNT(*), COALESCE(SUM(price), 0)
+            FROM assets WHERE user_id = new.id
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + excluded.asset_count,
+                total_price = total_price + excluded.total_price;
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS trg_employees_summary_delete
+        BEFORE DELETE ON employees
+        WHEN old.department_id IS NOT NULL BEGIN
+            UPDATE asset_summary
+            SET asset_count = asset_count - (SELECT COUNT(*) FROM assets WHERE user_id = old.id),
+                total_price = total_price -
+                    (SELECT COALESCE(SUM(price), 0) FROM assets WHERE user_id = old.id)
+            WHERE dimension = 3 AND group_key = old.department_id;
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            SELECT 3, 0, COUNT(*), COALESCE(SUM(price), 0)
+            FROM assets WHERE user_id = old.id
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + excluded.asset_count,
+                total_price = total_price + excluded.total_price;
+        END;
+    )";
+
+    // 一次性回填已有数据
+    const char* backfill = R"(
+        INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+        SELECT 1, COALESCE(status, ''), COUNT(*), COALESCE(SUM(price), 0)
+        FROM assets GROUP BY 2;
+
+        INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+        SELECT 2, COALESCE(category_id, 0), COUNT(*), COALESCE(SUM(price), 0)
+        FROM assets GROUP BY 2;
+
+        INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+        SELECT 3, COALESCE(e.department_id, 0), COUNT(*), COALESCE(SUM(a.price), 0)
+        FROM assets a LEFT JOIN employees e ON a.user_id = e.id GROUP BY 2;
+    )";
+
+    if (!SchemaMigrator::Exec(db, createSummary, error)) {
+        return false;
+    }
+    if (!exists && !SchemaMigrator::Exec(db, backfill, error)) {
+        return false;
+    }
+    return true;
+}
+
+// 迁移 4：资产字段变更由触发器写入变更日志
+// 与 UPDATE 在同一语句内完成，任何途径的修改（含批量更新、外键 SET NULL）都会留下记录
+static bool MigrateChangeLogTrigger(sqlite3* db, std::string& error) {
+    // 分类、使用人只在 ID 变化时才查名称；名称相同（如同名员工）不记录
+    const char* createTrigger = R"(
+        CREATE TRIGGER IF NOT EXISTS trg_assets_change_log
+        AFTER UPDATE OF asset_code, name, category_id, user_id, purchase_date,
+                        price, location, status, remark ON assets BEGIN
+            INSERT INTO asset_change_logs (asset_id, asset_code, asset_name, field_name, old_value, new_value)
+            SELECT new.id, new.asset_code, new.name, f.field_name, f.old_value, f.new_value
+            FROM (
+                SELECT 1 AS seq, '资产编号' AS field_name,
+                       old.asset_code AS old_value, new.asset_code AS new_value
+                UNION ALL
+                SELECT 2, '资产名称', old.name, new.name
+                UNION ALL
+                SELECT 3, '分类',
+                       COALESCE((SELECT name FROM categories WHERE id = old.category_id), ''),
+                       COALESCE((SELECT name FROM categories WHERE id = new.category_id), '')
+                WHERE old.category_id IS NOT new.category_id
+                UNION ALL
+                SELECT 4, '使用人',
+                       COALESCE((SELECT name FROM employees WHERE id = old.user_id), ''),
+                       COALESCE((SELECT name FROM employees WHERE id = new.user_id), '')
+                WHERE old.user_id IS NOT new.user_id
+                UNION ALL
+                SELECT 5, '购入日期', COALESCE(old.purchase_date, ''), COALESCE(new.purchase_date, '')
+                UNION ALL
+                SELECT 6, '价格', printf('%.2f', COALESCE(old.price, 0)), printf('%.2f', COALESCE(new.price, 0))
+                UNION ALL
+                SELECT 7, '存放位置', COALESCE(old.location, ''), COALESCE(new.location, '')
+                UNION ALL
+                SELECT 8, '状态', COALESCE(old.status, ''), COALESCE(new.status, '')
+                UNION ALL
+                SELECT 9, '备注', COALESCE(old.remark, ''), COALESCE(new.remark, '')
+            ) f
+            WHERE f.old_value <> f.new_value
+            ORDER BY f.seq;
+        END;
+    )";
+
+    return SchemaMigrator::Exec(db, createTrigger, error);
+}
+
+// 迁移 5：变更日志字典编码
+// asset_change_logs 改为同名视图：字段名存入字典表，日志行只保存整数字段 ID；
+// 资产编号、名称不再逐行保存，通过 asset_id 关联 assets 读取（日志随资产级联删除，关联总能命中），
+// 编号或名称本身的修改仍以“资产编号”“资产名称”日志保留旧值
+static bool MigrateCompactChangeLog(sqlite3* db, std::string& error) {
+    // 字段 ID 与 trg_assets_change_log 中的顺序一致
+    const char* createTables = R"(
+        CREATE TABLE asset_log_fields (
+            id INTEGER PRIMARY KEY,
+            name TEXT NOT NULL UNIQUE
+        );
+
+        INSERT INTO asset_log_fields (id, name) VALUES
+            (1, '资产编号'), (2, '资产名称'), (3, '分类'), (4, '使用人'), (5, '购入日期'),
+            (6, '价格'), (7, '存放位置'), (8, '状态'), (9, '备注');
+
+        INSERT OR IGNORE INTO asset_log_fields (name)
+        SELECT DISTINCT field_name FROM asset_change_logs;
+
+        CREATE TABLE asset_change_log_entries (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             asset_id INTEGER NOT NULL,
-            asset_code TEXT NOT NULL,
-            asset_name TEXT NOT NULL,
-            field_name TEXT NOT NULL,
+            field_id INTEGER NOT NULL,
             old_value TEXT,
             new_value TEXT,
             change_time TEXT DEFAULT (datetime('now', 'localtime')),
@@ -182,20 +520,312 @@ bool Database::CreateTables() {
         );
     )";
 
-    rc = sqlite3_exec(m_db, createChangeLogTable, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        m_lastError = errMsg;
-        sqlite3_free(errMsg);
+    // 按旧表 rowid 分批复制，保留原 id（AUTOINCREMENT 序列随之推进）
+    const char* copyEntries = R"(
+        INSERT INTO asset_change_log_entries
+            (id, asset_id, field_id, old_value, new_value, change_time)
+        SELECT l.id, l.asset_id, f.id, l.old_value, l.new_value, l.change_time
+        FROM asset_change_logs l
+        JOIN asset_log_fields f ON f.name = l.field_name
+        WHERE l.id > ?1 AND l.id <= ?2;
+    )";
+
+    // 数据复制完成后再建索引、视图和触发器
+    const char* finish = R"(
+        DROP TRIGGER IF EXISTS trg_assets_change_log;
+        DROP TABLE asset_change_logs;
+
+        CREATE INDEX idx_changelog_asset ON asset_change_log_entries(asset_id);
+        -- (change_time, id) 与列表排序一致；带上 asset_id、field_id，按时间扫描时筛选条件在索引内判断，只回表读取命中的行
+        CREATE INDEX idx_changelog_time ON asset_change_log_entries(change_time, id, asset_id, field_id);
+
+        -- 兼容视图：前 8 列与旧表一致，查询接口的 SQL 基本不变；
+        -- 追加的 field_id 供筛选使用，使条件只依赖日志行本身，先过滤再关联
+        CREATE VIEW asset_change_logs AS
+        SELECT l.id, l.asset_id, a.asset_code, a.name AS asset_name, f.name AS field_name,
+               l.old_value, l.new_value, l.change_time, l.field_id
+        FROM asset_change_log_entries l
+        LEFT JOIN assets a ON a.id = l.asset_id
+        LEFT JOIN asset_log_fields f ON f.id = l.field_id;
+
+        -- 经视图写入时 asset_code、asset_name 被忽略
+        CREATE TRIGGER trg_change_logs_insert
+        INSTEAD OF INSERT ON asset_change_logs BEGIN
+            INSERT INTO asset_log_fields (name) VALUES (new.field_name)
+            ON CONFLICT DO NOTHING;
+            INSERT INTO asset_change_log_entries
+                (asset_id, field_id, old_value, new_value, change_time)
+            VALUES (new.asset_id,
+                    (SELECT id FROM asset_log_fields WHERE name = new.field_name),
+                    new.old_value, new.new_value,
+                    COALESCE(new.change_time, datetime('now', 'localtime')));
+        END;
+
+        CREATE TRIGGER trg_assets_change_log
+        AFTER UPDATE OF asset_code, name, category_id, user_id, purchase_date,
+                        price, location, status, remark ON assets BEGIN
+            INSERT INTO asset_change_log_entries (asset_id, field_id, old_value, new_value)
+            SELECT new.id, f.field_id, f.old_value, f.new_value
+            FROM (
+                SELECT 1 AS field_id, old.asset_code AS old_value, new.asset_code AS new_value
+                UNION ALL
+                SELECT 2, old.name, new.name
+                UNION ALL
+                SELECT 3,
+                       COALESCE((SELECT name FROM categories WHERE id = old.category_id), ''),
+                       COALESCE((SELECT name FROM categories WHERE id = new.category_id), '')
+                WHERE old.category_id IS NOT new.category_id
+                UNION ALL
+                SELECT 4,
+                       COALESCE((SELECT name FROM employees WHERE id = old.user_id), ''),
+                       COALESCE((SELECT name FROM employees WHERE id = new.user_id), '')
+                WHERE old.user_id IS NOT new.user_id
+                UNION ALL
+                SELECT 5, COALESCE(old.purchase_date, ''), COALESCE(new.purchase_date, '')
+                UNION ALL
+                SELECT 6, printf('%.2f', COALESCE(old.price, 0)), printf('%.2f', COALESCE(new.price, 0))
+                UNION ALL
+                SELECT 7, COALESCE(old.location, ''), COALESCE(new.location, '')
+                UNION ALL
+                SELECT 8, COALESCE(old.status, ''), COALESCE(new.status, '')
+                UNION ALL
+                SELECT 9, COALESCE(old.remark, ''), COALESCE(new.remark, '')
+            ) f
+            WHERE f.old_value <> f.new_value
+            ORDER BY f.field_id;
+        END;
+    )";
+
+    return SchemaMigrator::Exec(db, createTables, error) &&
+           SchemaMigrator::ExecInBatches(db, copyEntries, "asset_change_logs", 50000, error) &&
+           SchemaMigrator::Exec(db, finish, error);
+}
+
+// 迁移 6：按资产的日志索引带上排序列，单个资产的日志按时间倒序分页时直接沿索引定位，
+// 无需取出该资产全部日志再排序
+static bool MigrateChangeLogAssetIndex(sqlite3* db, std::string& error) {
+    return SchemaMigrator::Exec(db, R"(
+        DROP INDEX IF EXISTS idx_changelog_asset;
+        CREATE INDEX idx_changelog_asset ON asset_change_log_entries(asset_id, change_time, id);
+    )", error);
+}
+
+// 迁移 7：变更时间改为整数 Unix 时间戳（秒）
+// 旧值是本地时间文本，按本地时间换算；时间范围查询和键集翻页直接比较整数。
+// SQLite 不能修改列类型（TEXT 亲和性会把整数再存成文本），按新表 + 分批复制 + 改名的方式重建；
+// 改名使用 legacy_alter_table，视图和 assets 上的日志触发器按名称引用日志表，无需重建
+static bool MigrateChangeLogEpochTime(sqlite3* db, std::string& error) {
+    const char* createTable = R"(
+        CREATE TABLE asset_change_log_entries_new (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            asset_id INTEGER NOT NULL,
+            field_id INTEGER NOT NULL,
+            old_value TEXT,
+            new_value TEXT,
+            change_time INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER)),
+            FOREIGN KEY (asset_id) REFERENCES assets(id) ON DELETE CASCADE
+        );
+    )";
+
+    // 'utc' 修饰符把本地时间文本换算为 UTC，'%s' 取 Unix 秒
+    const char* copyEntries = R"(
+        INSERT INTO asset_change_log_entries_new
+            (id, asset_id, field_id, old_value, new_value, change_time)
+        SELECT id, asset_id, field_id, old_value, new_value,
+               COALESCE(CAST(strftime('%s', change_time, 'utc') AS INTEGER), 0)
+        FROM asset_change_log_entries
+        WHERE id > ?1 AND id <= ?2;
+    )";
+
+    const char* swapTables = R"(
+        PRAGMA legacy_alter_table = ON;
+        DROP TABLE asset_change_log_entries;
+        ALTER TABLE asset_change_log_entries_new RENAME TO asset_change_log_entries;
+    )";
+
+    const char* finish = R"(
+        CREATE INDEX idx_changelog_asset ON asset_change_log_entries(asset_id, change_time, id);
+        CREATE INDEX idx_changelog_time ON asset_change_log_entries(change_time, id, asset_id, field_id);
+
+        DROP TRIGGER IF EXISTS trg_change_logs_insert;
+        CREATE TRIGGER trg_change_logs_insert
+        INSTEAD OF INSERT ON asset_change_logs BEGIN
+            INSERT INTO asset_log_fields (name) VALUES (new.field_name)
+            ON CONFLICT DO NOTHING;
+            INSERT INTO asset_change_log_entries
+                (asset_id, field_id, old_value, new_value, change_time)
+            VALUES (new.asset_id,
+                    (SELECT id FROM asset_log_fields WHERE name = new.field_name),
+                    new.old_value, new.new_value,
+                    COALESCE(new.change_time, CAST(strftime('%s', 'now') AS INTEGER)));
+        END;
+    )";
+
+    if (!SchemaMigrator::Exec(db, createTable, error) ||
+        !SchemaMigrator::ExecInBatches(db, copyEntries, "asset_change_log_entries", 50000, error)) {
+        return false;
+    }
+    bool swapped = SchemaMigrator::Exec(db, swapTables, error);
+    // 连接级设置，无论成败都恢复
+    sqlite3_exec(db, "PRAGMA legacy_alter_table = OFF;", nullptr, nullptr, nullptr);
+    return swapped && SchemaMigrator::Exec(db, finish, error);
+}
+
+// 迁移 8：资产编号序列
+// 每个前缀一行，next_value 为下一个可用数字；按现有资产编号初始化。
+// 前缀为编号去掉末尾数字的部分（rtrim 按字符集裁剪），插入或修改编号时由触发器推进序列，
+// 无论编号来自预留、手工录入还是导入，序列都不会落后于已有编号
+static bool MigrateAssetCodeSequences(sqlite3* db, std::string& error) {
+    return SchemaMigrator::Exec(db, R"(
+        CREATE TABLE sequences (
+            prefix TEXT PRIMARY KEY,
+            next_value INTEGER NOT NULL,
+            width INTEGER NOT NULL
+        ) WITHOUT ROWID;
+
+        INSERT INTO sequences (prefix, next_value, width)
+        SELECT prefix, MAX(CAST(substr(asset_code, length(prefix) + 1) AS INTEGER)) + 1,
+               MAX(length(asset_code) - length(prefix))
+        FROM (SELECT asset_code, rtrim(asset_code, '0123456789') AS prefix
+              FROM assets WHERE asset_code GLOB '*[0-9]')
+        GROUP BY prefix;
+
+        CREATE TRIGGER trg_assets_code_sequence_insert
+        AFTER INSERT ON assets WHEN new.asset_code GLOB '*[0-9]' BEGIN
+            INSERT INTO sequences (prefix, next_value, width)
+            VALUES (rtrim(new.asset_code, '0123456789'),
+                    CAST(substr(new.asset_code, length(rtrim(new.asset_code, '0123456789')) + 1) AS INTEGER) + 1,
+                    length(new.asset_code) - length(rtrim(new.asset_code, '0123456789')))
+            ON CONFLICT (prefix) DO UPDATE SET next_value = excluded.next_value
+            WHERE excluded.next_value > next_value;
+        END;
+
+        CREATE TRIGGER trg_assets_code_sequence_update
+        AFTER UPDATE OF asset_code ON assets WHEN new.asset_code GLOB '*[0-9]' BEGIN
+            INSERT INTO sequences (prefix, next_value, width)
+            VALUES (rtrim(new.asset_code, '0123456789'),
+                    CAST(substr(new.asset_code, length(rtrim(new.asset_code, '0123456789')) + 1) AS INTEGER) + 1,
+                    length(new.asset_code) - length(rtrim(new.asset_code, '0123456789')))
+            ON CONFLICT (prefix) DO UPDATE SET next_value = excluded.next_value
+            WHERE excluded.next_value > next_value;
+        END;
+    )", error);
+}
+
+// 批量导入期间暂停的逐行触发器：asset_bulk_load 有行时跳过，由 EndBulkLoad 按批补做
+// 只有 FTS5 可用时才有全文索引的插入触发器，迁移 9 与补建索引时共用
+static bool GuardSearchIndexInsertTrigger(sqlite3* db, std::string& error) {
+    return SchemaMigrator::Exec(db, R"(
+        DROP TRIGGER IF EXISTS trg_assets_fts_insert;
+
+        CREATE TRIGGER trg_assets_fts_insert AFTER INSERT ON assets
+        WHEN NOT EXISTS (SELECT 1 FROM asset_bulk_load) BEGIN
+            INSERT INTO assets_fts (rowid, asset_code, name, remark, user_name)
+            VALUES (new.id, new.asset_code, new.name, COALESCE(new.remark, ''),
+                    COALESCE((SELECT name FROM employees WHERE id = new.user_id), ''));
+        END;
+    )", error);
+}
+
+// 迁移 9：批量导入开关
+// 导入事务内向 asset_bulk_load 写一行，全文索引、汇总、序列的插入触发器随之停用，
+// 提交前删除该行，其他连接始终看不到它
+static bool MigrateBulkLoadGuard(sqlite3* db, std::string& error) {
+    if (!SchemaMigrator::Exec(db, R"(
+        CREATE TABLE asset_bulk_load (
+            id INTEGER PRIMARY KEY
+        );
+
+        DROP TRIGGER trg_assets_summary_insert;
+
+        CREATE TRIGGER trg_assets_summary_insert AFTER INSERT ON assets
+        WHEN NOT EXISTS (SELECT 1 FROM asset_bulk_load) BEGIN
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            VALUES (1, COALESCE(new.status, ''), 1, COALESCE(new.price, 0)),
+                   (2, COALESCE(new.category_id, 0), 1, COALESCE(new.price, 0)),
+                   (3, COALESCE((SELECT department_id FROM employees WHERE id = new.user_id), 0),
+                    1, COALESCE(new.price, 0))
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + 1, total_price = total_price + excluded.total_price;
+        END;
+
+        DROP TRIGGER trg_assets_code_sequence_insert;
+
+        CREATE TRIGGER trg_assets_code_sequence_insert
+        AFTER INSERT ON assets
+        WHEN new.asset_code GLOB '*[0-9]' AND NOT EXISTS (SELECT 1 FROM asset_bulk_load) BEGIN
+            INSERT INTO sequences (prefix, next_value, width)
+            VALUES (rtrim(new.asset_code, '0123456789'),
+                    CAST(substr(new.asset_code, length(rtrim(new.asset_code, '0123456789')) + 1) AS INTEGER) + 1,
+                    length(new.asset_code) - length(rtrim(new.asset_code, '0123456789')))
+            ON CONFLICT (prefix) DO UPDATE SET next_value = excluded.next_value
+            WHERE excluded.next_value > next_value;
+        END;
+    )", error)) {
+        return false;
+    }
+
+    return !SchemaMigrator::ObjectExists(db, "table", "assets_fts") ||
+           GuardSearchIndexInsertTrigger(db, error);
+}
+
+// 迁移 10：金额、状态排序索引
+// 两列可空，排序键与键集比较用 COALESCE，按表达式建索引才能沿索引翻页
+static bool MigrateNullableSortIndexes(sqlite3* db, std::string& error) {
+    return SchemaMigrator::Exec(db, R"(
+        DROP INDEX IF EXISTS idx_assets_price;
+        CREATE INDEX idx_assets_price ON assets(COALESCE(price, 0));
+        CREATE INDEX idx_assets_status_sort ON assets(COALESCE(status, ''));
+    )", error);
+}
+
+bool Database::MigrateSchema() {
+    SchemaMigrator migrator(m_db);
+    migrator.Add(1, "基础表", MigrateBaseTables);
+    migrator.Add(2, "资产全文检索索引", MigrateSearchIndex);
+    migrator.Add(3, "资产汇总表", MigrateAssetSummary);
+    migrator.Add(4, "资产变更日志触发器", MigrateChangeLogTrigger);
+    migrator.Add(5, "变更日志字典编码", MigrateCompactChangeLog);
+    migrator.Add(6, "变更日志按资产分页索引", MigrateChangeLogAssetIndex);
+    migrator.Add(7, "变更时间整数化", MigrateChangeLogEpochTime);
+    migrator.Add(8, "资产编号序列", MigrateAssetCodeSequences);
+    migrator.Add(9, "批量导入开关", MigrateBulkLoadGuard);
+    migrator.Add(10, "金额、状态排序索引", MigrateNullableSortIndexes);
+
+    if (!migrator.Migrate()) {
+        m_lastError = migrator.GetLastError();
         return false;
     }
 
-    // 创建变更日志索引
-    sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS idx_changelog_asset ON asset_change_logs(asset_id);", nullptr, nullptr, &errMsg);
-    sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS idx_changelog_time ON asset_change_logs(change_time);", nullptr, nullptr, &errMsg);
+    // 库由未启用 FTS5 的程序建立时迁移 2 没有建表，user_version 却已越过 2；
+    // 由支持 FTS5 的程序打开时补做一次，建表、回填和触发器在同一事务内完成。
+    // 先确认能建再开写事务，未启用 FTS5 时启动不占写锁
+    if (!DetectSearchIndex() && SearchIndexSupported(m_db)) {
+        std::string error;
+        if (!SchemaMigrator::Exec(m_db, "BEGIN IMMEDIATE;", error)) {
+            m_lastError = error;
+            return false;
+        }
+        if (!MigrateSearchIndex(m_db, error) ||
+            (SchemaMigrator::ObjectExists(m_db, "table", "assets_fts") &&
+             !GuardSearchIndexInsertTrigger(m_db, error)) ||
+            !SchemaMigrator::Exec(m_db, "COMMIT;", error)) {
+            m_lastError = "补建资产全文检索索引失败: " + error;
+            sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
 
+    m_hasAssetFts = DetectSearchIndex();
     return true;
 }
 
+bool Database::DetectSearchIndex() {
+    Statement stmt = m_stmtCache.Acquire(
+        "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'assets_fts';");
+    return stmt && sqlite3_step(stmt) == SQLITE_ROW;
+}
+
 bool Database::InitializeDefaultData() {
     // 不再创建默认分类和部门，由用户自行添加
     return true;
@@ -206,74 +836,63 @@ bool Database::InitializeDefaultData() {
 std::vector<Category> Database::GetAllCategories() {
     std::vector<Category> result;
     result.reserve(32);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     const char* sql = "SELECT id, name FROM categories ORDER BY name;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Category cat;
             cat.id = sqlite3_column_int(stmt, 0);
             cat.name = (const char*)sqlite3_column_text(stmt, 1);
             result.push_back(std::move(cat));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
 bool Database::GetCategoryById(int id, Category& category) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT id, name FROM categories WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             category.id = sqlite3_column_int(stmt, 0);
             category.name = (const char*)sqlite3_column_text(stmt, 1);
-            sqlite3_finalize(stmt);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     return false;
 }
 
 bool Database::GetCategoryByName(const std::string& name, Category& category) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT id, name FROM categories WHERE name = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             category.id = sqlite3_column_int(stmt, 0);
             category.name = (const char*)sqlite3_column_text(stmt, 1);
-            sqlite3_finalize(stmt);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     return false;
 }
 
 bool Database::AddCategory(Category& category) {
-    sqlite3_stmt* stmt;
     const char* sql = "INSERT INTO categories (name) VALUES (?);";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, category.name.c_str(), -1, SQLITE_TRANSIENT);
-        rc = sqlite3_step(stmt);
+        int rc = sqlite3_step(stmt);
         if (rc == SQLITE_DONE) {
             category.id = (int)sqlite3_last_insert_rowid(m_db);
         }
-        sqlite3_finalize(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -283,15 +902,13 @@ bool Database::AddCategory(Category& category) {
 }
 
 bool Database::UpdateCategory(const Category& category) {
-    sqlite3_stmt* stmt;
     const char* sql = "UPDATE categories SET name = ? WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, category.name.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_int(stmt, 2, category.id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -301,14 +918,12 @@ bool Database::UpdateCategory(const Category& category) {
 }
 
 bool Database::DeleteCategory(int id) {
-    sqlite3_stmt* stmt;
     const char* sql = "DELETE FROM categories WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -322,74 +937,63 @@ bool Database::DeleteCategory(int id) {
 std::vector<Department> Database::GetAllDepartments() {
     std::vector<Department> result;
     result.reserve(32);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     const char* sql = "SELECT id, name FROM departments ORDER BY name;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Department dept;
             dept.id = sqlite3_column_int(stmt, 0);
             dept.name = (const char*)sqlite3_column_text(stmt, 1);
             result.push_back(std::move(dept));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
 bool Database::GetDepartmentById(int id, Department& dept) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT id, name FROM departments WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             dept.id = sqlite3_column_int(stmt, 0);
             dept.name = (const char*)sqlite3_column_text(stmt, 1);
-            sqlite3_finalize(stmt);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     return false;
 }
 
 bool Database::GetDepartmentByName(const std::string& name, Department& dept) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT id, name FROM departments WHERE name = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             dept.id = sqlite3_column_int(stmt, 0);
             dept.name = (const char*)sqlite3_column_text(stmt, 1);
-            sqlite3_finalize(stmt);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     return false;
 }
 
 bool Database::AddDepartment(Department& dept) {
-    sqlite3_stmt* stmt;
     const char* sql = "INSERT INTO departments (name) VALUES (?);";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, dept.name.c_str(), -1, SQLITE_TRANSIENT);
-        rc = sqlite3_step(stmt);
+        int rc = sqlite3_step(stmt);
         if (rc == SQLITE_DONE) {
             dept.id = (int)sqlite3_last_insert_rowid(m_db);
         }
-        sqlite3_finalize(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -399,15 +1003,13 @@ bool Database::AddDepartment(Department& dept) {
 }
 
 bool Database::UpdateDepartment(const Department& dept) {
-    sqlite3_stmt* stmt;
     const char* sql = "UPDATE departments SET name = ? WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, dept.name.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_int(stmt, 2, dept.id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -417,17 +1019,15 @@ bool Database::UpdateDepartment(const Department& dept) {
 }
 
 int Database::GetDepartmentEmployeeCount(int deptId) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT COUNT(*) FROM employees WHERE department_id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
     int count = 0;
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, deptId);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             count = sqlite3_column_int(stmt, 0);
         }
-        sqlite3_finalize(stmt);
     }
 
     return count;
@@ -441,14 +1041,12 @@ bool Database::DeleteDepartment(int id) {
         return false;
     }
 
-    sqlite3_stmt* stmt;
     const char* sql = "DELETE FROM departments WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -462,8 +1060,6 @@ bool Database::DeleteDepartment(int id) {
 std::vector<Employee> Database::GetAllEmployees() {
     std::vector<Employee> result;
     result.reserve(64);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     const char* sql = R"(
         SELECT e.id, e.name, e.department_id
         FROM employees e
@@ -471,40 +1067,36 @@ std::vector<Employee> Database::GetAllEmployees() {
         ORDER BY e.name;
     )";
 
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Employee emp;
             emp.id = sqlite3_column_int(stmt, 0);
             emp.name = (const char*)sqlite3_column_text(stmt, 1);
-            emp.departmentId = sqlite3_column_int(stmt, 2);
+            emp.departmentId = sqlite3_column_type(stmt, 2) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 2);
             result.push_back(std::move(emp));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
 bool Database::GetEmployeeById(int id, Employee& emp) {
-    sqlite3_stmt* stmt;
     const char* sql = R"(
         SELECT id, name, department_id
         FROM employees WHERE id = ?;
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             emp.id = sqlite3_column_int(stmt, 0);
             emp.name = (const char*)sqlite3_column_text(stmt, 1);
-            emp.departmentId = sqlite3_column_int(stmt, 2);
-            sqlite3_finalize(stmt);
+            emp.departmentId = sqlite3_column_type(stmt, 2) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 2);
             return true;
         }
-        sqlite3_finalize(stmt);
     }
 
     return false;
@@ -513,47 +1105,47 @@ bool Database::GetEmployeeById(int id, Employee& emp) {
 std::vector<Employee> Database::GetEmployeesByName(const std::string& name) {
     std::vector<Employee> result;
     result.reserve(8);  // 同名员工通常较少
-    sqlite3_stmt* stmt;
     const char* sql = R"(
         SELECT e.id, e.name, e.department_id, d.name as dept_name
         FROM employees e
         LEFT JOIN departments d ON e.department_id = d.id
         WHERE e.name = ?;
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Employee emp;
             emp.id = sqlite3_column_int(stmt, 0);
             emp.name = (const char*)sqlite3_column_text(stmt, 1);
-            emp.departmentId = sqlite3_column_int(stmt, 2);
+            emp.departmentId = sqlite3_column_type(stmt, 2) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 2);
             result.push_back(std::move(emp));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
 bool Database::AddEmployee(Employee& employee) {
-    sqlite3_stmt* stmt;
     const char* sql = R"(
         INSERT INTO employees (name, department_id)
         VALUES (?, ?);
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, employee.name.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, employee.departmentId);
+        if (employee.departmentId >= 0) {
+            sqlite3_bind_int(stmt, 2, employee.departmentId);
+        } else {
+            sqlite3_bind_null(stmt, 2);
+        }
 
-        rc = sqlite3_step(stmt);
+        int rc = sqlite3_step(stmt);
         if (rc == SQLITE_DONE) {
             employee.id = (int)sqlite3_last_insert_rowid(m_db);
         }
-        sqlite3_finalize(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -563,22 +1155,24 @@ bool Database::AddEmployee(Employee& employee) {
 }
 
 bool Database::UpdateEmployee(const Employee& employee) {
-    sqlite3_stmt* stmt;
     const char* sql = R"(
         UPDATE employees
         SET name = ?, department_id = ?,
             updated_at = strftime('%s', 'now')
         WHERE id = ?;
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, employee.name.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, employee.departmentId);
+        if (employee.departmentId >= 0) {
+            sqlite3_bind_int(stmt, 2, employee.departmentId);
+        } else {
+            sqlite3_bind_null(stmt, 2);
+        }
         sqlite3_bind_int(stmt, 3, employee.id);
 
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -594,14 +1188,12 @@ bool Database::DeleteEmployee(int id) {
     }
 
     // 首先清空该员工名下的所有资产（将 user_id 设为 NULL，状态改为闲置）
-    sqlite3_stmt* stmt;
     const char* sqlUpdate = "UPDATE assets SET user_id = NULL, status = '闲置' WHERE user_id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sqlUpdate, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sqlUpdate);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         if (rc != SQLITE_DONE) {
             Rollback();
@@ -616,12 +1208,11 @@ bool Database::DeleteEmployee(int id) {
 
     // 然后删除员工记录
     const char* sqlDelete = "DELETE FROM employees WHERE id = ?;";
-    rc = sqlite3_prepare_v2(m_db, sqlDelete, -1, &stmt, nullptr);
+    stmt = m_stmtCache.Acquire(sqlDelete);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         if (rc == SQLITE_DONE) {
             Commit();
@@ -635,35 +1226,30 @@ bool Database::DeleteEmployee(int id) {
 }
 
 int Database::GetEmployeeAssetCount(int employeeId) {
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT COUNT(*) FROM assets WHERE user_id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, employeeId);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             int count = sqlite3_column_int(stmt, 0);
-            sqlite3_finalize(stmt);
             return count;
         }
-        sqlite3_finalize(stmt);
     }
     return 0;
 }
 
 std::unordered_map<int, int> Database::GetAllEmployeeAssetCounts() {
     std::unordered_map<int, int> result;
-    sqlite3_stmt* stmt;
     const char* sql = "SELECT user_id, COUNT(*) FROM assets WHERE user_id IS NOT NULL GROUP BY user_id;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             int userId = sqlite3_column_int(stmt, 0);
             int count = sqlite3_column_int(stmt, 1);
             result[userId] = count;
         }
-        sqlite3_finalize(stmt);
     }
     return result;
 }
@@ -671,8 +1257,6 @@ std::unordered_map<int, int> Database::GetAllEmployeeAssetCounts() {
 std::vector<Employee> Database::SearchEmployees(const std::string& searchText, int departmentId) {
     std::vector<Employee> result;
     result.reserve(64);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     std::string sql = "SELECT id, name, department_id FROM employees WHERE 1=1";
 
     if (!searchText.empty()) {
@@ -683,8 +1267,8 @@ std::vector<Employee> Database::SearchEmployees(const std::string& searchText, i
     }
     sql += " ORDER BY name;";
 
-    int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
         m_lastError = sqlite3_errmsg(m_db);
         return result;
     }
@@ -706,7 +1290,6 @@ std::vector<Employee> Database::SearchEmployees(const std::string& searchText, i
         result.push_back(std::move(emp));
     }
 
-    sqlite3_finalize(stmt);
     return result;
 }
 
@@ -720,8 +1303,6 @@ std::vector<Asset> Database::SearchAssets(const std::string& searchText,
                                            int categoryId, const std::string& status) {
     std::vector<Asset> result;
     result.reserve(128);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     std::string sql = R"(
         SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
                a.purchase_date, a.price, a.location, a.status, a.remark,
@@ -733,129 +1314,436 @@ std::vector<Asset> Database::SearchAssets(const std::string& searchText,
         WHERE 1=1
     )";
 
-    if (!searchText.empty()) {
-        sql += " AND (a.asset_code LIKE ? OR a.name LIKE ? OR e.name LIKE ? OR a.remark LIKE ?)";
-    }
-    if (categoryId >= 0) {
-        sql += " AND a.category_id = ?";
-    }
-    if (!status.empty()) {
-        sql += " AND a.status = ?";
-    }
+    sql += BuildAssetFilterSql(searchText, categoryId, status);
     sql += " ORDER BY a.id DESC;";
 
-    std::string searchPattern = "%" + searchText + "%";
-    int paramIdx = 1;
-    int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
-        if (!searchText.empty()) {
-            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-        }
-        if (categoryId >= 0) {
-            sqlite3_bind_int(stmt, paramIdx++, categoryId);
-        }
-        if (!status.empty()) {
-            sqlite3_bind_text(stmt, paramIdx++, status.c_str(), -1, SQLITE_TRANSIENT);
-        }
+    if (stmt) {
+        BindAssetFilter(stmt, 1, searchText, categoryId, status);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Asset asset;
             BuildAssetFromStmt(stmt, asset);
             result.push_back(std::move(asset));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
-bool Database::GetAssetById(int id, Asset& asset) {
-    sqlite3_stmt* stmt;
-    const char* sql = R"(
-        SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
-               a.purchase_date, a.price, a.location, a.status, a.remark,
-               c.name as cat_name, e.name as user_name, d.name as dept_name
-        FROM assets a
-        LEFT JOIN categories c ON a.category_id = c.id
-        LEFT JOIN employees e ON a.user_id = e.id
-        LEFT JOIN departments d ON e.department_id = d.id
-        WHERE a.id = ?;
-    )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+// 辅助函数：排序字段对应的 SQL 表达式，可空列用 COALESCE 保证键集比较不遇到 NULL
+static const char* AssetSortExpr(AssetSortField field) {
+    switch (field) {
+        case AssetSortField::Code:          return "a.asset_code";
+        case AssetSortField::Name:          return "a.name";
+        case AssetSortField::Category:      return "COALESCE(c.name, '')";
+        case AssetSortField::User:          return "COALESCE(e.name, '')";
+        case AssetSortField::PurchaseDate:  return "COALESCE(a.purchase_date, '')";
+        case AssetSortField::Price:         return "COALESCE(a.price, 0)";
+        case AssetSortField::Location:      return "COALESCE(a.location, '')";
+        case AssetSortField::Status:        return "COALESCE(a.status, '')";
+        case AssetSortField::Remark:        return "COALESCE(a.remark, '')";
+        case AssetSortField::Id:
+        default:                            return "a.id";
+    }
+}
 
-    if (rc == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, id);
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            BuildAssetFromStmt(stmt, asset);
-            sqlite3_finalize(stmt);
-            return true;
-        }
-        sqlite3_finalize(stmt);
+// 辅助函数：实际使用的排序字段
+// 按状态筛选时状态排序键恒定，改按 id 排序，免得在筛选索引之外再建临时 B 树
+static AssetSortField EffectiveSortField(const AssetFilter& filter) {
+    if (filter.sortField == AssetSortField::Status && !filter.status.empty()) {
+        return AssetSortField::Id;
     }
+    return filter.sortField;
+}
 
-    return false;
+// 辅助函数：由当前行生成分页位置
+// 排序键直接读查询输出的 AssetSortExpr 列（keyColumn），与键集比较的表达式一致；
+// 不从 Asset 取值，Asset 中 NULL 状态已换成默认值
+static AssetPageKey MakeAssetPageKey(sqlite3_stmt* stmt, int keyColumn, AssetSortField field) {
+    AssetPageKey key;
+    key.valid = true;
+    key.id = sqlite3_column_int(stmt, 0);
+    if (field == AssetSortField::Id) {
+        key.number = key.id;
+    } else if (field == AssetSortField::Price) {
+        key.number = sqlite3_column_double(stmt, keyColumn);
+    } else {
+        const char* text = (const char*)sqlite3_column_text(stmt, keyColumn);
+        key.text.assign(text ? text : "", (size_t)sqlite3_column_bytes(stmt, keyColumn));
+    }
+    return key;
 }
 
-bool Database::GetAssetByCode(const std::string& code, Asset& asset) {
-    sqlite3_stmt* stmt;
-    // 直接查询完整资产信息，避免二次查询
-    const char* sql = R"(
+std::vector<Asset> Database::SearchAssetsPage(const AssetFilter& filter, const AssetPageKey& afterKey,
+                                              int pageSize, AssetPageKey* nextKey) {
+    std::vector<Asset> result;
+    if (pageSize <= 0) {
+        return result;
+    }
+    result.reserve(pageSize);
+
+    AssetSortField sortField = EffectiveSortField(filter);
+    const char* sortExpr = AssetSortExpr(sortField);
+    const char* direction = filter.ascending ? "ASC" : "DESC";
+    const char* compare = filter.ascending ? ">" : "<";
+    bool sortById = (sortField == AssetSortField::Id);
+
+    // 第 13 列为排序键，用于生成下一页的位置
+    std::string sql = R"(
         SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
                a.purchase_date, a.price, a.location, a.status, a.remark,
-               c.name as cat_name, e.name as user_name, d.name as dept_name
+               c.name as cat_name, e.name as user_name, d.name as dept_name, )";
+    sql += sortExpr;
+    sql += R"( AS sort_key
         FROM assets a
         LEFT JOIN categories c ON a.category_id = c.id
         LEFT JOIN employees e ON a.user_id = e.id
         LEFT JOIN departments d ON e.department_id = d.id
-        WHERE a.asset_code = ?;
+        WHERE 1=1
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
 
-    if (rc == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, code.c_str(), -1, SQLITE_TRANSIENT);
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            BuildAssetFromStmt(stmt, asset);
-            sqlite3_finalize(stmt);
-            return true;
+    sql += BuildAssetFilterSql(filter.searchText, filter.categoryId, filter.status);
+
+    // 键集定位：(排序键, id) 严格位于上一页末行之后。
+    // 不用行值比较 (键, id) < (?, ?)：排序键为 COALESCE 表达式时它走不了索引范围查找
+    if (afterKey.valid) {
+        if (sortById) {
+            sql += std::string(" AND a.id ") + compare + " ?";
+        } else {
+            sql += std::string(" AND ") + sortExpr + " " + compare + "= ?";
+            sql += std::string(" AND (") + sortExpr + " " + compare + " ? OR a.id " + compare + " ?)";
         }
-        sqlite3_finalize(stmt);
     }
 
-    return false;
-}
+    sql += " ORDER BY ";
+    if (!sortById) {
+        sql += std::string(sortExpr) + " " + direction + ", ";
+    }
+    sql += std::string("a.id ") + direction + " LIMIT ?;";
 
-bool Database::GetLastAsset(Asset& asset) {
-    sqlite3_stmt* stmt;
-    const char* sql = "SELECT id, asset_code FROM assets ORDER BY id DESC LIMIT 1;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return result;
+    }
 
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            asset.id = sqlite3_column_int(stmt, 0);
-            asset.assetCode = (const char*)sqlite3_column_text(stmt, 1);
-            sqlite3_finalize(stmt);
-            return true;
+    int paramIdx = BindAssetFilter(stmt, 1, filter.searchText, filter.categoryId, filter.status);
+    if (afterKey.valid) {
+        // 排序键绑定两次（>= 与 >），再绑定 id
+        for (int i = 0; !sortById && i < 2; i++) {
+            if (sortField == AssetSortField::Price) {
+                sqlite3_bind_double(stmt, paramIdx++, afterKey.number);
+            } else {
+                sqlite3_bind_text(stmt, paramIdx++, afterKey.text.c_str(), (int)afterKey.text.size(), SQLITE_TRANSIENT);
+            }
         }
-        sqlite3_finalize(stmt);
+        sqlite3_bind_int(stmt, paramIdx++, afterKey.id);
     }
+    sqlite3_bind_int(stmt, paramIdx++, pageSize);
 
-    return false;
+    if (nextKey) {
+        *nextKey = afterKey;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Asset asset;
+        BuildAssetFromStmt(stmt, asset);
+        result.push_back(std::move(asset));
+        if (nextKey) {
+            // 语句结束后不能再读列，逐行更新为当前行
+            *nextKey = MakeAssetPageKey(stmt, 13, sortField);
+        }
+    }
+
+    return result;
 }
 
-bool Database::AddAsset(Asset& asset) {
-    sqlite3_stmt* stmt;
-    const char* sql = R"(
-        INSERT INTO assets (asset_code, name, category_id, user_id, purchase_date,
-                           price, location, status, remark)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
-    )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+// 统计 UTF-8 字符数（跳过续字节）
+static size_t Utf8Length(const std::string& text) {
+    size_t count = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
+
+// 辅助函数：把搜索词整体作为一个 FTS5 短语，双引号转义后按子串匹配
+static std::string BuildFtsPhrase(const std::string& searchText) {
+    std::string phrase;
+    phrase.reserve(searchText.size() + 2);
+    phrase.push_back('"');
+    for (char c : searchText) {
+        if (c == '"') phrase.push_back('"');
+        phrase.push_back(c);
+    }
+    phrase.push_back('"');
+    return phrase;
+}
+
+bool Database::UseAssetFtsMatch(const std::string& searchText) const {
+    // trigram 索引只能加速 3 个字符及以上的查询
+    return m_hasAssetFts && Utf8Length(searchText) >= 3;
+}
+
+std::string Database::BuildAssetFilterSql(const std::string& searchText,
+                                          int categoryId, const std::string& status) const {
+    std::string sql;
+    if (!searchText.empty()) {
+        if (UseAssetFtsMatch(searchText)) {
+            sql += " AND a.id IN (SELECT rowid FROM assets_fts WHERE assets_fts MATCH ?)";
+        } else if (m_hasAssetFts) {
+            // 短查询无法走 trigram 索引，扫描索引表本身，免去与员工表的连接
+            sql += " AND a.id IN (SELECT rowid FROM assets_fts"
+                   " WHERE asset_code LIKE ? OR name LIKE ? OR remark LIKE ? OR user_name LIKE ?)";
+        } else {
+            sql += " AND (a.asset_code LIKE ? OR a.name LIKE ? OR e.name LIKE ? OR a.remark LIKE ?)";
+        }
+    }
+    if (categoryId >= 0) {
+        sql += " AND a.category_id = ?";
+    }
+    if (!status.empty()) {
+        sql += " AND a.status = ?";
+    }
+    return sql;
+}
+
+int Database::BindAssetFilter(sqlite3_stmt* stmt, int paramIdx, const std::string& searchText,
+                              int categoryId, const std::string& status) const {
+    if (!searchText.empty()) {
+        if (UseAssetFtsMatch(searchText)) {
+            std::string phrase = BuildFtsPhrase(searchText);
+            sqlite3_bind_text(stmt, paramIdx++, phrase.c_str(), (int)phrase.size(), SQLITE_TRANSIENT);
+        } else {
+            std::string searchPattern = "%" + searchText + "%";
+            for (int i = 0; i < 4; i++) {
+                sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+            }
+        }
+    }
+    if (categoryId >= 0) {
+        sqlite3_bind_int(stmt, paramIdx++, categoryId);
+    }
+    if (!status.empty()) {
+        sqlite3_bind_text(stmt, paramIdx++, status.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    return paramIdx;
+}
+
+bool Database::ForEachAsset(const AssetFilter& filter,
+                            const std::function<bool(const AssetRowView&)>& visitor) {
+    AssetSortField sortField = EffectiveSortField(filter);
+    const char* sortExpr = AssetSortExpr(sortField);
+    const char* direction = filter.ascending ? "ASC" : "DESC";
+
+    std::string sql = R"(
+        SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
+               a.purchase_date, a.price, a.location, a.status, a.remark,
+               c.name as cat_name, e.name as user_name, d.name as dept_name
+        FROM assets a
+        LEFT JOIN categories c ON a.category_id = c.id
+        LEFT JOIN employees e ON a.user_id = e.id
+        LEFT JOIN departments d ON e.department_id = d.id
+        WHERE 1=1
+    )";
+
+    sql += BuildAssetFilterSql(filter.searchText, filter.categoryId, filter.status);
+    sql += " ORDER BY ";
+    if (sortField != AssetSortField::Id) {
+        sql += std::string(sortExpr) + " " + direction + ", ";
+    }
+    sql += std::string("a.id ") + direction + ";";
+
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    BindAssetFilter(stmt, 1, filter.searchText, filter.categoryId, filter.status);
+
+    AssetRowView row;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        row.id = sqlite3_column_int(stmt, 0);
+        row.assetCode = ColumnView(stmt, 1);
+        row.name = ColumnView(stmt, 2);
+        row.categoryId = sqlite3_column_type(stmt, 3) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 3);
+        row.userId = sqlite3_column_type(stmt, 4) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 4);
+        row.purchaseDate = ColumnView(stmt, 5);
+        row.price = sqlite3_column_double(stmt, 6);
+        row.location = ColumnView(stmt, 7);
+        row.status = ColumnView(stmt, 8, "在用");
+        row.remark = ColumnView(stmt, 9);
+        row.categoryName = ColumnView(stmt, 10);
+        row.userName = ColumnView(stmt, 11);
+        row.departmentName = ColumnView(stmt, 12);
+        if (!visitor(row)) {
+            return true;
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+    return true;
+}
+
+bool Database::GetAssetById(int id, Asset& asset) {
+    const char* sql = R"(
+        SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
+               a.purchase_date, a.price, a.location, a.status, a.remark,
+               c.name as cat_name, e.name as user_name, d.name as dept_name
+        FROM assets a
+        LEFT JOIN categories c ON a.category_id = c.id
+        LEFT JOIN employees e ON a.user_id = e.id
+        LEFT JOIN departments d ON e.department_id = d.id
+        WHERE a.id = ?;
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
+
+    if (stmt) {
+        sqlite3_bind_int(stmt, 1, id);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            BuildAssetFromStmt(stmt, asset);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Database::GetAssetByCode(const std::string& code, Asset& asset) {
+    // 直接查询完整资产信息，避免二次查询
+    const char* sql = R"(
+        SELECT a.id, a.asset_code, a.name, a.category_id, a.user_id,
+               a.purchase_date, a.price, a.location, a.status, a.remark,
+               c.name as cat_name, e.name as user_name, d.name as dept_name
+        FROM assets a
+        LEFT JOIN categories c ON a.category_id = c.id
+        LEFT JOIN employees e ON a.user_id = e.id
+        LEFT JOIN departments d ON e.department_id = d.id
+        WHERE a.asset_code = ?;
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
+
+    if (stmt) {
+        sqlite3_bind_text(stmt, 1, code.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            BuildAssetFromStmt(stmt, asset);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Database::HasAssetCode(std::string_view code) {
+    Statement stmt = m_stmtCache.Acquire("SELECT 1 FROM assets WHERE asset_code = ?;");
+    if (!stmt) {
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, code.data(), (int)code.size(), SQLITE_STATIC);
+    return sqlite3_step(stmt) == SQLITE_ROW;
+}
+
+bool Database::GetLastAsset(Asset& asset) {
+    const char* sql = "SELECT id, asset_code FROM assets ORDER BY id DESC LIMIT 1;";
+    Statement stmt = m_stmtCache.Acquire(sql);
+
+    if (stmt) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            asset.id = sqlite3_column_int(stmt, 0);
+            asset.assetCode = (const char*)sqlite3_column_text(stmt, 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string AssetCodeBlock::At(int index) const {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%0*lld", width, first + index);
+    return prefix + digits;
+}
+
+bool Database::ReserveAssetCodes(const std::string& prefix, int count, AssetCodeBlock& block) {
+    if (count <= 0) {
+        m_lastError = "预留数量必须大于 0";
+        return false;
+    }
+
+    // 推进序列与读取起始值在同一条语句中完成，无需显式事务
+    const char* sql = R"(
+        INSERT INTO sequences (prefix, next_value, width) VALUES (?1, 1 + ?2, 3)
+        ON CONFLICT (prefix) DO UPDATE SET next_value = next_value + ?2
+        RETURNING next_value - ?2, width;
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, prefix.c_str(), (int)prefix.size(), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, count);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    block.prefix = prefix;
+    block.first = sqlite3_column_int64(stmt, 0);
+    block.count = count;
+    block.width = sqlite3_column_int(stmt, 1);
+
+    // RETURNING 语句需执行到结束才完成写入
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+    return true;
+}
+
+std::string Database::PeekAssetCode(const std::string& prefix) {
+    AssetCodeBlock block;
+    block.prefix = prefix;
+    block.first = 1;
+    block.count = 1;
+    block.width = 3;
+
+    Statement stmt = m_stmtCache.Acquire("SELECT next_value, width FROM sequences WHERE prefix = ?;");
+    if (stmt) {
+        sqlite3_bind_text(stmt, 1, prefix.c_str(), (int)prefix.size(), SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            block.first = sqlite3_column_int64(stmt, 0);
+            block.width = sqlite3_column_int(stmt, 1);
+        }
+    }
+    return block.At(0);
+}
+
+std::string Database::GetDefaultAssetCodePrefix() {
+    Asset last;
+    if (!GetLastAsset(last)) {
+        return "ZC";
+    }
+    size_t end = last.assetCode.find_last_not_of("0123456789");
+    return end == std::string::npos ? std::string() : last.assetCode.substr(0, end + 1);
+}
+
+bool Database::AddAsset(Asset& asset) {
+    const char* sql = R"(
+        INSERT INTO assets (asset_code, name, category_id, user_id, purchase_date,
+                           price, location, status, remark)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, asset.assetCode.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 2, asset.name.c_str(), -1, SQLITE_TRANSIENT);
         if (asset.categoryId >= 0) {
@@ -874,11 +1762,10 @@ bool Database::AddAsset(Asset& asset) {
         sqlite3_bind_text(stmt, 8, asset.status.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 9, asset.remark.c_str(), -1, SQLITE_TRANSIENT);
 
-        rc = sqlite3_step(stmt);
+        int rc = sqlite3_step(stmt);
         if (rc == SQLITE_DONE) {
             asset.id = (int)sqlite3_last_insert_rowid(m_db);
         }
-        sqlite3_finalize(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -887,49 +1774,109 @@ bool Database::AddAsset(Asset& asset) {
     return false;
 }
 
-bool Database::UpdateAsset(const Asset& asset) {
-    // 先获取旧的资产数据用于比较
-    Asset oldAsset;
-    if (!GetAssetById(asset.id, oldAsset)) {
-        m_lastError = "找不到要更新的资产";
-        return false;
+int Database::AddAssets(std::vector<Asset>& assets, std::vector<AssetInsertError>* errors) {
+    if (assets.empty()) return 0;
+
+    // 调用方已开启事务时并入其事务，否则自行开启
+    bool ownTransaction = sqlite3_get_autocommit(m_db) != 0;
+    if (ownTransaction && !BeginTransaction()) {
+        return 0;
     }
 
-    // 比较字段变更并记录日志
-    std::vector<AssetChangeLog> changeLogs;
+    int inserted = 0;
+    size_t i = 0;
+    while (i < assets.size()) {
+        // 整批走多行语句，尾部不足一批的逐行插入，只需缓存两条语句
+        int rows = (assets.size() - i >= (size_t)kAssetInsertBatchRows) ? kAssetInsertBatchRows : 1;
+        inserted += InsertAssetRows(assets, i, rows, errors);
+        i += rows;
+    }
 
-    auto addLog = [&](const std::string& fieldName, const std::string& oldVal, const std::string& newVal) {
-        if (oldVal != newVal) {
-            AssetChangeLog log;
-            log.assetId = asset.id;
-            log.assetCode = asset.assetCode;
-            log.assetName = asset.name;
-            log.fieldName = fieldName;
-            log.oldValue = oldVal;
-            log.newValue = newVal;
-            changeLogs.push_back(std::move(log));
+    if (ownTransaction && !Commit()) {
+        Rollback();
+        for (auto& asset : assets) {
+            asset.id = -1;
         }
-    };
+        return 0;
+    }
+
+    return inserted;
+}
+
+int Database::InsertAssetRows(std::vector<Asset>& assets, size_t begin, int rows,
+                              std::vector<AssetInsertError>* errors) {
+    static const std::string batchSql = BuildAssetInsertSql(kAssetInsertBatchRows);
+    static const std::string singleSql = BuildAssetInsertSql(1);
 
-    // 比较各字段
-    addLog("资产编号", oldAsset.assetCode, asset.assetCode);
-    addLog("资产名称", oldAsset.name, asset.name);
-    addLog("分类", oldAsset.categoryName, asset.categoryName);
-    addLog("使用人", oldAsset.userName, asset.userName);
-    addLog("购入日期", oldAsset.purchaseDate, asset.purchaseDate);
-
-    // 价格需要特殊处理
-    std::ostringstream oldPriceStr, newPriceStr;
-    oldPriceStr << std::fixed << std::setprecision(2) << oldAsset.price;
-    newPriceStr << std::fixed << std::setprecision(2) << asset.price;
-    addLog("价格", oldPriceStr.str(), newPriceStr.str());
-
-    addLog("存放位置", oldAsset.location, asset.location);
-    addLog("状态", oldAsset.status, asset.status);
-    addLog("备注", oldAsset.remark, asset.remark);
-
-    // 执行更新
-    sqlite3_stmt* stmt;
+    int inserted = 0;
+    bool failed = false;
+    {
+        Statement stmt = m_stmtCache.Acquire(rows == 1 ? singleSql : batchSql);
+        if (!stmt) {
+            m_lastError = sqlite3_errmsg(m_db);
+            failed = true;
+        } else {
+            // 编号 -> 行下标，同一批内重复的编号只有第一次出现的行会被插入
+            std::unordered_map<std::string, size_t> codeIndex;
+            codeIndex.reserve(rows);
+            for (int r = 0; r < rows; r++) {
+                Asset& asset = assets[begin + r];
+                asset.id = -1;
+                codeIndex.emplace(asset.assetCode, begin + r);
+                BindAssetColumns(stmt, r * 9 + 1, asset);
+            }
+
+            int rc;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                const char* code = (const char*)sqlite3_column_text(stmt, 1);
+                auto it = codeIndex.find(code ? code : "");
+                if (it != codeIndex.end()) {
+                    assets[it->second].id = sqlite3_column_int(stmt, 0);
+                    inserted++;
+                }
+            }
+
+            if (rc != SQLITE_DONE) {
+                // 语句级错误（如外键约束）会回滚整条语句
+                m_lastError = sqlite3_errmsg(m_db);
+                failed = true;
+            }
+        }
+    }
+
+    if (failed) {
+        for (int r = 0; r < rows; r++) {
+            assets[begin + r].id = -1;
+        }
+        if (rows > 1) {
+            // 多行语句失败时逐行重试，定位出错的行，其余行照常插入
+            inserted = 0;
+            for (int r = 0; r < rows; r++) {
+                inserted += InsertAssetRows(assets, begin + r, 1, errors);
+            }
+            return inserted;
+        }
+        if (errors) {
+            errors->push_back({begin, false, m_lastError});
+        }
+        return 0;
+    }
+
+    // 未返回 id 的行被 ON CONFLICT 跳过，即编号已存在
+    if (errors && inserted < rows) {
+        for (int r = 0; r < rows; r++) {
+            const Asset& asset = assets[begin + r];
+            if (asset.id < 0) {
+                errors->push_back({begin + r, true, "资产编号 " + asset.assetCode + " 已存在"});
+            }
+        }
+    }
+
+    return inserted;
+}
+
+bool Database::UpdateAsset(const Asset& asset) {
+    // 变更日志由 trg_assets_change_log 在同一语句内写入，无需先读出旧值比较
     const char* sql = R"(
         UPDATE assets
         SET asset_code = ?, name = ?, category_id = ?, user_id = ?,
@@ -937,35 +1884,18 @@ bool Database::UpdateAsset(const Asset& asset) {
             updated_at = strftime('%s', 'now')
         WHERE id = ?;
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, asset.assetCode.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, asset.name.c_str(), -1, SQLITE_TRANSIENT);
-        if (asset.categoryId >= 0) {
-            sqlite3_bind_int(stmt, 3, asset.categoryId);
-        } else {
-            sqlite3_bind_null(stmt, 3);
-        }
-        if (asset.userId >= 0) {
-            sqlite3_bind_int(stmt, 4, asset.userId);
-        } else {
-            sqlite3_bind_null(stmt, 4);
-        }
-        sqlite3_bind_text(stmt, 5, asset.purchaseDate.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_double(stmt, 6, asset.price);
-        sqlite3_bind_text(stmt, 7, asset.location.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 8, asset.status.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 9, asset.remark.c_str(), -1, SQLITE_TRANSIENT);
+    if (stmt) {
+        BindAssetColumns(stmt, 1, asset);
         sqlite3_bind_int(stmt, 10, asset.id);
 
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         if (rc == SQLITE_DONE) {
-            // 更新成功后记录变更日志
-            if (!changeLogs.empty()) {
-                AddChangeLogs(changeLogs);
+            if (sqlite3_changes(m_db) == 0) {
+                m_lastError = "找不到要更新的资产";
+                return false;
             }
             return true;
         }
@@ -976,14 +1906,12 @@ bool Database::UpdateAsset(const Asset& asset) {
 }
 
 bool Database::DeleteAsset(int id) {
-    sqlite3_stmt* stmt;
     const char* sql = "DELETE FROM assets WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, id);
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
 
         return (rc == SQLITE_DONE);
     }
@@ -996,16 +1924,18 @@ bool Database::GetAssetStats(int& count, double& totalPrice) {
     count = 0;
     totalPrice = 0.0;
 
-    sqlite3_stmt* stmt;
-    const char* sql = "SELECT COUNT(*), COALESCE(SUM(price), 0) FROM assets;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    // 各状态分组之和即全表合计
+    const char* sql = R"(
+        SELECT COALESCE(SUM(asset_count), 0), COALESCE(SUM(total_price), 0)
+        FROM asset_summary WHERE dimension = 1;
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
 
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             count = sqlite3_column_int(stmt, 0);
             totalPrice = sqlite3_column_double(stmt, 1);
         }
-        sqlite3_finalize(stmt);
         return true;
     }
 
@@ -1013,6 +1943,118 @@ bool Database::GetAssetStats(int& count, double& totalPrice) {
     return false;
 }
 
+bool Database::GetAssetSummary(AssetSummary& summary) {
+    summary.totalCount = 0;
+    summary.totalPrice = 0.0;
+    summary.byStatus.clear();
+    summary.byCategory.clear();
+    summary.byDepartment.clear();
+
+    // 数量归零的分组保留在表中供后续复用，读取时过滤
+    const char* sql = R"(
+        SELECT s.dimension, s.group_key,
+               CASE s.dimension WHEN 1 THEN s.group_key
+                                WHEN 2 THEN COALESCE(c.name, '')
+                                ELSE COALESCE(d.name, '') END,
+               s.asset_count, s.total_price
+        FROM asset_summary s
+        LEFT JOIN categories c ON s.dimension = 2 AND c.id = s.group_key
+        LEFT JOIN departments d ON s.dimension = 3 AND d.id = s.group_key
+        WHERE s.asset_count > 0
+        ORDER BY s.dimension, s.group_key;
+    )";
+    Statement stmt = m_stmtCache.Acquire(sql);
+
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int dimension = sqlite3_column_int(stmt, 0);
+        AssetSummaryGroup group;
+        group.id = dimension == 1 ? 0 : sqlite3_column_int(stmt, 1);
+        const char* name = (const char*)sqlite3_column_text(stmt, 2);
+        group.name = name ? name : "";
+        group.count = sqlite3_column_int(stmt, 3);
+        group.totalPrice = sqlite3_column_double(stmt, 4);
+
+        switch (dimension) {
+            case 1:
+                summary.totalCount += group.count;
+                summary.totalPrice += group.totalPrice;
+                summary.byStatus.push_back(std::move(group));
+                break;
+            case 2:
+                summary.byCategory.push_back(std::move(group));
+                break;
+            case 3:
+                summary.byDepartment.push_back(std::move(group));
+                break;
+        }
+    }
+
+    return true;
+}
+
+void Database::AddChangeListener(DatabaseChangeListener* listener) {
+    if (!m_db || m_readOnly) {
+        return;
+    }
+    // 有监听者时才安装钩子，避免无人关心时每行多一次回调
+    if (m_changeListeners.empty()) {
+        sqlite3_update_hook(m_db, UpdateHook, this);
+        sqlite3_rollback_hook(m_db, RollbackHook, this);
+    }
+    m_changeListeners.push_back(listener);
+}
+
+void Database::RemoveChangeListener(DatabaseChangeListener* listener) {
+    m_changeListeners.erase(
+        std::remove(m_changeListeners.begin(), m_changeListeners.end(), listener),
+        m_changeListeners.end());
+    if (m_changeListeners.empty() && m_db) {
+        sqlite3_update_hook(m_db, nullptr, nullptr);
+        sqlite3_rollback_hook(m_db, nullptr, nullptr);
+    }
+}
+
+void Database::UpdateHook(void* context, int operation, const char* /*dbName*/,
+                          const char* table, sqlite3_int64 rowid) {
+    Database* self = static_cast<Database*>(context);
+    for (DatabaseChangeListener* listener : self->m_changeListeners) {
+        listener->OnRowChanged(operation, table, rowid);
+    }
+}
+
+void Database::RollbackHook(void* context) {
+    Database* self = static_cast<Database*>(context);
+    for (DatabaseChangeListener* listener : self->m_changeListeners) {
+        listener->OnRollback();
+    }
+}
+
+ReferenceCache& Database::GetReferenceCache() {
+    if (!m_referenceCache) {
+        m_referenceCache.reset(new ReferenceCache(*this));
+    }
+    return *m_referenceCache;
+}
+
+int Database::GetDataVersion() {
+    Statement stmt = m_stmtCache.Acquire("PRAGMA data_version;");
+    if (stmt && sqlite3_step(stmt) == SQLITE_ROW) {
+        return sqlite3_column_int(stmt, 0);
+    }
+    return -1;
+}
+
+void Database::SetProgressHandler(int instructions, int (*handler)(void*), void* context) {
+    if (m_db) {
+        sqlite3_progress_handler(m_db, instructions, handler, context);
+    }
+}
+
 bool Database::BeginTransaction() {
     char* errMsg = nullptr;
     int rc = sqlite3_exec(m_db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
@@ -1046,28 +2088,146 @@ bool Database::Rollback() {
     return true;
 }
 
+bool Database::BeginBulkLoad() {
+    if (sqlite3_get_autocommit(m_db)) {
+        m_lastError = "批量导入须在事务内进行";
+        return false;
+    }
+
+    // AUTOINCREMENT 的新 ID 总大于现有最大 ID，结束时 id 大于它的行就是本次插入的
+    {
+        Statement stmt = m_stmtCache.Acquire("SELECT COALESCE(MAX(id), 0) FROM assets;");
+        if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) {
+            m_lastError = sqlite3_errmsg(m_db);
+            return false;
+        }
+        m_bulkLoadFromId = sqlite3_column_int64(stmt, 0);
+    }
+
+    Statement stmt = m_stmtCache.Acquire("INSERT INTO asset_bulk_load (id) VALUES (1);");
+    if (!stmt || sqlite3_step(stmt) != SQLITE_DONE) {
+        m_lastError = sqlite3_errmsg(m_db);
+        m_bulkLoadFromId = -1;
+        return false;
+    }
+    return true;
+}
+
+bool Database::EndBulkLoad() {
+    if (m_bulkLoadFromId < 0) {
+        m_lastError = "未开始批量导入";
+        return false;
+    }
+
+    // 与各插入触发器逐行做的事相同，只是按本次插入的 ID 区间一次完成
+    struct ApplyStep {
+        const char* sql;
+        bool searchIndex;       // 只在全文索引可用时执行
+    };
+    // 只读本批新增的行（rowid 区间）；NOT INDEXED 防止按 COALESCE(status, '') 排序索引整表扫描
+    static const ApplyStep steps[] = {
+        {R"(
+            INSERT INTO asset_summary (dimension, group_key, asset_count, total_price)
+            SELECT 1, COALESCE(status, ''), COUNT(*), SUM(COALESCE(price, 0))
+            FROM assets NOT INDEXED WHERE id > ?1 GROUP BY 2
+            UNION ALL
+            SELECT 2, COALESCE(category_id, 0), COUNT(*), SUM(COALESCE(price, 0))
+            FROM assets WHERE id > ?1 GROUP BY 2
+            UNION ALL
+            SELECT 3, COALESCE(e.department_id, 0), COUNT(*), SUM(COALESCE(a.price, 0))
+            FROM assets a LEFT JOIN employees e ON a.user_id = e.id WHERE a.id > ?1 GROUP BY 2
+            ON CONFLICT (dimension, group_key) DO UPDATE
+            SET asset_count = asset_count + excluded.asset_count,
+                total_price = total_price + excluded.total_price;
+        )", false},
+        {R"(
+            INSERT INTO sequences (prefix, next_value, width)
+            SELECT prefix, MAX(CAST(substr(asset_code, length(prefix) + 1) AS INTEGER)) + 1,
+                   MAX(length(asset_code) - length(prefix))
+            FROM (SELECT asset_code, rtrim(asset_code, '0123456789') AS prefix
+                  FROM assets WHERE id > ?1 AND asset_code GLOB '*[0-9]')
+            GROUP BY prefix
+            ON CONFLICT (prefix) DO UPDATE SET next_value = excluded.next_value
+            WHERE excluded.next_value > next_value;
+        )", false},
+        {R"(
+            INSERT INTO assets_fts (rowid, asset_code, name, remark, user_name)
+            SELECT a.id, a.asset_code, a.name, COALESCE(a.remark, ''), COALESCE(e.name, '')
+            FROM assets a LEFT JOIN employees e ON a.user_id = e.id
+            WHERE a.id > ?1;
+        )", true},
+        {"DELETE FROM asset_bulk_load;", false},
+    };
+
+    bool ok = true;
+    for (const auto& step : steps) {
+        if (step.searchIndex && !m_hasAssetFts) {
+            continue;
+        }
+        Statement stmt = m_stmtCache.Acquire(step.sql);
+        if (!stmt) {
+            ok = false;
+        } else {
+            if (sqlite3_bind_parameter_count(stmt) > 0) {
+                sqlite3_bind_int64(stmt, 1, m_bulkLoadFromId);
+            }
+            ok = sqlite3_step(stmt) == SQLITE_DONE;
+        }
+        if (!ok) {
+            m_lastError = sqlite3_errmsg(m_db);
+            break;
+        }
+    }
+
+    m_bulkLoadFromId = -1;
+    return ok;
+}
+
 // ========== 变更日志操作实现 ==========
 
 bool Database::AddChangeLog(const AssetChangeLog& log) {
-    sqlite3_stmt* stmt;
+    // 直接写入字典编码的日志表，不经过兼容视图的 INSTEAD OF 触发器；
+    // 资产编号、名称由视图关联 assets 得到，这里不保存；changeTime 为 0 时取当前时间
     const char* sql = R"(
-        INSERT INTO asset_change_logs (asset_id, asset_code, asset_name, field_name, old_value, new_value)
-        VALUES (?, ?, ?, ?, ?, ?);
+        INSERT INTO asset_change_log_entries (asset_id, field_id, old_value, new_value, change_time)
+        VALUES (?, (SELECT id FROM asset_log_fields WHERE name = ?), ?, ?,
+                COALESCE(?, CAST(strftime('%s', 'now') AS INTEGER)));
     )";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
 
-    if (rc == SQLITE_OK) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        Statement stmt = m_stmtCache.Acquire(sql);
+        if (!stmt) {
+            break;
+        }
+
         sqlite3_bind_int(stmt, 1, log.assetId);
-        sqlite3_bind_text(stmt, 2, log.assetCode.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 3, log.assetName.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 4, log.fieldName.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 5, log.oldValue.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 6, log.newValue.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, log.fieldName.c_str(), (int)log.fieldName.size(), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, log.oldValue.c_str(), (int)log.oldValue.size(), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, log.newValue.c_str(), (int)log.newValue.size(), SQLITE_STATIC);
+        if (log.changeTime > 0) {
+            sqlite3_bind_int64(stmt, 5, log.changeTime);
+        } else {
+            sqlite3_bind_null(stmt, 5);
+        }
 
-        rc = sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_DONE) {
+            return true;
+        }
+        if (rc != SQLITE_CONSTRAINT || attempt > 0) {
+            break;
+        }
 
-        return (rc == SQLITE_DONE);
+        // 字段名不在字典中（field_id 为 NULL），登记后重试一次
+        Statement addField = m_stmtCache.Acquire(
+            "INSERT INTO asset_log_fields (name) VALUES (?) ON CONFLICT DO NOTHING;");
+        if (!addField) {
+            break;
+        }
+        sqlite3_bind_text(addField, 1, log.fieldName.c_str(), (int)log.fieldName.size(), SQLITE_STATIC);
+        if (sqlite3_step(addField) != SQLITE_DONE) {
+            break;
+        }
     }
 
     m_lastError = sqlite3_errmsg(m_db);
@@ -1088,8 +2248,6 @@ bool Database::AddChangeLogs(const std::vector<AssetChangeLog>& logs) {
 std::vector<AssetChangeLog> Database::GetChangeLogsByAssetId(int assetId) {
     std::vector<AssetChangeLog> result;
     result.reserve(32);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
     const char* sql = R"(
         SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
         FROM asset_change_logs
@@ -1097,26 +2255,15 @@ std::vector<AssetChangeLog> Database::GetChangeLogsByAssetId(int assetId) {
         ORDER BY change_time DESC, id DESC;
     )";
 
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
-    if (rc == SQLITE_OK) {
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (stmt) {
         sqlite3_bind_int(stmt, 1, assetId);
 
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             AssetChangeLog log;
-            log.id = sqlite3_column_int(stmt, 0);
-            log.assetId = sqlite3_column_int(stmt, 1);
-            log.assetCode = (const char*)sqlite3_column_text(stmt, 2);
-            log.assetName = (const char*)sqlite3_column_text(stmt, 3);
-            log.fieldName = (const char*)sqlite3_column_text(stmt, 4);
-            const char* oldVal = (const char*)sqlite3_column_text(stmt, 5);
-            const char* newVal = (const char*)sqlite3_column_text(stmt, 6);
-            const char* changeTime = (const char*)sqlite3_column_text(stmt, 7);
-            log.oldValue = oldVal ? oldVal : "";
-            log.newValue = newVal ? newVal : "";
-            log.changeTime = changeTime ? changeTime : "";
+            BuildChangeLogFromStmt(stmt, log);
             result.push_back(std::move(log));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
@@ -1125,51 +2272,46 @@ std::vector<AssetChangeLog> Database::GetChangeLogsByAssetId(int assetId) {
 std::vector<AssetChangeLog> Database::GetAllChangeLogs(int limit, int offset) {
     std::vector<AssetChangeLog> result;
     result.reserve(limit > 0 ? limit : 128);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
-
-    std::string sql = R"(
+    // LIMIT/OFFSET 使用参数绑定，保证不同分页共用同一条缓存语句
+    const char* sqlAll = R"(
         SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
         FROM asset_change_logs
-        ORDER BY change_time DESC, id DESC
+        ORDER BY change_time DESC, id DESC;
+    )";
+    // 分页时先在时间覆盖索引上跳过 OFFSET 行，只对本页的行关联资产和字段名
+    const char* sqlPage = R"(
+        SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
+        FROM asset_change_logs
+        WHERE id IN (SELECT id FROM asset_change_log_entries
+                     ORDER BY change_time DESC, id DESC
+                     LIMIT ? OFFSET ?)
+        ORDER BY change_time DESC, id DESC;
     )";
 
-    if (limit > 0) {
-        sql += " LIMIT " + std::to_string(limit);
-        if (offset > 0) {
-            sql += " OFFSET " + std::to_string(offset);
+    Statement stmt = m_stmtCache.Acquire(limit > 0 ? sqlPage : sqlAll);
+    if (stmt) {
+        if (limit > 0) {
+            sqlite3_bind_int(stmt, 1, limit);
+            sqlite3_bind_int(stmt, 2, offset > 0 ? offset : 0);
         }
-    }
-    sql += ";";
-
-    int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr);
-    if (rc == SQLITE_OK) {
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             AssetChangeLog log;
-            log.id = sqlite3_column_int(stmt, 0);
-            log.assetId = sqlite3_column_int(stmt, 1);
-            log.assetCode = (const char*)sqlite3_column_text(stmt, 2);
-            log.assetName = (const char*)sqlite3_column_text(stmt, 3);
-            log.fieldName = (const char*)sqlite3_column_text(stmt, 4);
-            const char* oldVal = (const char*)sqlite3_column_text(stmt, 5);
-            const char* newVal = (const char*)sqlite3_column_text(stmt, 6);
-            const char* changeTime = (const char*)sqlite3_column_text(stmt, 7);
-            log.oldValue = oldVal ? oldVal : "";
-            log.newValue = newVal ? newVal : "";
-            log.changeTime = changeTime ? changeTime : "";
+            BuildChangeLogFromStmt(stmt, log);
             result.push_back(std::move(log));
         }
-        sqlite3_finalize(stmt);
     }
 
     return result;
 }
 
-std::vector<AssetChangeLog> Database::SearchChangeLogs(const std::string& searchText,
-                                                        const std::string& startDate,
-                                                        const std::string& endDate) {
+std::vector<AssetChangeLog> Database::GetChangeLogsBefore(const ChangeLogPageKey& before, int pageSize,
+                                                           const ChangeLogFilter& filter,
+                                                           ChangeLogPageKey* nextKey) {
     std::vector<AssetChangeLog> result;
-    result.reserve(128);  // 预分配，减少内存重分配
-    sqlite3_stmt* stmt;
+    if (pageSize <= 0) {
+        return result;
+    }
+    result.reserve(pageSize);
 
     std::string sql = R"(
         SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
@@ -1177,70 +2319,203 @@ std::vector<AssetChangeLog> Database::SearchChangeLogs(const std::string& search
         WHERE 1=1
     )";
 
-    if (!searchText.empty()) {
-        sql += " AND (asset_code LIKE ? OR asset_name LIKE ? OR field_name LIKE ?)";
+    sql += BuildChangeLogFilterSql(filter.searchText, filter.time);
+    if (filter.assetId >= 0) {
+        sql += " AND asset_id = ?";
     }
-    if (!startDate.empty()) {
-        sql += " AND change_time >= ?";
-    }
-    if (!endDate.empty()) {
-        sql += " AND change_time <= ?";
+    // 键集定位：(change_time, id) 严格位于上一页末行之前
+    if (before.valid) {
+        sql += " AND (change_time, id) < (?, ?)";
     }
-    sql += " ORDER BY change_time DESC, id DESC;";
+    sql += " ORDER BY change_time DESC, id DESC LIMIT ?;";
 
-    int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
         m_lastError = sqlite3_errmsg(m_db);
         return result;
     }
 
-    int paramIdx = 1;
-    std::string searchPattern = "%" + searchText + "%";
+    int paramIdx = BindChangeLogFilter(stmt, 1, filter.searchText, filter.time);
+    if (filter.assetId >= 0) {
+        sqlite3_bind_int(stmt, paramIdx++, filter.assetId);
+    }
+    if (before.valid) {
+        sqlite3_bind_int64(stmt, paramIdx++, before.changeTime);
+        sqlite3_bind_int(stmt, paramIdx++, before.id);
+    }
+    sqlite3_bind_int(stmt, paramIdx++, pageSize);
 
-    if (!searchText.empty()) {
-        sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        AssetChangeLog log;
+        BuildChangeLogFromStmt(stmt, log);
+        result.push_back(std::move(log));
     }
-    if (!startDate.empty()) {
-        sqlite3_bind_text(stmt, paramIdx++, startDate.c_str(), -1, SQLITE_TRANSIENT);
+
+    if (nextKey) {
+        if (result.empty()) {
+            *nextKey = before;
+        } else {
+            nextKey->valid = true;
+            nextKey->changeTime = result.back().changeTime;
+            nextKey->id = result.back().id;
+        }
     }
-    if (!endDate.empty()) {
-        std::string endDateTime = endDate + " 23:59:59";
-        sqlite3_bind_text(stmt, paramIdx++, endDateTime.c_str(), -1, SQLITE_TRANSIENT);
+
+    return result;
+}
+
+std::vector<AssetChangeLog> Database::SearchChangeLogs(const std::string& searchText,
+                                                        const ChangeLogTimeRange& time) {
+    std::vector<AssetChangeLog> result;
+    result.reserve(128);  // 预分配，减少内存重分配
+    std::string sql = R"(
+        SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
+        FROM asset_change_logs
+        WHERE 1=1
+    )";
+
+    sql += BuildChangeLogFilterSql(searchText, time);
+    sql += " ORDER BY change_time DESC, id DESC;";
+
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return result;
     }
 
+    BindChangeLogFilter(stmt, 1, searchText, time);
+
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         AssetChangeLog log;
-        log.id = sqlite3_column_int(stmt, 0);
-        log.assetId = sqlite3_column_int(stmt, 1);
-        log.assetCode = (const char*)sqlite3_column_text(stmt, 2);
-        log.assetName = (const char*)sqlite3_column_text(stmt, 3);
-        log.fieldName = (const char*)sqlite3_column_text(stmt, 4);
-        const char* oldVal = (const char*)sqlite3_column_text(stmt, 5);
-        const char* newVal = (const char*)sqlite3_column_text(stmt, 6);
-        const char* changeTime = (const char*)sqlite3_column_text(stmt, 7);
-        log.oldValue = oldVal ? oldVal : "";
-        log.newValue = newVal ? newVal : "";
-        log.changeTime = changeTime ? changeTime : "";
+        BuildChangeLogFromStmt(stmt, log);
         result.push_back(std::move(log));
     }
 
-    sqlite3_finalize(stmt);
     return result;
 }
 
+bool Database::ForEachChangeLog(const std::string& searchText, const ChangeLogTimeRange& time,
+                                const std::function<bool(const ChangeLogRowView&)>& visitor) {
+    std::string sql = R"(
+        SELECT id, asset_id, asset_code, asset_name, field_name, old_value, new_value, change_time
+        FROM asset_change_logs
+        WHERE 1=1
+    )";
+
+    sql += BuildChangeLogFilterSql(searchText, time);
+    sql += " ORDER BY change_time DESC, id DESC;";
+
+    Statement stmt = m_stmtCache.Acquire(sql);
+    if (!stmt) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+
+    BindChangeLogFilter(stmt, 1, searchText, time);
+
+    ChangeLogRowView row;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        row.id = sqlite3_column_int(stmt, 0);
+        row.assetId = sqlite3_column_int(stmt, 1);
+        row.assetCode = ColumnView(stmt, 2);
+        row.assetName = ColumnView(stmt, 3);
+        row.fieldName = ColumnView(stmt, 4);
+        row.oldValue = ColumnView(stmt, 5);
+        row.newValue = ColumnView(stmt, 6);
+        row.changeTime = sqlite3_column_int64(stmt, 7);
+        if (!visitor(row)) {
+            return true;
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        m_lastError = sqlite3_errmsg(m_db);
+        return false;
+    }
+    return true;
+}
+
+// 解析本地日期 "YYYY-MM-DD"，dayOffset 天后的本地零点换算为 Unix 时间戳
+static std::optional<long long> LocalDateToEpoch(const std::string& date, int dayOffset) {
+    int year = 0, month = 0, day = 0;
+    if (date.empty() || std::sscanf(date.c_str(), "%d-%d-%d", &year, &month, &day) != 3) {
+        return std::nullopt;
+    }
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day + dayOffset;  // mktime 会规范化越界的日期
+    tm.tm_isdst = -1;
+    std::time_t t = std::mktime(&tm);
+    if (t == (std::time_t)-1) {
+        return std::nullopt;
+    }
+    return (long long)t;
+}
+
+ChangeLogTimeRange ChangeLogTimeRange::FromLocalDates(const std::string& startDate, const std::string& endDate) {
+    ChangeLogTimeRange range;
+    range.from = LocalDateToEpoch(startDate, 0);
+    range.to = LocalDateToEpoch(endDate, 1);  // 含结束日全天：到次日零点（不含）
+    return range;
+}
+
+std::string Database::BuildChangeLogFilterSql(const std::string& searchText,
+                                              const ChangeLogTimeRange& time) const {
+    std::string sql;
+    if (!searchText.empty()) {
+        // 编号、名称和字段名先在资产、字段字典中筛出 ID 集合，日志行只做整数查找
+        if (UseAssetFtsMatch(searchText)) {
+            sql += " AND (asset_id IN (SELECT rowid FROM assets_fts WHERE assets_fts MATCH ?)";
+        } else {
+            sql += " AND (asset_id IN (SELECT id FROM assets WHERE asset_code LIKE ? OR name LIKE ?)";
+        }
+        sql += " OR field_id IN (SELECT id FROM asset_log_fields WHERE name LIKE ?))";
+    }
+    // 整数时间直接比较，半开区间与 (change_time, id) 索引的范围定位一致
+    if (time.from) {
+        sql += " AND change_time >= ?";
+    }
+    if (time.to) {
+        sql += " AND change_time < ?";
+    }
+    return sql;
+}
+
+int Database::BindChangeLogFilter(sqlite3_stmt* stmt, int paramIdx, const std::string& searchText,
+                                  const ChangeLogTimeRange& time) const {
+    if (!searchText.empty()) {
+        std::string searchPattern = "%" + searchText + "%";
+        if (UseAssetFtsMatch(searchText)) {
+            // 只匹配编号和名称两列
+            std::string query = "{asset_code name} : " + BuildFtsPhrase(searchText);
+            sqlite3_bind_text(stmt, paramIdx++, query.c_str(), (int)query.size(), SQLITE_TRANSIENT);
+        } else {
+            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+        }
+        sqlite3_bind_text(stmt, paramIdx++, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    if (time.from) {
+        sqlite3_bind_int64(stmt, paramIdx++, *time.from);
+    }
+    if (time.to) {
+        sqlite3_bind_int64(stmt, paramIdx++, *time.to);
+    }
+    return paramIdx;
+}
+
 int Database::GetChangeLogCount() {
-    sqlite3_stmt* stmt;
-    const char* sql = "SELECT COUNT(*) FROM asset_change_logs;";
-    int rc = sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr);
+    // 直接计数日志表（走覆盖索引），不经过兼容视图的连接
+    const char* sql = "SELECT COUNT(*) FROM asset_change_log_entries;";
+    Statement stmt = m_stmtCache.Acquire(sql);
 
     int count = 0;
-    if (rc == SQLITE_OK) {
+    if (stmt) {
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             count = sqlite3_column_int(stmt, 0);
         }
-        sqlite3_finalize(stmt);
     }
 
     return count;
@@ -0,0 +1,1733 @@
+/**
+ * @file asset_bench.cpp
+ * @brief 数据层基准测试
+ *
+ * 生成确定性的模拟数据集（中文姓名、部门、分类与变更日志），逐项测量
+ * Database 接口的延迟分位数与吞吐，结果写入 JSON 便于比较不同版本：
+ *
+ *   asset_bench --sizes 10000,100000 --out bench.json
+ *
+ * 不依赖 Win32，可在 Linux 上构建运行。
+ */
+
+#include "database.h"
+#include "StatementCache.h"
+#include "AssetStore.h"
+#include "AsyncSearchExecutor.h"
+#include "ReadConnectionPool.h"
+#include "ChangeLogDataSource.h"
+#include "ReferenceCache.h"
+#include "CsvExporter.h"
+#include "CsvImporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ========== 命令行参数 ==========
+
+struct BenchOptions {
+    std::vector<long long> sizes{10000, 100000};
+    std::string outPath = "asset_bench.json";
+    std::string dataDir = "bench_data";
+    uint64_t seed = 20240501;
+    int iterations = 200;           // 每项最多执行次数
+    int budgetMs = 3000;            // 每项耗时上限（至少执行 kMinIterations 次）
+    int changeLogsPerAsset = 2;
+    std::vector<int> readers{1, 2, 4};
+    int concurrencyMs = 2000;
+    bool reuse = false;             // 数据库已存在且行数一致时跳过生成
+    std::string filter;             // 只运行名称包含该子串的测试项
+};
+
+static const int kMinIterations = 3;
+
+static void PrintUsage() {
+    std::printf(
+        "用法: asset_bench [选项]\n"
+        "  --sizes N[,N...]          数据集资产数量（默认 10000,100000）\n"
+        "  --out FILE                JSON 结果文件（默认 asset_bench.json）\n"
+        "  --dir DIR                 数据库存放目录（默认 bench_data）\n"
+        "  --seed N                  随机种子（默认 20240501）\n"
+        "  --iterations N            每项最多执行次数（默认 200）\n"
+        "  --budget-ms N             每项耗时上限（默认 3000）\n"
+        "  --changelogs-per-asset N  每个资产生成的变更日志数（默认 2）\n"
+        "  --readers N[,N...]        并发测试的读线程数（默认 1,2,4）\n"
+        "  --concurrency-ms N        每轮并发测试时长（默认 2000）\n"
+        "  --reuse                   复用已生成的数据库\n"
+        "  --filter TEXT             只运行名称包含 TEXT 的测试项\n");
+}
+
+template <typename T>
+static std::vector<T> ParseList(const std::string& text) {
+    std::vector<T> result;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            result.push_back((T)std::atoll(item.c_str()));
+        }
+    }
+    return result;
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+
+        if (arg == "--sizes") {
+            options.sizes = ParseList<long long>(value());
+        } else if (arg == "--out") {
+            options.outPath = value();
+        } else if (arg == "--dir") {
+            options.dataDir = value();
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value().c_str(), nullptr, 10);
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--budget-ms") {
+            options.budgetMs = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--changelogs-per-asset") {
+            options.changeLogsPerAsset = std::max(0, std::atoi(value().c_str()));
+        } else if (arg == "--readers") {
+            options.readers = ParseList<int>(value());
+        } else if (arg == "--concurrency-ms") {
+            options.concurrencyMs = std::max(0, std::atoi(value().c_str()));
+        } else if (arg == "--reuse") {
+            options.reuse = true;
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else {
+            PrintUsage();
+            return false;
+        }
+    }
+    return !options.sizes.empty();
+}
+
+// ========== 确定性随机数 ==========
+
+/**
+ * @brief splitmix64，跨平台结果一致（不使用 <random> 的分布以免实现差异）
+ */
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : m_state(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, n)
+    uint64_t Uniform(uint64_t n) { return n ? Next() % n : 0; }
+
+    // [0, 1)
+    double Real() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    bool Chance(double p) { return Real() < p; }
+
+    template <typename T, size_t N>
+    const T& Pick(const T (&items)[N]) { return items[Uniform(N)]; }
+
+    template <typename T>
+    const T& Pick(const std::vector<T>& items) { return items[Uniform(items.size())]; }
+
+private:
+    uint64_t m_state;
+};
+
+// ========== 模拟数据词表 ==========
+
+static const char* const kSurnames[] = {
+    "王", "李", "张", "刘", "陈", "杨", "黄", "赵", "吴", "周", "徐", "孙", "马", "朱",
+    "胡", "郭", "何", "高", "林", "罗", "郑", "梁", "谢", "宋", "唐", "许", "韩", "冯",
+    "邓", "曹", "彭", "曾", "萧", "田", "董", "潘", "袁", "蔡", "蒋", "余", "欧阳", "司马",
+};
+
+static const char* const kGivenNames[] = {
+    "伟", "芳", "娜", "秀英", "敏", "静", "丽", "强", "磊", "军", "洋", "勇", "艳", "杰",
+    "娟", "涛", "明", "超", "秀兰", "霞", "平", "刚", "桂英", "浩然", "子涵", "欣怡", "梓轩",
+    "一诺", "宇航", "思远", "晓东", "建华", "海燕", "志强", "文博", "雨桐", "嘉怡", "俊杰",
+};
+
+static const char* const kDepartments[] = {
+    "研发中心", "产品部", "市场部", "销售部", "财务部", "人力资源部", "行政部", "法务部",
+    "采购部", "客户服务部", "质量管理部", "信息技术部", "运营部", "董事会办公室",
+};
+
+struct CategorySpec {
+    const char* name;
+    const char* items[4];
+    double minPrice;
+    double maxPrice;
+};
+
+static const CategorySpec kCategories[] = {
+    {"笔记本电脑", {"ThinkPad X1 笔记本电脑", "MacBook Pro 笔记本电脑", "戴尔 Latitude 笔记本电脑", "华为 MateBook 笔记本电脑"}, 4500, 18000},
+    {"台式电脑",   {"联想 启天 台式机", "戴尔 OptiPlex 台式机", "惠普 EliteDesk 台式机", "华为 擎云 台式机"}, 3000, 9000},
+    {"显示器",     {"戴尔 27寸显示器", "明基 24寸显示器", "三星 32寸曲面显示器", "飞利浦 27寸显示器"}, 800, 4500},
+    {"打印设备",   {"惠普 激光打印机", "佳能 彩色喷墨打印机", "兄弟 多功能一体机", "理光 复印机"}, 900, 26000},
+    {"网络设备",   {"华为 千兆交换机", "思科 核心路由器", "H3C 无线接入点", "深信服 防火墙"}, 600, 48000},
+    {"办公家具",   {"人体工学办公椅", "升降办公桌", "文件柜", "会议桌"}, 300, 6000},
+    {"通讯设备",   {"华为 视频会议终端", "小米 手机", "苹果 iPhone 手机", "宝利通 会议电话"}, 1500, 22000},
+    {"服务器",     {"浪潮 机架式服务器", "戴尔 PowerEdge 服务器", "华为 FusionServer 服务器", "联想 ThinkSystem 服务器"}, 18000, 120000},
+    {"投影设备",   {"爱普生 投影仪", "明基 激光投影仪", "索尼 会议投影仪", "极米 便携投影仪"}, 2500, 16000},
+    {"车辆",       {"比亚迪 汉 公务车", "大众 帕萨特 公务车", "丰田 凯美瑞 公务车", "五菱 宏光 货车"}, 60000, 320000},
+};
+
+static const char* const kBuildings[] = {"A座", "B座", "C座", "研发楼", "综合楼"};
+
+static const char* const kRemarks[] = {
+    "", "", "", "", "随机附带电源适配器", "已贴资产标签", "保修期三年", "外借中，月底归还",
+    "配件齐全", "屏幕有轻微划痕", "年度盘点已核对", "原厂延保",
+};
+
+struct StatusSpec {
+    const char* name;
+    double weight;
+};
+
+static const StatusSpec kStatuses[] = {
+    {"在用", 0.70}, {"闲置", 0.18}, {"维修中", 0.07}, {"已报废", 0.05},
+};
+
+// 搜索词：三个字符及以上走 trigram 全文索引，更短的走 LIKE
+static const char* const kLongSearchTerms[] = {
+    "笔记本", "显示器", "ThinkPad", "服务器", "办公椅", "打印机", "交换机", "投影仪", "ZC0001",
+};
+
+static const char* const kShortSearchTerms[] = {
+    "电脑", "华为", "戴尔", "会议", "手机", "王伟",
+};
+
+// 生成的变更日志时间范围：2022-01-01 00:00:00 UTC 起三年
+static const long long kLogTimeBase = 1640995200LL;
+static const long long kLogTimeSpan = 3LL * 365 * 86400;
+
+static std::string MakeAssetCode(long long number) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "ZC%08lld", number);
+    return buf;
+}
+
+static const char* PickStatus(Rng& rng) {
+    double r = rng.Real();
+    for (const StatusSpec& status : kStatuses) {
+        if (r < status.weight) {
+            return status.name;
+        }
+        r -= status.weight;
+    }
+    return kStatuses[0].name;
+}
+
+// ========== 计时与统计 ==========
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMicros(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief 单项测试结果
+ */
+struct BenchResult {
+    std::string name;
+    long long iterations = 0;
+    long long items = 0;        // 处理的行数（批量接口），其余等于 iterations
+    double totalMs = 0;
+    double meanUs = 0;
+    double p50Us = 0;
+    double p90Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+    double throughput = 0;      // items / s
+};
+
+static double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = (size_t)std::ceil(p * sorted.size());
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static BenchResult Summarize(const std::string& name, std::vector<double> samples,
+                             long long items, double wallMs) {
+    BenchResult result;
+    result.name = name;
+    result.iterations = (long long)samples.size();
+    result.items = items;
+    result.totalMs = wallMs;
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    result.meanUs = samples.empty() ? 0 : sum / samples.size();
+    result.p50Us = Percentile(samples, 0.50);
+    result.p90Us = Percentile(samples, 0.90);
+    result.p99Us = Percentile(samples, 0.99);
+    result.maxUs = samples.empty() ? 0 : samples.back();
+    result.throughput = wallMs > 0 ? items * 1000.0 / wallMs : 0;
+    return result;
+}
+
+static void PrintResult(const BenchResult& result) {
+    std::printf("  %-44s %7lld  p50 %10.1fus  p99 %10.1fus  %12.1f/s\n",
+                result.name.c_str(), result.iterations, result.p50Us, result.p99Us,
+                result.throughput);
+    std::fflush(stdout);
+}
+
+/**
+ * @brief 测试项执行器
+ *
+ * 每项最多执行 iterations 次，超出时间预算后提前结束（至少执行 kMinIterations 次）。
+ * prepare 不计入耗时，run 返回本次处理的行数。
+ */
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options) : m_options(options) {}
+
+    void Run(const std::string& name, const std::function<long long(int)>& run,
+             const std::function<void(int)>& prepare = nullptr) {
+        if (!Enabled(name)) {
+            return;
+        }
+
+        std::vector<double> samples;
+        long long items = 0;
+        double wallMs = 0;
+        auto budgetStart = Clock::now();
+
+        for (int i = 0; i < m_options.iterations; i++) {
+            if (i >= kMinIterations &&
+                ElapsedMicros(budgetStart) > m_options.budgetMs * 1000.0) {
+                break;
+            }
+            if (prepare) {
+                prepare(i);
+            }
+            auto start = Clock::now();
+            items += run(i);
+            double us = ElapsedMicros(start);
+            samples.push_back(us);
+            wallMs += us / 1000.0;
+        }
+
+        Add(Summarize(name, std::move(samples), items, wallMs));
+    }
+
+    bool Enabled(const std::string& name) const {
+        return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+    }
+
+    void Add(const BenchResult& result) {
+        PrintResult(result);
+        m_results.push_back(result);
+    }
+
+    std::vector<BenchResult> TakeResults() { return std::move(m_results); }
+
+private:
+    const BenchOptions& m_options;
+    std::vector<BenchResult> m_results;
+};
+
+// ========== 数据集生成 ==========
+
+/**
+ * @brief 数据集信息
+ */
+struct Dataset {
+    long long assetCount = 0;
+    long long changeLogCount = 0;
+    std::string path;
+    std::vector<int> categoryIds;
+    std::vector<int> departmentIds;
+    std::vector<int> employeeIds;
+    std::vector<std::string> employeeNames;
+    int minAssetId = 0;
+    int maxAssetId = 0;
+    double generateSeconds = 0;
+    std::vector<BenchResult> results;
+};
+
+static void RemoveDatabaseFiles(const std::string& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+    fs::remove(path + "-wal", ec);
+    fs::remove(path + "-shm", ec);
+    fs::remove(path + "-journal", ec);
+}
+
+static bool LoadReferenceData(Database& db, Dataset& dataset) {
+    dataset.categoryIds.clear();
+    dataset.departmentIds.clear();
+    dataset.employeeIds.clear();
+    dataset.employeeNames.clear();
+
+    for (const Category& category : db.GetAllCategories()) {
+        dataset.categoryIds.push_back(category.id);
+    }
+    for (const Department& dept : db.GetAllDepartments()) {
+        dataset.departmentIds.push_back(dept.id);
+    }
+    for (const Employee& employee : db.GetAllEmployees()) {
+        dataset.employeeIds.push_back(employee.id);
+        dataset.employeeNames.push_back(employee.name);
+    }
+
+    int count = 0;
+    double total = 0;
+    db.GetAssetStats(count, total);
+    dataset.assetCount = count;
+    dataset.changeLogCount = db.GetChangeLogCount();
+
+    Asset last;
+    dataset.maxAssetId = db.GetLastAsset(last) ? last.id : 0;
+    dataset.minAssetId = dataset.maxAssetId - count + 1;
+    return count > 0 && !dataset.categoryIds.empty() && !dataset.employeeIds.empty();
+}
+
+static bool GenerateDataset(Database& db, Dataset& dataset, long long assetCount,
+                            const BenchOptions& options, BenchRunner& runner) {
+    Rng rng(options.seed ^ (uint64_t)assetCount);
+    auto generateStart = Clock::now();
+
+    // 参考数据
+    // categoryIds[i] 对应 kCategories[i]
+    std::vector<int> categoryIds;
+    db.BeginTransaction();
+    for (const CategorySpec& spec : kCategories) {
+        Category category{0, spec.name};
+        if (!db.AddCategory(category)) {
+            std::fprintf(stderr, "添加分类失败: %s\n", db.GetLastError().c_str());
+            db.Rollback();
+            return false;
+        }
+        categoryIds.push_back(category.id);
+    }
+    for (const char* name : kDepartments) {
+        Department dept{0, name};
+        db.AddDepartment(dept);
+    }
+    db.Commit();
+
+    std::vector<Department> departments = db.GetAllDepartments();
+    long long employeeCount = std::max<long long>(50, assetCount / 20);
+    db.BeginTransaction();
+    for (long long i = 0; i < employeeCount; i++) {
+        Employee employee;
+        employee.id = 0;
+        employee.name = std::string(rng.Pick(kSurnames)) + rng.Pick(kGivenNames);
+        // 少量员工未分配部门
+        employee.departmentId = rng.Chance(0.03) ? -1 : rng.Pick(departments).id;
+        if (!db.AddEmployee(employee)) {
+            std::fprintf(stderr, "添加员工失败: %s\n", db.GetLastError().c_str());
+            db.Rollback();
+            return false;
+        }
+    }
+    db.Commit();
+
+    std::vector<Employee> employees = db.GetAllEmployees();
+
+    // 资产：按 5000 行一批调用 AddAssets，与 CSV 导入的批量大小一致
+    const long long batchRows = 5000;
+    std::vector<double> batchSamples;
+    double importMs = 0;
+    std::vector<Asset> batch;
+    batch.reserve((size_t)batchRows);
+
+    for (long long number = 1; number <= assetCount; number++) {
+        size_t catIdx = (size_t)rng.Uniform(categoryIds.size());
+        const CategorySpec& spec = kCategories[catIdx];
+
+        Asset asset;
+        asset.id = 0;
+        asset.assetCode = MakeAssetCode(number);
+        asset.name = spec.items[rng.Uniform(4)];
+        asset.categoryId = rng.Chance(0.02) ? -1 : categoryIds[catIdx];
+        asset.status = PickStatus(rng);
+        asset.userId = (asset.status == std::string("在用")) ? rng.Pick(employees).id : -1;
+
+        char date[16];
+        std::snprintf(date, sizeof(date), "%04d-%02d-%02d",
+                      2015 + (int)rng.Uniform(11), 1 + (int)rng.Uniform(12), 1 + (int)rng.Uniform(28));
+        asset.purchaseDate = date;
+        asset.price = std::round((spec.minPrice + rng.Real() * (spec.maxPrice - spec.minPrice)) * 100) / 100;
+
+        char location[64];
+        std::snprintf(location, sizeof(location), "%s%d楼%d%02d", rng.Pick(kBuildings),
+                      1 + (int)rng.Uniform(12), 1 + (int)rng.Uniform(12), 1 + (int)rng.Uniform(30));
+        asset.location = location;
+        asset.remark = rng.Pick(kRemarks);
+        batch.push_back(std::move(asset));
+
+        if ((long long)batch.size() == batchRows || number == assetCount) {
+            auto start = Clock::now();
+            int inserted = db.AddAssets(batch);
+            double us = ElapsedMicros(start);
+            if (inserted != (int)batch.size()) {
+                std::fprintf(stderr, "批量插入资产失败: %s\n", db.GetLastError().c_str());
+                return false;
+            }
+            batchSamples.push_back(us);
+            importMs += us / 1000.0;
+            batch.clear();
+        }
+    }
+    runner.Add(Summarize("import.AddAssets(batch=5000)", std::move(batchSamples), assetCount, importMs));
+
+    // 变更日志：每个资产若干条，每 10000 条一个事务；变更时间按写入顺序均匀分布在三年内
+    static const char* const kLogFields[] = {"状态", "使用人", "存放位置", "备注", "价格"};
+    std::vector<double> logSamples;
+    double logMs = 0;
+    long long logTotal = assetCount * options.changeLogsPerAsset;
+    std::vector<AssetChangeLog> logs;
+    logs.reserve(10000);
+
+    for (long long i = 0; i < logTotal; i++) {
+        long long number = 1 + (long long)rng.Uniform((uint64_t)assetCount);
+        AssetChangeLog log;
+        log.id = 0;
+        log.assetId = (int)number;
+        log.assetCode = MakeAssetCode(number);
+        log.assetName = kCategories[number % 10].items[number % 4];
+        log.fieldName = rng.Pick(kLogFields);
+        log.oldValue = PickStatus(rng);
+        log.newValue = PickStatus(rng);
+        log.changeTime = kLogTimeBase + i * kLogTimeSpan / logTotal;
+        logs.push_back(std::move(log));
+
+        if (logs.size() == 10000 || i + 1 == logTotal) {
+            auto start = Clock::now();
+            db.BeginTransaction();
+            bool ok = db.AddChangeLogs(logs);
+            db.Commit();
+            double us = ElapsedMicros(start);
+            if (!ok) {
+                std::fprintf(stderr, "写入变更日志失败: %s\n", db.GetLastError().c_str());
+                return false;
+            }
+            logSamples.push_back(us);
+            logMs += us / 1000.0;
+            logs.clear();
+        }
+    }
+    if (logTotal > 0) {
+        runner.Add(Summarize("import.AddChangeLogs(batch=10000)", std::move(logSamples), logTotal, logMs));
+    }
+
+    dataset.generateSeconds = ElapsedMicros(generateStart) / 1e6;
+    return true;
+}
+
+// ========== 原导出实现（对照） ==========
+
+// ofstream 逐字段写出，金额按 "%f" 格式化（CsvWriter 之前的 CSVHelper::ExportToCSV）
+static void WriteCsvFieldStream(std::ostream& out, std::string_view field) {
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.write(field.data(), (std::streamsize)field.size());
+        return;
+    }
+    out.put('"');
+    size_t start = 0;
+    size_t quote;
+    while ((quote = field.find('"', start)) != std::string_view::npos) {
+        out.write(field.data() + start, (std::streamsize)(quote - start + 1));
+        out.put('"');
+        start = quote + 1;
+    }
+    out.write(field.data() + start, (std::streamsize)(field.size() - start));
+    out.put('"');
+}
+
+static long long ExportWithOfstream(Database& db, const std::string& path) {
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write("\xEF\xBB\xBF", 3);
+    file << "资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
+
+    long long rows = 0;
+    char priceBuf[64];
+    db.ForEachAsset(AssetFilter(), [&](const AssetRowView& row) {
+        const std::string_view text[] = {row.assetCode, row.name, row.categoryName, row.userName,
+                                         row.departmentName, row.purchaseDate};
+        for (std::string_view field : text) {
+            WriteCsvFieldStream(file, field);
+            file.put(',');
+        }
+        int priceLen = std::snprintf(priceBuf, sizeof(priceBuf), "%f", row.price);
+        WriteCsvFieldStream(file, std::string_view(priceBuf, (size_t)std::max(priceLen, 0)));
+        file.put(',');
+        WriteCsvFieldStream(file, row.location);
+        file.put(',');
+        WriteCsvFieldStream(file, row.status);
+        file.put(',');
+        WriteCsvFieldStream(file, row.remark);
+        file.put('\n');
+        rows++;
+        return true;
+    });
+    return rows;
+}
+
+// ========== 测试项 ==========
+
+static void RunQueryBenchmarks(Database& db, Dataset& dataset, const BenchOptions& options,
+                               BenchRunner& runner) {
+    Rng rng(options.seed * 31 + 7);
+    auto randomAssetId = [&]() {
+        return dataset.minAssetId + (int)rng.Uniform((uint64_t)(dataset.maxAssetId - dataset.minAssetId + 1));
+    };
+    auto randomStatus = [&]() { return std::string(PickStatus(rng)); };
+    auto randomCategory = [&]() { return rng.Pick(dataset.categoryIds); };
+
+    // ---- 单行读取 ----
+    runner.Run("GetAssetById", [&](int) {
+        Asset asset;
+        return db.GetAssetById(randomAssetId(), asset) ? 1LL : 0LL;
+    });
+
+    runner.Run("GetAssetByCode", [&](int) {
+        Asset asset;
+        long long number = 1 + (long long)rng.Uniform((uint64_t)dataset.assetCount);
+        return db.GetAssetByCode(MakeAssetCode(number), asset) ? 1LL : 0LL;
+    });
+
+    // ---- SearchAssets 各种过滤组合 ----
+    struct SearchCase {
+        const char* name;
+        bool text;
+        bool shortText;
+        bool category;
+        bool status;
+    };
+    static const SearchCase kSearchCases[] = {
+        {"SearchAssets(none)",                   false, false, false, false},
+        {"SearchAssets(text)",                   true,  false, false, false},
+        {"SearchAssets(short_text)",             true,  true,  false, false},
+        {"SearchAssets(category)",               false, false, true,  false},
+        {"SearchAssets(status)",                 false, false, false, true},
+        {"SearchAssets(text+category)",          true,  false, true,  false},
+        {"SearchAssets(text+status)",            true,  false, false, true},
+        {"SearchAssets(category+status)",        false, false, true,  true},
+        {"SearchAssets(text+category+status)",   true,  false, true,  true},
+    };
+
+    for (const SearchCase& sc : kSearchCases) {
+        runner.Run(sc.name, [&](int) {
+            std::string text;
+            if (sc.text) {
+                text = sc.shortText ? rng.Pick(kShortSearchTerms) : rng.Pick(kLongSearchTerms);
+            }
+            int categoryId = sc.category ? randomCategory() : -1;
+            std::string status = sc.status ? randomStatus() : "";
+            return (long long)db.SearchAssets(text, categoryId, status).size();
+        });
+    }
+
+    // ---- 键集分页 ----
+    static const std::pair<const char*, AssetSortField> kPageSorts[] = {
+        {"SearchAssetsPage(id,first)",    AssetSortField::Id},
+        {"SearchAssetsPage(name,first)",  AssetSortField::Name},
+        {"SearchAssetsPage(price,first)", AssetSortField::Price},
+    };
+    for (const auto& sort : kPageSorts) {
+        runner.Run(sort.first, [&](int) {
+            AssetFilter filter;
+            filter.sortField = sort.second;
+            return (long long)db.SearchAssetsPage(filter, AssetPageKey(), 200).size();
+        });
+    }
+
+    runner.Run("SearchAssetsPage(name,page10)", [&](int) {
+        AssetFilter filter;
+        filter.sortField = AssetSortField::Name;
+        filter.ascending = true;
+        AssetPageKey key;
+        long long rows = 0;
+        for (int page = 0; page < 10; page++) {
+            AssetPageKey next;
+            rows += (long long)db.SearchAssetsPage(filter, key, 200, &next).size();
+            if (!next.valid) break;
+            key = next;
+        }
+        return rows;
+    });
+
+    // ---- 全表流式读取 ----
+    runner.Run("ForEachAsset(all)", [&](int) {
+        long long rows = 0;
+        db.ForEachAsset(AssetFilter(), [&](const AssetRowView&) {
+            rows++;
+            return true;
+        });
+        return rows;
+    });
+
+    // ---- CSV 导出（全表写入文件） ----
+    std::string exportPath = dataset.path + ".export.csv";
+    runner.Run("ExportCsv(ofstream)", [&](int) {
+        return ExportWithOfstream(db, exportPath);
+    });
+    runner.Run("ExportCsv(CsvExporter)", [&](int) {
+        CsvExporter exporter(db);
+        long long rows = 0;
+        exporter.Export(exportPath, AssetFilter(), rows);
+        return rows;
+    });
+    {
+        std::error_code ec;
+        fs::remove(exportPath, ec);
+    }
+    // 写到空设备：只剩查询与格式化，扣除磁盘写入
+#ifdef _WIN32
+    const char* nullDevice = "NUL";
+#else
+    const char* nullDevice = "/dev/null";
+#endif
+    runner.Run("ExportCsv(ofstream,null)", [&](int) {
+        return ExportWithOfstream(db, nullDevice);
+    });
+    runner.Run("ExportCsv(CsvExporter,null)", [&](int) {
+        CsvExporter exporter(db);
+        long long rows = 0;
+        exporter.Export(nullDevice, AssetFilter(), rows);
+        return rows;
+    });
+
+    // ---- 统计 ----
+    runner.Run("GetAssetStats", [&](int) {
+        int count = 0;
+        double total = 0;
+        db.GetAssetStats(count, total);
+        return 1LL;
+    });
+
+    runner.Run("GetAssetSummary", [&](int) {
+        AssetSummary summary;
+        db.GetAssetSummary(summary);
+        return 1LL;
+    });
+
+    // ---- 参考数据 ----
+    runner.Run("GetAllCategories", [&](int) { return (long long)db.GetAllCategories().size(); });
+    runner.Run("GetAllDepartments", [&](int) { return (long long)db.GetAllDepartments().size(); });
+    runner.Run("GetAllEmployees", [&](int) { return (long long)db.GetAllEmployees().size(); });
+    runner.Run("GetAllEmployeeAssetCounts", [&](int) {
+        return (long long)db.GetAllEmployeeAssetCounts().size();
+    });
+    runner.Run("SearchEmployees(name)", [&](int) {
+        return (long long)db.SearchEmployees(rng.Pick(kSurnames)).size();
+    });
+
+    // 按姓名解析员工：每次迭代 1000 个姓名，对比逐次查询与字典缓存
+    runner.Run("ResolveEmployee x1000(GetEmployeesByName)", [&](int) {
+        long long found = 0;
+        for (int i = 0; i < 1000; i++) {
+            found += (long long)db.GetEmployeesByName(rng.Pick(dataset.employeeNames)).size();
+        }
+        return found;
+    });
+    ReferenceCache& refs = db.GetReferenceCache();
+    runner.Run("ResolveEmployee x1000(ReferenceCache)", [&](int) {
+        refs.Sync();
+        long long found = 0;
+        for (int i = 0; i < 1000; i++) {
+            found += (long long)refs.FindEmployeesByName(rng.Pick(dataset.employeeNames)).size();
+        }
+        return found;
+    });
+
+    // ---- 变更日志 ----
+    runner.Run("GetChangeLogCount", [&](int) {
+        db.GetChangeLogCount();
+        return 1LL;
+    });
+
+    runner.Run("GetAllChangeLogs(limit=100,first)", [&](int) {
+        return (long long)db.GetAllChangeLogs(100, 0).size();
+    });
+
+    runner.Run("GetAllChangeLogs(limit=100,middle)", [&](int) {
+        int offset = (int)(dataset.changeLogCount / 2);
+        return (long long)db.GetAllChangeLogs(100, offset).size();
+    });
+
+    runner.Run("GetChangeLogsBefore(limit=100,first)", [&](int) {
+        return (long long)db.GetChangeLogsBefore(ChangeLogPageKey(), 100).size();
+    });
+
+    // 与 OFFSET 分页的 middle 对比：从中间位置的键继续翻页
+    ChangeLogPageKey middleKey;
+    {
+        std::vector<AssetChangeLog> anchor = db.GetAllChangeLogs(1, (int)(dataset.changeLogCount / 2));
+        if (!anchor.empty()) {
+            middleKey.valid = true;
+            middleKey.changeTime = anchor[0].changeTime;
+            middleKey.id = anchor[0].id;
+        }
+    }
+    runner.Run("GetChangeLogsBefore(limit=100,middle)", [&](int) {
+        return (long long)db.GetChangeLogsBefore(middleKey, 100).size();
+    });
+
+    runner.Run("ChangeLogDataSource(first screen,text)", [&](int) {
+        ChangeLogDataSource source(db);
+        ChangeLogFilter filter;
+        filter.searchText = rng.Pick(kLongSearchTerms);
+        source.SetFilter(filter);
+        return (long long)source.LoadNextPage();
+    });
+
+    // 时间范围：随机取一个月 / 一年，按 (change_time, id) 索引定位
+    runner.Run("ForEachChangeLog(range=30d)", [&](int) {
+        ChangeLogTimeRange range;
+        range.from = kLogTimeBase + (long long)rng.Uniform((uint64_t)(kLogTimeSpan - 30 * 86400));
+        range.to = *range.from + 30 * 86400;
+        long long rows = 0;
+        db.ForEachChangeLog("", range, [&](const ChangeLogRowView&) {
+            rows++;
+            return true;
+        });
+        return rows;
+    });
+
+    runner.Run("GetChangeLogsBefore(range=365d,limit=100)", [&](int) {
+        ChangeLogFilter filter;
+        filter.time.from = kLogTimeBase + (long long)rng.Uniform((uint64_t)(kLogTimeSpan - 365 * 86400));
+        filter.time.to = *filter.time.from + 365 * 86400;
+        return (long long)db.GetChangeLogsBefore(ChangeLogPageKey(), 100, filter).size();
+    });
+
+    runner.Run("GetChangeLogsByAssetId", [&](int) {
+        return (long long)db.GetChangeLogsByAssetId(randomAssetId()).size();
+    });
+
+    runner.Run("ForEachChangeLog(text)", [&](int) {
+        long long rows = 0;
+        db.ForEachChangeLog(rng.Pick(kLongSearchTerms), ChangeLogTimeRange(), [&](const ChangeLogRowView&) {
+            rows++;
+            return true;
+        });
+        return rows;
+    });
+
+    // ---- 内存资产表 ----
+    if (runner.Enabled("AssetStore")) {
+        AssetStore store(db);
+        runner.Run("AssetStore.Load", [&](int) {
+            store.Load();
+            return (long long)store.Size();
+        });
+        runner.Run("AssetStore.Query(category)", [&](int) {
+            return (long long)store.Query(randomCategory()).size();
+        });
+    }
+
+    // ---- 写入 ----
+    Asset target;
+    runner.Run("UpdateAsset(with change log)", [&](int) {
+        return db.UpdateAsset(target) ? 1LL : 0LL;
+    }, [&](int i) {
+        db.GetAssetById(randomAssetId(), target);
+        target.status = randomStatus();
+        target.remark = "基准测试修改 " + std::to_string(i);
+        target.price += 1;
+    });
+
+    // 编号序列：单条 UPSERT 预留，与数量无关
+    std::string codePrefix = db.GetDefaultAssetCodePrefix();
+    runner.Run("ReserveAssetCodes(1)", [&](int) {
+        AssetCodeBlock block;
+        return db.ReserveAssetCodes(codePrefix, 1, block) ? 1LL : 0LL;
+    });
+    runner.Run("ReserveAssetCodes(10000)", [&](int) {
+        AssetCodeBlock block;
+        return db.ReserveAssetCodes(codePrefix, 10000, block) ? 10000LL : 0LL;
+    });
+
+    // 新增的资产随后删除，使数据集保持原样以便 --reuse
+    long long nextNumber = dataset.assetCount + 1;
+    std::vector<int> addedIds;
+    runner.Run("AddAsset", [&](int) {
+        Asset asset;
+        asset.id = 0;
+        asset.assetCode = MakeAssetCode(nextNumber++);
+        asset.name = "基准测试新增资产";
+        asset.categoryId = randomCategory();
+        asset.userId = rng.Pick(dataset.employeeIds);
+        asset.purchaseDate = "2024-06-01";
+        asset.price = 1999;
+        asset.status = "在用";
+        if (!db.AddAsset(asset)) {
+            return 0LL;
+        }
+        addedIds.push_back(asset.id);
+        return 1LL;
+    });
+
+    runner.Run("DeleteAsset", [&](int) {
+        if (addedIds.empty()) {
+            return 0LL;
+        }
+        int id = addedIds.back();
+        addedIds.pop_back();
+        return db.DeleteAsset(id) ? 1LL : 0LL;
+    });
+
+    for (int id : addedIds) {
+        db.DeleteAsset(id);
+    }
+}
+
+/**
+ * @brief 读写并发：N 个读线程经只读连接池搜索，主线程同时经写连接更新
+ */
+static void RunConcurrencyBenchmarks(Database& db, Dataset& dataset, const BenchOptions& options,
+                                     BenchRunner& runner) {
+    for (int readers : options.readers) {
+        std::string prefix = "concurrent(readers=" + std::to_string(readers) + ").";
+        if (readers <= 0 || options.concurrencyMs <= 0 ||
+            (!runner.Enabled(prefix + "SearchAssets") && !runner.Enabled(prefix + "UpdateAsset"))) {
+            continue;
+        }
+
+        ReadConnectionPool pool;
+        if (!pool.Open(dataset.path, readers)) {
+            std::fprintf(stderr, "打开只读连接池失败: %s\n", pool.GetLastError().c_str());
+            continue;
+        }
+
+        std::atomic<bool> stop{false};
+        std::vector<std::vector<double>> readSamples((size_t)readers);
+        std::vector<std::thread> threads;
+        auto start = Clock::now();
+
+        for (int t = 0; t < readers; t++) {
+            threads.emplace_back([&, t]() {
+                Rng rng(options.seed + 1000 + (uint64_t)t);
+                while (!stop.load()) {
+                    std::string text = rng.Pick(kLongSearchTerms);
+                    int categoryId = rng.Chance(0.5) ? rng.Pick(dataset.categoryIds) : -1;
+                    auto begin = Clock::now();
+                    {
+                        ReadLease lease = pool.Acquire();
+                        if (!lease) break;
+                        lease->SearchAssets(text, categoryId);
+                    }
+                    readSamples[(size_t)t].push_back(ElapsedMicros(begin));
+                }
+            });
+        }
+
+        Rng rng(options.seed + 999);
+        std::vector<double> writeSamples;
+        Asset asset;
+        int span = dataset.maxAssetId - dataset.minAssetId + 1;
+        while (ElapsedMicros(start) < options.concurrencyMs * 1000.0) {
+            if (!db.GetAssetById(dataset.minAssetId + (int)rng.Uniform((uint64_t)span), asset)) {
+                continue;
+            }
+            asset.remark = "并发测试 " + std::to_string(writeSamples.size());
+            auto begin = Clock::now();
+            db.UpdateAsset(asset);
+            writeSamples.push_back(ElapsedMicros(begin));
+        }
+
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double wallMs = ElapsedMicros(start) / 1000.0;
+        pool.Close();
+
+        std::vector<double> allReads;
+        for (const auto& samples : readSamples) {
+            allReads.insert(allReads.end(), samples.begin(), samples.end());
+        }
+        long long reads = (long long)allReads.size();
+        long long writes = (long long)writeSamples.size();
+        runner.Add(Summarize(prefix + "SearchAssets", std::move(allReads), reads, wallMs));
+        runner.Add(Summarize(prefix + "UpdateAsset", std::move(writeSamples), writes, wallMs));
+    }
+}
+
+// ========== 正确性检查 ==========
+//
+// 检查失败时打印原因，基准结果照常写出，asset_bench 以非 0 退出。
+
+/**
+ * @brief 语句缓存：已借出（绑定后尚未 step）的语句不会再次借出；缓存满时淘汰最久未用的空闲语句，
+ * 常用语句留在缓存中
+ */
+static bool CheckStatementCache() {
+    std::vector<std::string> failures;
+    sqlite3* conn = nullptr;
+    if (sqlite3_open(":memory:", &conn) != SQLITE_OK) {
+        std::fprintf(stderr, "  check.StatementCache: 打开内存数据库失败\n");
+        sqlite3_close(conn);
+        return false;
+    }
+
+    const size_t capacity = 4;
+    {
+        StatementCache cache(capacity);
+        cache.Attach(conn);
+
+        // 重入：外层已绑定参数但尚未 step 时，内层取同一 SQL 应得到另一个句柄
+        {
+            Statement outer = cache.Acquire("SELECT ?1");
+            sqlite3_bind_int(outer, 1, 42);
+            {
+                Statement inner = cache.Acquire("SELECT ?1");
+                if (!inner || (sqlite3_stmt*)inner == (sqlite3_stmt*)outer) {
+                    failures.push_back("已绑定未 step 的语句被重复借出");
+                }
+                sqlite3_bind_int(inner, 1, 7);
+            }
+            if (sqlite3_step(outer) != SQLITE_ROW || sqlite3_column_int(outer, 0) != 42) {
+                failures.push_back("内层借用改写了外层语句的绑定");
+            }
+        }
+
+        // 淘汰：热点语句与 20 条不同的语句交替使用，缓存不超过容量且热点语句一直命中
+        cache.ResetStats();
+        const char* hot = "SELECT ?1";
+        int hotHits = 0;
+        for (int i = 0; i < 20; i++) {
+            uint64_t hitsBefore = cache.GetStats().hits;
+            { Statement stmt = cache.Acquire(hot); }
+            if (cache.GetStats().hits == hitsBefore + 1) {
+                hotHits++;
+            }
+            std::string sql = "SELECT " + std::to_string(i);
+            Statement stmt = cache.Acquire(sql);
+            if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) {
+                failures.push_back("执行 " + sql + " 失败");
+            }
+        }
+        StatementCacheStats stats = cache.GetStats();
+        if (stats.size > capacity) {
+            failures.push_back("缓存 " + std::to_string(stats.size) + " 条，超过容量 " + std::to_string(capacity));
+        }
+        if (stats.evictions == 0) {
+            failures.push_back("缓存已满时没有淘汰");
+        }
+        if (hotHits != 20) {
+            failures.push_back("热点语句 20 次中只命中 " + std::to_string(hotHits) + " 次");
+        }
+
+        // 全部借出时不淘汰借出的语句，退化为一次性语句
+        {
+            std::vector<Statement> held;
+            for (size_t i = 0; i < capacity; i++) {
+                held.push_back(cache.Acquire("SELECT 'held" + std::to_string(i) + "'"));
+            }
+            Statement extra = cache.Acquire("SELECT 'extra'");
+            for (Statement& stmt : held) {
+                if (sqlite3_step(stmt) != SQLITE_ROW) {
+                    failures.push_back("缓存满时借出的语句被 finalize");
+                    break;
+                }
+            }
+            if (!extra || sqlite3_step(extra) != SQLITE_ROW) {
+                failures.push_back("全部借出时未返回一次性语句");
+            }
+        }
+        cache.Clear();
+    }
+    sqlite3_close(conn);
+
+    if (!failures.empty()) {
+        for (const auto& failure : failures) {
+            std::fprintf(stderr, "  check.StatementCache: %s\n", failure.c_str());
+        }
+        return false;
+    }
+    std::printf("  %-48s 通过  容量 %zu，重入与淘汰行为正确\n", "check.StatementCache", capacity);
+    return true;
+}
+
+/**
+ * @brief 键集分页：金额、状态、购置日期含 NULL 时，逐页拼接的结果与 ForEachAsset 的完整顺序一致
+ *
+ * 使用独立的临时数据库，NULL 值经原始连接写入（Database 接口不会写 NULL）。
+ */
+static bool CheckAssetPaging(const BenchOptions& options) {
+    std::vector<std::string> failures;
+    std::string path = (fs::path(options.dataDir) / "check_paging.db").string();
+    RemoveDatabaseFiles(path);
+
+    Database db;
+    if (!db.Initialize(path)) {
+        std::fprintf(stderr, "  check.AssetPaging: 初始化失败\n");
+        return false;
+    }
+
+    // 键值大量重复，页边界必然落在相同键中间
+    const char* statuses[] = {"在用", "闲置", "维修中"};
+    const int total = 60;
+    for (int i = 0; i < total; i++) {
+        Asset asset{};
+        asset.categoryId = -1;
+        asset.userId = -1;
+        char code[16];
+        std::snprintf(code, sizeof(code), "PG%04d", i);
+        asset.assetCode = code;
+        asset.name = "分页资产" + std::to_string(i);
+        asset.purchaseDate = (i % 4 == 0) ? "" : "2024-0" + std::to_string(1 + i % 5) + "-01";
+        asset.price = (double)(i % 6) * 100.0;
+        asset.status = statuses[i % 3];
+        if (!db.AddAsset(asset)) {
+            failures.push_back("新增资产失败: " + db.GetLastError());
+            break;
+        }
+    }
+
+    sqlite3* raw = nullptr;
+    if (failures.empty()) {
+        const char* sql =
+            "UPDATE assets SET price = NULL WHERE id % 5 = 0;"
+            "UPDATE assets SET status = NULL WHERE id % 7 = 0;"
+            "UPDATE assets SET purchase_date = NULL WHERE id % 8 = 1;";
+        if (sqlite3_open(path.c_str(), &raw) != SQLITE_OK ||
+            sqlite3_exec(raw, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            failures.push_back(std::string("写入 NULL 失败: ") + sqlite3_errmsg(raw));
+        }
+        sqlite3_close(raw);
+    }
+
+    const AssetSortField fields[] = {AssetSortField::Price, AssetSortField::Status,
+                                     AssetSortField::PurchaseDate};
+    const char* fieldNames[] = {"金额", "状态", "购置日期"};
+    const char* statusFilters[] = {"", "闲置"};
+    int combos = 0;
+    for (int f = 0; failures.empty() && f < 3; f++) {
+        for (const char* status : statusFilters) {
+            for (bool ascending : {true, false}) {
+                AssetFilter filter;
+                filter.sortField = fields[f];
+                filter.ascending = ascending;
+                filter.status = status;
+
+                std::vector<int> expected;
+                db.ForEachAsset(filter, [&](const AssetRowView& row) {
+                    expected.push_back(row.id);
+                    return true;
+                });
+
+                std::vector<int> paged;
+                AssetPageKey key;
+                for (int page = 0; page <= total; page++) {
+                    AssetPageKey next;
+                    std::vector<Asset> rows = db.SearchAssetsPage(filter, key, 7, &next);
+                    for (const auto& asset : rows) {
+                        paged.push_back(asset.id);
+                    }
+                    if (rows.size() < 7) {
+                        break;
+                    }
+                    key = next;
+                }
+
+                combos++;
+                if (paged != expected || expected.empty()) {
+                    failures.push_back(std::string("按") + fieldNames[f] + (ascending ? "升序" : "降序") +
+                                       (*status ? "（筛选 " + std::string(status) + "）" : "") +
+                                       "分页得到 " + std::to_string(paged.size()) + " 行，完整顺序 " +
+                                       std::to_string(expected.size()) + " 行，顺序不一致");
+                }
+            }
+        }
+    }
+
+    db.Close();
+    RemoveDatabaseFiles(path);
+
+    if (!failures.empty()) {
+        for (const auto& failure : failures) {
+            std::fprintf(stderr, "  check.AssetPaging: %s\n", failure.c_str());
+        }
+        return false;
+    }
+    std::printf("  %-48s 通过  %d 种排序与筛选组合逐页一致\n", "check.AssetPaging", combos);
+    return true;
+}
+
+/**
+ * @brief 内存资产表：新增、修改、删除、导入与回滚之后，增量维护的内存数据与数据库逐行一致
+ *
+ * 各步写入都在 Load 之后经同一写连接完成，由 update hook 累积变更；结束时删除新增的资产、
+ * 还原修改，数据集保持原样以便 --reuse。
+ */
+static bool CheckAssetStore(Database& db, const Dataset& dataset, const BenchOptions& options) {
+    std::vector<std::string> failures;
+    AssetStore store(db);
+    if (!store.Load()) {
+        std::fprintf(stderr, "  check.AssetStore: 加载失败\n");
+        return false;
+    }
+
+    int steps = 0;
+    auto verify = [&](const char* step) {
+        steps++;
+        std::vector<std::string> differences;
+        if (store.VerifyConsistency(&differences)) {
+            return;
+        }
+        std::string message = std::string(step) + " 后与数据库有 " + std::to_string(differences.size()) + " 处差异";
+        for (size_t i = 0; i < differences.size() && i < 5; i++) {
+            message += "\n    " + differences[i];
+        }
+        failures.push_back(message);
+    };
+
+    Rng rng(options.seed * 131 + 17);
+    std::vector<int> addedIds;
+    std::vector<std::string> categoryNames;
+    for (const Category& category : db.GetAllCategories()) {
+        categoryNames.push_back(category.name);
+    }
+
+    // 新增
+    for (int i = 0; i < 20; i++) {
+        Asset asset{};
+        asset.id = 0;
+        asset.assetCode = "CHECK-STORE-ADD-" + std::to_string(i);
+        asset.name = "内存表检查新增资产";
+        asset.categoryId = rng.Pick(dataset.categoryIds);
+        asset.userId = i % 4 == 0 ? -1 : rng.Pick(dataset.employeeIds);
+        asset.purchaseDate = "2024-06-01";
+        asset.price = 100 + i;
+        asset.status = "在用";
+        if (db.AddAsset(asset)) {
+            addedIds.push_back(asset.id);
+        }
+    }
+    verify("新增");
+
+    // 修改：资产字段与分类名称（显示名刷新）
+    std::vector<Asset> originals;
+    for (int i = 0; i < 20; i++) {
+        Asset asset;
+        int id = dataset.minAssetId + (int)rng.Uniform((uint64_t)(dataset.maxAssetId - dataset.minAssetId + 1));
+        if (!db.GetAssetById(id, asset)) {
+            continue;
+        }
+        originals.push_back(asset);
+        asset.status = "维修中";
+        asset.remark = "内存表检查修改";
+        asset.userId = rng.Pick(dataset.employeeIds);
+        db.UpdateAsset(asset);
+    }
+    Category renamed;
+    bool categoryRenamed = db.GetCategoryById(rng.Pick(dataset.categoryIds), renamed);
+    std::string originalName = renamed.name;
+    if (categoryRenamed) {
+        renamed.name = originalName + "（检查）";
+        categoryRenamed = db.UpdateCategory(renamed);
+    }
+    verify("修改");
+    if (categoryRenamed) {
+        renamed.name = originalName;
+        db.UpdateCategory(renamed);
+    }
+
+    // 删除
+    for (int i = 0; i < 5 && !addedIds.empty(); i++) {
+        db.DeleteAsset(addedIds.back());
+        addedIds.pop_back();
+    }
+    verify("删除");
+
+    // 导入：批量写入走 bulk load，只用已有的分类，不新建字典行
+    const int importRows = 600;
+    std::string csvPath = (fs::path(options.dataDir) / "check_asset_store.csv").string();
+    {
+        std::ofstream file(csvPath, std::ios::binary);
+        file << "\xEF\xBB\xBF资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
+        for (int i = 0; i < importRows; i++) {
+            file << "CHECK-STORE-IMPORT-" << i << ",内存表检查导入资产,"
+                 << (categoryNames.empty() ? "" : rng.Pick(categoryNames))
+                 << ",,,2024-06-01," << 10 + i << ",,闲置,\n";
+        }
+    }
+    CsvImportOptions importOptions;
+    importOptions.batchRows = 250;
+    CsvImporter importer(db, importOptions);
+    CsvImportResult imported;
+    if (!importer.Import(csvPath, imported) || imported.successCount != importRows) {
+        failures.push_back("导入 " + std::to_string(importRows) + " 行只写入 " +
+                           std::to_string(imported.successCount) + " 行: " + importer.GetLastError());
+    }
+    std::error_code ec;
+    fs::remove(csvPath, ec);
+    verify("导入");
+    for (int i = 0; i < importRows; i++) {
+        Asset asset;
+        if (db.GetAssetByCode("CHECK-STORE-IMPORT-" + std::to_string(i), asset)) {
+            addedIds.push_back(asset.id);
+        }
+    }
+
+    // 回滚：事务内的修改已同步进内存后再回滚
+    db.BeginTransaction();
+    for (size_t i = 0; i < originals.size(); i++) {
+        Asset asset = originals[i];
+        asset.remark = "内存表检查：将回滚";
+        db.UpdateAsset(asset);
+    }
+    if (!addedIds.empty()) {
+        db.DeleteAsset(addedIds.front());
+    }
+    store.Size();
+    db.Rollback();
+    verify("回滚");
+
+    // 还原数据集
+    for (int id : addedIds) {
+        db.DeleteAsset(id);
+    }
+    for (const Asset& asset : originals) {
+        db.UpdateAsset(asset);
+    }
+    verify("还原");
+
+    if (!failures.empty()) {
+        for (const auto& failure : failures) {
+            std::fprintf(stderr, "  check.AssetStore: %s\n", failure.c_str());
+        }
+        return false;
+    }
+    AssetStoreStats stats = store.GetStats();
+    std::printf("  %-48s 通过  %d 步写入后逐行一致（整表加载 %llu 次，增量重读 %llu 行）\n",
+                "check.AssetStore", steps, (unsigned long long)stats.fullLoads,
+                (unsigned long long)stats.rowRefreshes);
+    return true;
+}
+
+/**
+ * @brief 后台搜索执行器：执行中的慢查询被取代时中止，排队的旧请求不执行，只投递最新代号的结果
+ *
+ * 慢查询用逐行休眠的 ForEachAsset 模拟：语句仍在 sqlite3_step 中，只有进度回调能让它提前结束，
+ * 不中止时扫完整表至少需要 资产数 × 200us。
+ */
+static bool CheckAsyncSearchExecutor(Database& db, const Dataset& dataset) {
+    std::mutex mutex;
+    std::condition_variable delivered;
+    std::vector<AsyncSearchResult> results;
+    AsyncSearchExecutor executor([&](AsyncSearchResult&& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(std::move(result));
+        delivered.notify_all();
+    });
+    if (!executor.Start(dataset.path)) {
+        std::fprintf(stderr, "  check.AsyncSearchExecutor: 启动失败: %s\n", executor.GetLastError().c_str());
+        return false;
+    }
+
+    std::atomic<long long> slowRows{0};
+    std::atomic<bool> slowFinished{false};
+    std::atomic<bool> slowCompleted{false};
+    Clock::time_point slowEnd;
+    executor.SubmitTask([&](Database& worker) {
+        bool completed = worker.ForEachAsset(AssetFilter(), [&](const AssetRowView&) {
+            slowRows++;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            return true;
+        });
+        slowEnd = Clock::now();
+        slowCompleted = completed;
+        slowFinished = true;
+        return std::vector<Asset>{Asset{}};
+    });
+
+    // 慢查询已开始返回行后再提交新请求
+    auto waitStart = Clock::now();
+    while (slowRows.load() == 0 && !slowFinished.load() && ElapsedMicros(waitStart) < 5e6) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<bool> queuedRan{false};
+    executor.SubmitTask([&](Database&) {
+        queuedRan = true;
+        return std::vector<Asset>{Asset{}};
+    });
+    AssetFilter filter;
+    filter.categoryId = dataset.categoryIds.empty() ? -1 : dataset.categoryIds.front();
+    auto supersededAt = Clock::now();
+    uint64_t latest = executor.Submit(filter);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        delivered.wait_for(lock, std::chrono::seconds(10), [&] { return !results.empty(); });
+    }
+    // 给可能迟到的过期结果留出时间，再停止执行器
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    executor.Stop();
+
+    std::vector<std::string> failures;
+    if (!slowFinished.load() || slowCompleted.load() || slowRows.load() >= dataset.assetCount) {
+        failures.push_back("慢查询未被中止（已扫描 " + std::to_string(slowRows.load()) + " 行）");
+    }
+    if (queuedRan.load()) {
+        failures.push_back("被取代的排队请求仍然执行");
+    }
+    size_t expected = db.SearchAssets("", filter.categoryId, "").size();
+    if (results.size() != 1) {
+        failures.push_back("收到 " + std::to_string(results.size()) + " 个结果，应只收到最新请求的 1 个");
+    } else if (results[0].generation != latest) {
+        failures.push_back("收到代号 " + std::to_string(results[0].generation) +
+                           " 的结果，最新代号为 " + std::to_string(latest));
+    } else if (results[0].assets.size() != expected) {
+        failures.push_back("最新结果 " + std::to_string(results[0].assets.size()) +
+                           " 行，同步查询 " + std::to_string(expected) + " 行");
+    }
+
+    if (!failures.empty()) {
+        for (const auto& failure : failures) {
+            std::fprintf(stderr, "  check.AsyncSearchExecutor: %s\n", failure.c_str());
+        }
+        return false;
+    }
+    double abortMs = std::chrono::duration<double, std::milli>(slowEnd - supersededAt).count();
+    std::printf("  %-48s 通过  慢查询扫描 %lld 行后中止，取代后 %.2f ms 结束\n",
+                "check.AsyncSearchExecutor", slowRows.load(), abortMs);
+    return true;
+}
+
+/**
+ * @brief 只读连接池：N 个连接能同时借出，写事务未提交时读者不被阻塞且只看到已提交的数据；
+ * 持有租约时关闭或销毁连接池都不等待，迟归还的连接随后关闭
+ *
+ * 可能阻塞的步骤放在单独线程上并限时等待，回归时报告失败而不是挂起。
+ */
+static bool CheckReadConnectionPool(Database& db, const Dataset& dataset, const BenchOptions& options) {
+    std::vector<std::string> failures;
+    int readers = 2;
+    for (int n : options.readers) {
+        readers = std::max(readers, n);
+    }
+
+    ReadConnectionPool pool;
+    Asset target;
+    if (!pool.Open(dataset.path, readers) || !db.GetAssetById(dataset.minAssetId, target)) {
+        std::fprintf(stderr, "  check.ReadConnectionPool: 准备失败: %s\n", pool.GetLastError().c_str());
+        return false;
+    }
+
+    // 写连接持有未提交的修改，读者应不受阻塞并看到修改前的值
+    std::string committedRemark = target.remark;
+    db.BeginTransaction();
+    target.remark = "连接池检查：未提交";
+    db.UpdateAsset(target);
+
+    std::atomic<int> holding{0};
+    std::atomic<int> sawCommitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&]() {
+            ReadLease lease = pool.Acquire();
+            if (!lease) {
+                return;
+            }
+            // 所有读者同时持有连接后再查询
+            holding++;
+            auto waitStart = Clock::now();
+            while (holding.load() < readers && ElapsedMicros(waitStart) < 5e6) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            Asset seen;
+            if (lease->GetAssetById(target.id, seen) && seen.remark == committedRemark) {
+                sawCommitted++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    db.Rollback();
+
+    if (holding.load() != readers) {
+        failures.push_back(std::to_string(readers) + " 个读者中只有 " +
+                           std::to_string(holding.load()) + " 个借到连接");
+    }
+    if (sawCommitted.load() != readers) {
+        failures.push_back("写事务未提交时只有 " + std::to_string(sawCommitted.load()) +
+                           " 个读者读到已提交的数据");
+    }
+
+    // 本线程持有租约时关闭连接池
+    {
+        ReadLease held = pool.Acquire();
+        std::atomic<bool> closed{false};
+        std::thread closer([&] {
+            pool.Close();
+            closed = true;
+        });
+        auto waitStart = Clock::now();
+        while (!closed.load() && ElapsedMicros(waitStart) < 2e6) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!closed.load()) {
+            failures.push_back("Close 等待本线程持有的租约归还");
+        }
+        Asset seen;
+        if (!held || !held->GetAssetById(target.id, seen)) {
+            failures.push_back("关闭后已借出的连接不可用");
+        }
+        held.Release();
+        closer.join();
+        if (pool.Acquire()) {
+            failures.push_back("关闭后仍能借出连接");
+        }
+    }
+
+    // 租约比连接池活得久：析构不等待，租约归还时关闭连接
+    {
+        ReadLease orphan;
+        std::atomic<bool> acquired{false};
+        std::atomic<bool> destroyed{false};
+        std::thread owner([&] {
+            {
+                ReadConnectionPool temporary;
+                if (temporary.Open(dataset.path, 1)) {
+                    orphan = temporary.Acquire();
+                }
+                acquired = true;
+            }
+            destroyed = true;
+        });
+        auto waitStart = Clock::now();
+        while (!destroyed.load() && ElapsedMicros(waitStart) < 2e6) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!destroyed.load()) {
+            failures.push_back("连接池析构等待未归还的租约");
+        }
+        Asset seen;
+        if (destroyed.load() && (!orphan || !orphan->GetAssetById(target.id, seen))) {
+            failures.push_back("连接池销毁后租约不可用");
+        }
+        while (!acquired.load()) {
+            std::this_thread::yield();
+        }
+        orphan.Release();
+        owner.join();
+    }
+
+    if (!failures.empty()) {
+        for (const auto& failure : failures) {
+            std::fprintf(stderr, "  check.ReadConnectionPool: %s\n", failure.c_str());
+        }
+        return false;
+    }
+    std::printf("  %-48s 通过  %d 个读者在未提交的写事务期间同时查询\n",
+                "check.ReadConnectionPool", readers);
+    return true;
+}
+
+// ========== JSON 输出 ==========
+
+static std::string JsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    return out;
+}
+
+static std::string JsonNumber(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", std::isfinite(value) ? value : 0.0);
+    return buf;
+}
+
+static bool WriteJson(const std::string& path, const BenchOptions& options,
+                      const std::vector<Dataset>& datasets) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"benchmark\": \"asset_bench\",\n";
+    out << "  \"format_version\": 1,\n";
+    out << "  \"timestamp\": \"" << timestamp << "\",\n";
+    out << "  \"sqlite_version\": \"" << JsonEscape(sqlite3_libversion()) << "\",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"iterations\": " << options.iterations << ",\n";
+    out << "  \"budget_ms\": " << options.budgetMs << ",\n";
+    out << "  \"datasets\": [\n";
+
+    for (size_t d = 0; d < datasets.size(); d++) {
+        const Dataset& dataset = datasets[d];
+        std::error_code ec;
+        auto bytes = fs::file_size(dataset.path, ec);
+
+        out << "    {\n";
+        out << "      \"assets\": " << dataset.assetCount << ",\n";
+        out << "      \"employees\": " << dataset.employeeIds.size() << ",\n";
+        out << "      \"categories\": " << dataset.categoryIds.size() << ",\n";
+        out << "      \"departments\": " << dataset.departmentIds.size() << ",\n";
+        out << "      \"change_logs\": " << dataset.changeLogCount << ",\n";
+        out << "      \"db_bytes\": " << (ec ? 0 : (unsigned long long)bytes) << ",\n";
+        out << "      \"generate_seconds\": " << JsonNumber(dataset.generateSeconds) << ",\n";
+        out << "      \"results\": [\n";
+
+        for (size_t r = 0; r < dataset.results.size(); r++) {
+            const BenchResult& result = dataset.results[r];
+            out << "        {\"name\": \"" << JsonEscape(result.name) << "\""
+                << ", \"iterations\": " << result.iterations
+                << ", \"items\": " << result.items
+                << ", \"total_ms\": " << JsonNumber(result.totalMs)
+                << ", \"mean_us\": " << JsonNumber(result.meanUs)
+                << ", \"p50_us\": " << JsonNumber(result.p50Us)
+                << ", \"p90_us\": " << JsonNumber(result.p90Us)
+                << ", \"p99_us\": " << JsonNumber(result.p99Us)
+                << ", \"max_us\": " << JsonNumber(result.maxUs)
+                << ", \"throughput_per_s\": " << JsonNumber(result.throughput) << "}"
+                << (r + 1 < dataset.results.size() ? "," : "") << "\n";
+        }
+
+        out << "      ]\n";
+        out << "    }" << (d + 1 < datasets.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n";
+    out << "}\n";
+    return (bool)out;
+}
+
+// ========== 主流程 ==========
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.dataDir, ec);
+
+    std::vector<Dataset> datasets;
+    bool checksPassed = true;
+    for (long long size : options.sizes) {
+        Dataset dataset;
+        dataset.path = (fs::path(options.dataDir) / ("bench_" + std::to_string(size) + ".db")).string();
+        std::printf("== 数据集 %lld 条资产 (%s)\n", size, dataset.path.c_str());
+
+        BenchRunner runner(options);
+        Database db;
+
+        bool reused = false;
+        if (options.reuse && fs::exists(dataset.path) && db.Initialize(dataset.path)) {
+            reused = LoadReferenceData(db, dataset) && dataset.assetCount == size;
+            if (!reused) {
+                db.Close();
+            }
+        }
+
+        if (!reused) {
+            RemoveDatabaseFiles(dataset.path);
+            if (!db.Initialize(dataset.path)) {
+                std::fprintf(stderr, "数据库初始化失败: %s\n", db.GetLastError().c_str());
+                return 1;
+            }
+            if (!GenerateDataset(db, dataset, size, options, runner) ||
+                !LoadReferenceData(db, dataset)) {
+                return 1;
+            }
+        }
+
+        RunQueryBenchmarks(db, dataset, options, runner);
+        RunConcurrencyBenchmarks(db, dataset, options, runner);
+
+        if (runner.Enabled("check.StatementCache") && !CheckStatementCache()) {
+            checksPassed = false;
+        }
+        if (runner.Enabled("check.AssetPaging") && !CheckAssetPaging(options)) {
+            checksPassed = false;
+        }
+        if (runner.Enabled("check.AssetStore") && !CheckAssetStore(db, dataset, options)) {
+            checksPassed = false;
+        }
+        if (runner.Enabled("check.ReadConnectionPool") && !CheckReadConnectionPool(db, dataset, options)) {
+            checksPassed = false;
+        }
+        if (runner.Enabled("check.AsyncSearchExecutor") && !CheckAsyncSearchExecutor(db, dataset)) {
+            checksPassed = false;
+        }
+
+        // 启动耗时：打开已是最新结构版本的数据库（迁移快速路径）并关闭
+        runner.Run("startup.Initialize", [&](int) {
+            Database other;
+            return other.Initialize(dataset.path) ? 1LL : 0LL;
+        });
+
+        StatementCacheStats cache = db.GetStatementCacheStats();
+        std::printf("  语句缓存: 命中 %llu, 未命中 %llu, 淘汰 %llu, 缓存 %zu 条\n",
+                    (unsigned long long)cache.hits, (unsigned long long)cache.misses,
+                    (unsigned long long)cache.evictions, cache.size);
+
+        dataset.results = runner.TakeResults();
+        datasets.push_back(std::move(dataset));
+    }
+
+    if (!WriteJson(options.outPath, options, datasets)) {
+        std::fprintf(stderr, "写入结果文件失败: %s\n", options.outPath.c_str());
+        return 1;
+    }
+    std::printf("结果已写入 %s\n", options.outPath.c_str());
+    if (!checksPassed) {
+        std::fprintf(stderr, "正确性检查未通过\n");
+        return 1;
+    }
+    return 0;
+}
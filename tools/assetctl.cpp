@@ -0,0 +1,833 @@
+/**
+ * @file assetctl.cpp
+ * @brief 资产管理命令行工具
+ *
+ * 不含界面代码，直接调用数据层（asset_core），供 ERP 夜间批量导入等无人值守任务调用和计时：
+ *
+ *   assetctl --db assets.db validate erp_20240501.csv --report erp_20240501.errors.csv
+ *   assetctl --db assets.db import erp_20240501.csv
+ *   assetctl --db assets.db export assets.csv --status 在用 --encoding gbk
+ *   assetctl --db assets.db search 笔记本 --limit 20
+ *   assetctl --db assets.db stats
+ *   assetctl --db assets.db changelog --since 2024-05-01
+ *
+ * 输出为 JSON Lines（每行一个 UTF-8 JSON 对象）：逐行数据（资产、变更日志、导入的逐行信息）在前，
+ * 最后一行是 "type":"result" 的汇总，含 ok 与 elapsed_ms。
+ * 退出码：0 成功，1 执行失败（汇总行的 error 给出原因），2 参数错误（用法打印到 stderr），
+ * 3 validate 检查出问题。
+ */
+
+#include "CsvExporter.h"
+#include "CsvImporter.h"
+#include "CsvImportReport.h"
+#include "database.h"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <shellapi.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static const int kExitOk = 0;
+static const int kExitFailed = 1;
+static const int kExitUsage = 2;
+static const int kExitInvalid = 3;      // validate 发现问题
+
+static void PrintUsage() {
+    std::fprintf(stderr,
+        "用法: assetctl [--db FILE] <命令> [参数]\n"
+        "\n"
+        "命令:\n"
+        "  import FILE       导入 CSV（UTF-8 带 BOM 或 GBK）\n"
+        "      --workers N   解析线程数（默认按 CPU 核数，0 串行）\n"
+        "      --batch N     每个事务写入的行数（默认 5000）\n"
+        "      --report R    逐行信息写入 CSV 报告 R（行号,信息），不输出到 stdout\n"
+        "      --quiet       不输出逐行信息，只输出汇总\n"
+        "      --strict      日期、金额、状态不规范的行不导入（默认照常写入）\n"
+        "  validate FILE     只检查不写入：名称必填、日期、金额、状态，编号在文件内与数据库中是否重复\n"
+        "                    不规范但导入时照常写入的行计入 non_standard\n"
+        "                    （--workers、--report、--quiet、--strict 同 import；有问题时退出码为 3）\n"
+        "  export FILE       导出资产到 CSV（可直接重新导入）\n"
+        "      --encoding E  utf8（默认，带 BOM）或 gbk（无 BOM，GBK 中没有的字符写为 ?）\n"
+        "  search [TEXT]     搜索资产，每行输出一个资产\n"
+        "      --limit N     最多输出的行数（默认 100，0 不限）\n"
+        "  stats             资产总数、总价值及按状态、分类、部门的分组\n"
+        "  changelog [TEXT]  变更日志（按时间倒序）\n"
+        "      --since T     起始日期 YYYY-MM-DD（含）或 Unix 时间戳\n"
+        "      --until T     结束日期 YYYY-MM-DD（含全天）或 Unix 时间戳（不含）\n"
+        "      --limit N     最多输出的行数（默认 100，0 不限）\n"
+        "  template FILE     生成导入模板\n"
+        "\n"
+        "export / search 的筛选条件:\n"
+        "  --text S          搜索关键词（search 也可用位置参数）\n"
+        "  --category ID     分类 ID\n"
+        "  --status S        状态\n"
+        "  --sort FIELD      id|code|name|category|user|date|price|location|status|remark（默认 id）\n"
+        "  --asc             升序（默认降序）\n"
+        "\n"
+        "全局选项:\n"
+        "  --db FILE         数据库文件（默认 assets.db）\n"
+        "\n"
+        "输出为 JSON Lines，最后一行是 \"type\":\"result\" 的汇总。\n"
+        "退出码：0 成功，1 执行失败，2 参数错误，3 validate 发现问题。\n");
+}
+
+// ========== JSON 输出 ==========
+
+/**
+ * @brief 单行 JSON 对象，字段按添加顺序输出
+ */
+class JsonLine {
+public:
+    explicit JsonLine(const char* type) {
+        m_text = "{\"type\":\"";
+        m_text += type;
+        m_text += '"';
+    }
+
+    JsonLine& AddString(const char* key, std::string_view value) {
+        AppendKey(key);
+        AppendString(m_text, value);
+        return *this;
+    }
+
+    JsonLine& AddInt(const char* key, long long value) {
+        AppendKey(key);
+        char buf[24];
+        m_text.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        return *this;
+    }
+
+    JsonLine& AddNumber(const char* key, double value) {
+        AppendKey(key);
+        AppendNumber(m_text, value);
+        return *this;
+    }
+
+    JsonLine& AddBool(const char* key, bool value) {
+        AppendKey(key);
+        m_text += value ? "true" : "false";
+        return *this;
+    }
+
+    /**
+     * @brief 添加已格式化的 JSON 值（数组、对象）
+     */
+    JsonLine& AddRaw(const char* key, std::string_view json) {
+        AppendKey(key);
+        m_text += json;
+        return *this;
+    }
+
+    /**
+     * @brief 输出到 stdout（带换行）
+     */
+    void Print() {
+        m_text += "}\n";
+        std::fwrite(m_text.data(), 1, m_text.size(), stdout);
+    }
+
+    static void AppendString(std::string& out, std::string_view value) {
+        out += '"';
+        for (unsigned char c : value) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += (char)c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    static void AppendNumber(std::string& out, double value) {
+        if (!std::isfinite(value)) {
+            out += "null";
+            return;
+        }
+        // 最短的可精确还原表示
+        char buf[32];
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+    }
+
+private:
+    std::string m_text;
+
+    void AppendKey(const char* key) {
+        m_text += ",\"";
+        m_text += key;
+        m_text += "\":";
+    }
+};
+
+static double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief 输出失败的汇总行
+ */
+static int Fail(const std::string& command, const std::string& error, Clock::time_point start) {
+    JsonLine("result")
+        .AddString("command", command)
+        .AddBool("ok", false)
+        .AddString("error", error)
+        .AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitFailed;
+}
+
+// ========== 命令行解析 ==========
+
+struct CommandLine {
+    std::string dbPath = "assets.db";
+    std::string command;
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;     // 不带值的开关值为空串
+
+    bool Has(const char* name) const { return options.count(name) > 0; }
+
+    std::string Get(const char* name, const std::string& fallback = "") const {
+        auto it = options.find(name);
+        return it == options.end() ? fallback : it->second;
+    }
+};
+
+// 不带值的开关
+static const char* const kSwitches[] = {"--asc", "--quiet", "--strict"};
+
+static bool IsSwitch(const std::string& arg) {
+    for (const char* name : kSwitches) {
+        if (arg == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseCommandLine(const std::vector<std::string>& args, CommandLine& cmd, std::string& error) {
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            if (IsSwitch(arg)) {
+                cmd.options[arg] = "";
+                continue;
+            }
+            if (i + 1 >= args.size()) {
+                error = "选项 " + arg + " 缺少参数";
+                return false;
+            }
+            if (arg == "--db") {
+                cmd.dbPath = args[++i];
+            } else {
+                cmd.options[arg] = args[++i];
+            }
+        } else if (cmd.command.empty()) {
+            cmd.command = arg;
+        } else {
+            cmd.positional.push_back(arg);
+        }
+    }
+    if (cmd.command.empty()) {
+        error = "缺少命令";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 检查选项都在 allowed 中、位置参数个数在 [minArgs, maxArgs] 内
+ */
+static bool CheckArguments(const CommandLine& cmd, std::initializer_list<const char*> allowed,
+                           size_t minArgs, size_t maxArgs, std::string& error) {
+    for (const auto& option : cmd.options) {
+        bool known = false;
+        for (const char* name : allowed) {
+            if (option.first == name) {
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            error = cmd.command + " 不支持选项 " + option.first;
+            return false;
+        }
+    }
+    if (cmd.positional.size() < minArgs || cmd.positional.size() > maxArgs) {
+        error = cmd.command + " 参数个数不正确";
+        return false;
+    }
+    return true;
+}
+
+static bool ParseInteger(const std::string& text, long long minValue, long long& value) {
+    const char* end = text.data() + text.size();
+    auto parsed = std::from_chars(text.data(), end, value);
+    return parsed.ec == std::errc() && parsed.ptr == end && value >= minValue;
+}
+
+/**
+ * @brief 读取整数选项，缺省时保留 value 原值
+ */
+static bool GetIntegerOption(const CommandLine& cmd, const char* name, long long minValue,
+                             long long& value, std::string& error) {
+    if (!cmd.Has(name)) {
+        return true;
+    }
+    if (!ParseInteger(cmd.Get(name), minValue, value)) {
+        error = std::string("选项 ") + name + " 需要不小于 " + std::to_string(minValue) + " 的整数";
+        return false;
+    }
+    return true;
+}
+
+static bool ParseSortField(const std::string& name, AssetSortField& field) {
+    static const std::pair<const char*, AssetSortField> kFields[] = {
+        {"id", AssetSortField::Id},
+        {"code", AssetSortField::Code},
+        {"name", AssetSortField::Name},
+        {"category", AssetSortField::Category},
+        {"user", AssetSortField::User},
+        {"date", AssetSortField::PurchaseDate},
+        {"price", AssetSortField::Price},
+        {"location", AssetSortField::Location},
+        {"status", AssetSortField::Status},
+        {"remark", AssetSortField::Remark},
+    };
+    for (const auto& entry : kFields) {
+        if (name == entry.first) {
+            field = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 由 --text/--category/--status/--sort/--asc 构造资产查询条件
+ */
+static bool GetAssetFilter(const CommandLine& cmd, AssetFilter& filter, std::string& error) {
+    filter.searchText = cmd.Get("--text", filter.searchText);
+    filter.status = cmd.Get("--status");
+
+    long long categoryId = -1;
+    if (!GetIntegerOption(cmd, "--category", 0, categoryId, error)) {
+        return false;
+    }
+    filter.categoryId = (int)categoryId;
+
+    if (cmd.Has("--sort") && !ParseSortField(cmd.Get("--sort"), filter.sortField)) {
+        error = "未知的排序字段 " + cmd.Get("--sort");
+        return false;
+    }
+    filter.ascending = cmd.Has("--asc");
+    return true;
+}
+
+/**
+ * @brief 解析变更时间：YYYY-MM-DD 按本地日期，纯数字按 Unix 时间戳
+ * @param endOfRange 为 true 时日期取次日零点（含当天全天）
+ */
+static bool ParseTime(const std::string& text, bool endOfRange, std::optional<long long>& time) {
+    long long epoch = 0;
+    if (ParseInteger(text, 0, epoch)) {
+        time = epoch;
+        return true;
+    }
+    ChangeLogTimeRange range = endOfRange ? ChangeLogTimeRange::FromLocalDates("", text)
+                                          : ChangeLogTimeRange::FromLocalDates(text, "");
+    time = endOfRange ? range.to : range.from;
+    return time.has_value();
+}
+
+/**
+ * @brief 打开数据库：写入命令建表/迁移，查询命令只读打开（可与导入并发）
+ */
+static bool OpenDatabase(Database& db, const CommandLine& cmd, bool writable, std::string& error) {
+    bool ok = writable ? db.Initialize(cmd.dbPath) : db.OpenReadOnly(cmd.dbPath);
+    if (!ok) {
+        error = "无法打开数据库 " + cmd.dbPath + ": " + db.GetLastError();
+    }
+    return ok;
+}
+
+// ========== 命令 ==========
+
+/**
+ * @brief 逐行信息的去向：--report 指定时写入报告文件，否则作为 message 行输出（--quiet 时丢弃）
+ *
+ * 信息到达即输出，不在内存中累积。
+ */
+static bool SetupMessages(const CommandLine& cmd, CsvImportOptions& options, CsvImportReport& report,
+                          std::string& error) {
+    if (cmd.Has("--report")) {
+        if (!report.Open(cmd.Get("--report"))) {
+            error = "无法创建报告 " + cmd.Get("--report") + ": " + report.GetLastError();
+            return false;
+        }
+        options.onMessage = [&report](const CsvImportMessage& message) { report.Add(message); };
+    } else if (cmd.Has("--quiet")) {
+        options.onMessage = [](const CsvImportMessage&) {};
+    } else {
+        options.onMessage = [](const CsvImportMessage& message) {
+            JsonLine("message").AddInt("line", message.line).AddString("text", message.text).Print();
+        };
+    }
+    return true;
+}
+
+/**
+ * @brief 关闭报告文件（未使用报告时什么也不做），写入失败时返回 false
+ */
+static bool CloseReport(CsvImportReport& report, std::string& error) {
+    if (report.IsOpen() && !report.Close()) {
+        error = "写入报告失败: " + report.GetLastError();
+        return false;
+    }
+    return true;
+}
+
+static int RunImport(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    long long workers = -1;
+    long long batch = 5000;
+    if (!CheckArguments(cmd, {"--workers", "--batch", "--report", "--quiet", "--strict"}, 1, 1, error) ||
+        !GetIntegerOption(cmd, "--workers", 0, workers, error) ||
+        !GetIntegerOption(cmd, "--batch", 1, batch, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+
+    Database db;
+    if (!OpenDatabase(db, cmd, true, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    CsvImportOptions options;
+    options.workers = (int)workers;
+    options.batchRows = (size_t)batch;
+    options.strictFields = cmd.Has("--strict");
+    CsvImportReport report;
+    if (!SetupMessages(cmd, options, report, error)) {
+        return Fail(cmd.command, error, start);
+    }
+    CsvImporter importer(db, options);
+    CsvImportResult result;
+    bool ok = importer.Import(cmd.positional[0], result);
+    if (!ok) {
+        error = importer.GetLastError();
+    }
+
+    // 报告写入失败也算失败：逐行信息不完整
+    ok = CloseReport(report, error) && ok;
+
+    double elapsedMs = ElapsedMs(start);
+    JsonLine line("result");
+    line.AddString("command", cmd.command)
+        .AddBool("ok", ok)
+        .AddString("file", cmd.positional[0]);
+    if (cmd.Has("--report")) {
+        line.AddString("report", cmd.Get("--report"));
+    }
+    line.AddInt("rows", result.rows)
+        .AddInt("inserted", result.successCount)
+        .AddInt("skipped", result.skipCount)
+        .AddInt("invalid", result.invalidCount)
+        .AddInt("failed", result.rows - result.successCount - result.skipCount)
+        .AddInt("messages", result.messageCount)
+        .AddInt("workers", importer.GetWorkerCount());
+    if (!ok) {
+        line.AddString("error", error);
+    }
+    line.AddNumber("rows_per_s", elapsedMs > 0 ? result.rows * 1000.0 / elapsedMs : 0.0)
+        .AddNumber("elapsed_ms", elapsedMs)
+        .Print();
+    return ok ? kExitOk : kExitFailed;
+}
+
+static int RunValidate(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    long long workers = -1;
+    if (!CheckArguments(cmd, {"--workers", "--report", "--quiet", "--strict"}, 1, 1, error) ||
+        !GetIntegerOption(cmd, "--workers", 0, workers, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+
+    // 只读打开：检查不写入，也可与正在进行的导入并发
+    Database db;
+    if (!OpenDatabase(db, cmd, false, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    CsvImportOptions options;
+    options.workers = (int)workers;
+    options.strictFields = cmd.Has("--strict");
+    CsvImportReport report;
+    if (!SetupMessages(cmd, options, report, error)) {
+        return Fail(cmd.command, error, start);
+    }
+    CsvImporter importer(db, options);
+    CsvValidateResult result;
+    bool ok = importer.Validate(cmd.positional[0], result);
+    if (!ok) {
+        error = importer.GetLastError();
+    }
+
+    ok = CloseReport(report, error) && ok;
+
+    double elapsedMs = ElapsedMs(start);
+    JsonLine line("result");
+    line.AddString("command", cmd.command)
+        .AddBool("ok", ok)
+        .AddString("file", cmd.positional[0]);
+    if (cmd.Has("--report")) {
+        line.AddString("report", cmd.Get("--report"));
+    }
+    line.AddInt("rows", result.rows)
+        .AddInt("valid", result.validRows)
+        .AddInt("non_standard", result.nonStandardRows)
+        .AddInt("invalid", result.invalidRows)
+        .AddInt("duplicate", result.duplicateRows)
+        .AddInt("existing", result.existingRows)
+        .AddInt("messages", result.messageCount)
+        .AddInt("workers", importer.GetWorkerCount());
+    if (!ok) {
+        line.AddString("error", error);
+    }
+    line.AddNumber("rows_per_s", elapsedMs > 0 ? result.rows * 1000.0 / elapsedMs : 0.0)
+        .AddNumber("elapsed_ms", elapsedMs)
+        .Print();
+    if (!ok) {
+        return kExitFailed;
+    }
+    return result.validRows == result.rows ? kExitOk : kExitInvalid;
+}
+
+static int RunExport(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    AssetFilter filter;
+    if (!CheckArguments(cmd, {"--text", "--category", "--status", "--sort", "--asc", "--encoding"}, 1, 1, error) ||
+        !GetAssetFilter(cmd, filter, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+
+    std::string encodingName = cmd.Get("--encoding", "utf8");
+    CsvExportEncoding encoding;
+    if (encodingName == "utf8") {
+        encoding = CsvExportEncoding::Utf8Bom;
+    } else if (encodingName == "gbk") {
+        encoding = CsvExportEncoding::Gbk;
+    } else {
+        std::fprintf(stderr, "--encoding 只能是 utf8 或 gbk: %s\n", encodingName.c_str());
+        return kExitUsage;
+    }
+
+    Database db;
+    if (!OpenDatabase(db, cmd, false, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    CsvExporter exporter(db, encoding);
+    long long rows = 0;
+    if (!exporter.Export(cmd.positional[0], filter, rows)) {
+        return Fail(cmd.command, exporter.GetLastError(), start);
+    }
+
+    JsonLine line("result");
+    line.AddString("command", cmd.command)
+        .AddBool("ok", true)
+        .AddString("file", cmd.positional[0])
+        .AddString("encoding", encodingName)
+        .AddInt("rows", rows);
+    if (encoding == CsvExportEncoding::Gbk) {
+        line.AddInt("replaced", exporter.GetReplacedChars());
+    }
+    line.AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitOk;
+}
+
+static int RunSearch(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    AssetFilter filter;
+    long long limit = 100;
+    if (!CheckArguments(cmd, {"--text", "--category", "--status", "--sort", "--asc", "--limit"}, 0, 1, error) ||
+        !GetAssetFilter(cmd, filter, error) ||
+        !GetIntegerOption(cmd, "--limit", 0, limit, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+    if (!cmd.positional.empty()) {
+        filter.searchText = cmd.positional[0];
+    }
+
+    Database db;
+    if (!OpenDatabase(db, cmd, false, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    // 多取一行判断结果是否被截断
+    long long rows = 0;
+    bool truncated = false;
+    bool ok = db.ForEachAsset(filter, [&](const AssetRowView& row) {
+        if (limit > 0 && rows == limit) {
+            truncated = true;
+            return false;
+        }
+        JsonLine("asset")
+            .AddInt("id", row.id)
+            .AddString("code", row.assetCode)
+            .AddString("name", row.name)
+            .AddInt("category_id", row.categoryId)
+            .AddString("category", row.categoryName)
+            .AddInt("user_id", row.userId)
+            .AddString("user", row.userName)
+            .AddString("department", row.departmentName)
+            .AddString("purchase_date", row.purchaseDate)
+            .AddNumber("price", row.price)
+            .AddString("location", row.location)
+            .AddString("status", row.status)
+            .AddString("remark", row.remark)
+            .Print();
+        rows++;
+        return true;
+    });
+    if (!ok) {
+        return Fail(cmd.command, db.GetLastError(), start);
+    }
+
+    JsonLine("result")
+        .AddString("command", cmd.command)
+        .AddBool("ok", true)
+        .AddInt("rows", rows)
+        .AddBool("truncated", truncated)
+        .AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitOk;
+}
+
+/**
+ * @brief 分组数组：[{"id":..,"name":..,"count":..,"total_price":..}, ...]
+ */
+static std::string FormatGroups(const std::vector<AssetSummaryGroup>& groups, bool withId) {
+    std::string json = "[";
+    for (size_t i = 0; i < groups.size(); i++) {
+        const AssetSummaryGroup& group = groups[i];
+        if (i > 0) {
+            json += ',';
+        }
+        json += '{';
+        if (withId) {
+            json += "\"id\":" + std::to_string(group.id) + ",";
+        }
+        json += "\"name\":";
+        JsonLine::AppendString(json, group.name);
+        json += ",\"count\":" + std::to_string(group.count);
+        json += ",\"total_price\":";
+        JsonLine::AppendNumber(json, group.totalPrice);
+        json += '}';
+    }
+    json += ']';
+    return json;
+}
+
+static int RunStats(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    if (!CheckArguments(cmd, {}, 0, 0, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+
+    Database db;
+    if (!OpenDatabase(db, cmd, false, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    // 汇总表由触发器维护，耗时只与分组数有关
+    AssetSummary summary;
+    if (!db.GetAssetSummary(summary)) {
+        return Fail(cmd.command, db.GetLastError(), start);
+    }
+
+    JsonLine("result")
+        .AddString("command", cmd.command)
+        .AddBool("ok", true)
+        .AddInt("total_count", summary.totalCount)
+        .AddNumber("total_price", summary.totalPrice)
+        .AddRaw("by_status", FormatGroups(summary.byStatus, false))
+        .AddRaw("by_category", FormatGroups(summary.byCategory, true))
+        .AddRaw("by_department", FormatGroups(summary.byDepartment, true))
+        .AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitOk;
+}
+
+static int RunChangeLog(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    std::string searchText;
+    ChangeLogTimeRange time;
+    long long limit = 100;
+    if (!CheckArguments(cmd, {"--text", "--since", "--until", "--limit"}, 0, 1, error) ||
+        !GetIntegerOption(cmd, "--limit", 0, limit, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+    searchText = cmd.positional.empty() ? cmd.Get("--text") : cmd.positional[0];
+    if ((cmd.Has("--since") && !ParseTime(cmd.Get("--since"), false, time.from)) ||
+        (cmd.Has("--until") && !ParseTime(cmd.Get("--until"), true, time.to))) {
+        std::fprintf(stderr, "时间需为 YYYY-MM-DD 或 Unix 时间戳\n");
+        return kExitUsage;
+    }
+
+    Database db;
+    if (!OpenDatabase(db, cmd, false, error)) {
+        return Fail(cmd.command, error, start);
+    }
+
+    long long rows = 0;
+    bool truncated = false;
+    bool ok = db.ForEachChangeLog(searchText, time, [&](const ChangeLogRowView& row) {
+        if (limit > 0 && rows == limit) {
+            truncated = true;
+            return false;
+        }
+        JsonLine("change")
+            .AddInt("id", row.id)
+            .AddInt("asset_id", row.assetId)
+            .AddString("asset_code", row.assetCode)
+            .AddString("asset_name", row.assetName)
+            .AddString("field", row.fieldName)
+            .AddString("old_value", row.oldValue)
+            .AddString("new_value", row.newValue)
+            .AddInt("time", row.changeTime)
+            .Print();
+        rows++;
+        return true;
+    });
+    if (!ok) {
+        return Fail(cmd.command, db.GetLastError(), start);
+    }
+
+    JsonLine("result")
+        .AddString("command", cmd.command)
+        .AddBool("ok", true)
+        .AddInt("rows", rows)
+        .AddBool("truncated", truncated)
+        .AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitOk;
+}
+
+static int RunTemplate(const CommandLine& cmd, Clock::time_point start) {
+    std::string error;
+    if (!CheckArguments(cmd, {}, 1, 1, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return kExitUsage;
+    }
+    if (!CsvExporter::ExportTemplate(cmd.positional[0], error)) {
+        return Fail(cmd.command, error, start);
+    }
+    JsonLine("result")
+        .AddString("command", cmd.command)
+        .AddBool("ok", true)
+        .AddString("file", cmd.positional[0])
+        .AddNumber("elapsed_ms", ElapsedMs(start))
+        .Print();
+    return kExitOk;
+}
+
+static int Run(const std::vector<std::string>& args) {
+    Clock::time_point start = Clock::now();
+
+    CommandLine cmd;
+    std::string error;
+    if (!ParseCommandLine(args, cmd, error)) {
+        std::fprintf(stderr, "%s\n\n", error.c_str());
+        PrintUsage();
+        return kExitUsage;
+    }
+
+    int code;
+    if (cmd.command == "import") {
+        code = RunImport(cmd, start);
+    } else if (cmd.command == "validate") {
+        code = RunValidate(cmd, start);
+    } else if (cmd.command == "export") {
+        code = RunExport(cmd, start);
+    } else if (cmd.command == "search") {
+        code = RunSearch(cmd, start);
+    } else if (cmd.command == "stats") {
+        code = RunStats(cmd, start);
+    } else if (cmd.command == "changelog") {
+        code = RunChangeLog(cmd, start);
+    } else if (cmd.command == "template") {
+        code = RunTemplate(cmd, start);
+    } else if (cmd.command == "help") {
+        PrintUsage();
+        return kExitOk;
+    } else {
+        std::fprintf(stderr, "未知命令 %s\n\n", cmd.command.c_str());
+        PrintUsage();
+        return kExitUsage;
+    }
+
+    if (code == kExitUsage) {
+        std::fprintf(stderr, "运行 assetctl help 查看用法\n");
+    }
+    std::fflush(stdout);
+    return code;
+}
+
+#ifdef _WIN32
+
+// 参数按 UTF-16 读取后转为 UTF-8，路径与搜索词不受控制台代码页影响
+int main() {
+    int argc = 0;
+    wchar_t** wargv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    std::vector<std::string> args;
+    for (int i = 1; wargv && i < argc; i++) {
+        int len = WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1, nullptr, 0, nullptr, nullptr);
+        std::string arg(len > 0 ? len - 1 : 0, '\0');
+        if (len > 1) {
+            WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1, &arg[0], len, nullptr, nullptr);
+        }
+        args.push_back(std::move(arg));
+    }
+    LocalFree(wargv);
+    SetConsoleOutputCP(CP_UTF8);
+    return Run(args);
+}
+
+#else
+
+int main(int argc, char** argv) {
+    return Run(std::vector<std::string>(argv + 1, argv + argc));
+}
+
+#endif
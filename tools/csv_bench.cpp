@@ -0,0 +1,837 @@
+/**
+ * @file csv_bench.cpp
+ * @brief CSV 读取吞吐基准测试
+ *
+ * 生成与导出格式一致的模拟资产 CSV（默认 1 GB，含引号、转义与多行字段），
+ * 分别测量逐行 getline + 按行拆分（原导入实现）、CsvReader 内存映射（每种
+ * CsvScanner 实现各一次）、CsvReader 分块读取的吞吐（MB/s），以及只做
+ * 结构字符扫描时各实现的吞吐：
+ *
+ *   csv_bench --size-mb 1024 --dir bench_data
+ *
+ * 每种方式先读一遍预热页缓存，之后取多次中的最好成绩，测得的是解析本身的速度。
+ *
+ * --fuzz N 对 N 个随机输入做差分校验：各 CsvScanner 实现的分类结果与标量实现一致，
+ * CsvReader 的解析结果与逐字节的参考解析器一致，不一致时打印输入并返回 1。
+ *
+ * --import N 生成 N 行待导入的 CSV（含留空编号、重复编号、新分类与新员工），
+ * 分别用串行（workers = 0）、流水线、流水线导入同一数据的 GBK 版本到新数据库，
+ * 打印耗时并比较各库的资产、分类、部门、员工内容，不一致时返回 1；
+ * 另外分别对空库（串行、流水线）和已导入的库做只检查不写入的 Validate，
+ * 核对检查出的重复编号、合格行数与导入结果一致。
+ * 不依赖 Win32，可在 Linux 上构建运行。
+ */
+
+#include "CsvImporter.h"
+#include "CsvReader.h"
+#include "CsvScanner.h"
+#include "GbkCodec.h"
+#include "database.h"
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// ========== 命令行参数 ==========
+
+struct CsvBenchOptions {
+    long long sizeMb = 1024;
+    std::string dataDir = "bench_data";
+    uint64_t seed = 20240501;
+    int repeat = 3;
+    bool reuse = false;         // 文件已存在且大小一致时跳过生成
+    long long fuzz = 0;         // >0 时只做差分校验
+    long long importRows = 0;   // >0 时只做导入对照
+    int workers = -1;           // 导入对照的解析线程数
+};
+
+static void PrintUsage() {
+    std::printf(
+        "用法: csv_bench [选项]\n"
+        "  --size-mb N    CSV 文件大小（默认 1024）\n"
+        "  --dir DIR      文件存放目录（默认 bench_data）\n"
+        "  --seed N       随机种子（默认 20240501）\n"
+        "  --repeat N     每种方式测量次数，取最好成绩（默认 3）\n"
+        "  --reuse        复用已生成的文件\n"
+        "  --fuzz N       对 N 个随机输入做差分校验（不测吞吐）\n"
+        "  --import N     生成 N 行并比较串行与流水线导入（不测吞吐）\n"
+        "  --workers N    流水线导入的解析线程数（默认按 CPU 核数）\n");
+}
+
+static bool ParseOptions(int argc, char** argv, CsvBenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+
+        if (arg == "--size-mb") {
+            options.sizeMb = std::max(1LL, std::atoll(value().c_str()));
+        } else if (arg == "--dir") {
+            options.dataDir = value();
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value().c_str(), nullptr, 10);
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--reuse") {
+            options.reuse = true;
+        } else if (arg == "--fuzz") {
+            options.fuzz = std::max(1LL, std::atoll(value().c_str()));
+        } else if (arg == "--import") {
+            options.importRows = std::max(1LL, std::atoll(value().c_str()));
+        } else if (arg == "--workers") {
+            options.workers = std::max(1, std::atoi(value().c_str()));
+        } else {
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 数据生成 ==========
+
+/**
+ * @brief splitmix64，跨平台结果一致
+ */
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : m_state(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t Uniform(uint64_t n) { return n ? Next() % n : 0; }
+
+    template <typename T, size_t N>
+    const T& Pick(const T (&items)[N]) { return items[Uniform(N)]; }
+
+private:
+    uint64_t m_state;
+};
+
+static const char* const kNames[] = {
+    "ThinkPad X1 笔记本电脑", "戴尔 27寸显示器", "惠普 激光打印机", "人体工学办公椅",
+    "华为 千兆交换机", "浪潮 机架式服务器", "爱普生 投影仪", "联想 启天 台式机",
+};
+
+static const char* const kCategories[] = {
+    "笔记本电脑", "显示器", "打印设备", "办公家具", "网络设备", "服务器", "投影设备", "台式电脑",
+};
+
+static const char* const kUsers[] = {"王伟", "李芳", "张敏", "刘洋", "陈静", "欧阳子涵", ""};
+
+static const char* const kDepartments[] = {"研发中心", "产品部", "市场部", "财务部", "行政部", ""};
+
+static const char* const kStatuses[] = {"在用", "在用", "在用", "闲置", "维修中", "已报废"};
+
+// 需要加引号的备注：含逗号、引号、换行
+static const char* const kRemarks[] = {
+    "", "", "", "", "已贴资产标签", "保修期三年", "配件齐全",
+    "\"含电源, 鼠标\"", "\"型号标注为 \"\"Pro\"\" 版\"", "\"屏幕有划痕\n待维修\"",
+};
+
+/**
+ * @brief 生成约 bytes 字节的 CSV 文件（UTF-8 BOM + 表头 + 数据行）
+ */
+static bool GenerateCsv(const std::string& path, uint64_t bytes, uint64_t seed) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+
+    std::vector<char> buffer(1 << 20);
+    out.rdbuf()->pubsetbuf(buffer.data(), (std::streamsize)buffer.size());
+
+    out << "\xEF\xBB\xBF资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
+
+    Rng rng(seed);
+    char line[512];
+    uint64_t written = 0;
+    for (long long i = 1; written < bytes; i++) {
+        int n = std::snprintf(line, sizeof(line),
+                              "ZC%08lld,%s,%s,%s,%s,20%02d-%02d-%02d,%llu.%02d,A座%d层%02d室,%s,%s\n",
+                              i, rng.Pick(kNames), rng.Pick(kCategories), rng.Pick(kUsers),
+                              rng.Pick(kDepartments), 18 + (int)rng.Uniform(7),
+                              1 + (int)rng.Uniform(12), 1 + (int)rng.Uniform(28),
+                              (unsigned long long)(300 + rng.Uniform(50000)), (int)rng.Uniform(100),
+                              1 + (int)rng.Uniform(20), 1 + (int)rng.Uniform(40),
+                              rng.Pick(kStatuses), rng.Pick(kRemarks));
+        out.write(line, n);
+        written += (uint64_t)n;
+    }
+    return (bool)out;
+}
+
+// ========== 被测实现 ==========
+
+/**
+ * @brief 解析结果摘要，用于核对各实现读到的内容一致
+ */
+struct ParseSummary {
+    long long records = 0;
+    long long fields = 0;
+    uint64_t fieldBytes = 0;
+};
+
+/**
+ * @brief 原导入实现：getline 读入整行，每个字段分配一个 std::string（不支持多行字段）
+ */
+static bool ParseWithGetline(const std::string& path, ParseSummary& summary) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::vector<std::string> result;
+        std::string field;
+        field.reserve(64);
+        bool inQuotes = false;
+        for (size_t i = 0; i < line.length(); i++) {
+            char c = line[i];
+            if (c == '"') {
+                if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
+                    field.push_back('"');
+                    i++;
+                } else {
+                    inQuotes = !inQuotes;
+                }
+            } else if (c == ',' && !inQuotes) {
+                result.push_back(std::move(field));
+                field.clear();
+                field.reserve(64);
+            } else {
+                field.push_back(c);
+            }
+        }
+        result.push_back(std::move(field));
+
+        summary.records++;
+        summary.fields += (long long)result.size();
+        for (const std::string& f : result) {
+            summary.fieldBytes += f.size();
+        }
+    }
+    return true;
+}
+
+static bool ParseWithReader(const std::string& path, CsvReadMode mode, ParseSummary& summary) {
+    CsvReader reader;
+    if (!reader.Open(path, mode)) {
+        std::fprintf(stderr, "%s\n", reader.GetLastError().c_str());
+        return false;
+    }
+
+    CsvRecord record;
+    while (reader.Next(record)) {
+        summary.records++;
+        summary.fields += (long long)record.fields.size();
+        for (std::string_view f : record.fields) {
+            summary.fieldBytes += f.size();
+        }
+    }
+    return reader.GetLastError().empty();
+}
+
+/**
+ * @brief 只做结构字符扫描：分类每个 64 字节块并统计引号外的分隔符
+ */
+static long long ScanStructural(const std::string& data) {
+    long long count = 0;
+    uint64_t carry = 0;
+    for (size_t pos = 0; pos < data.size(); pos += 64) {
+        size_t length = std::min<size_t>(64, data.size() - pos);
+        CsvBlockMasks masks;
+        CsvScanner::Classify(data.data() + pos, length, masks);
+        uint64_t inside = CsvScanner::PrefixXor(masks.quote) ^ carry;
+        carry = (uint64_t)((int64_t)inside >> 63);
+        count += CsvScanner::CountBits(masks.separator & ~inside);
+    }
+    return count;
+}
+
+// ========== 差分校验 ==========
+
+using RecordList = std::vector<std::pair<long long, std::vector<std::string>>>;
+
+/**
+ * @brief 逐字节的参考解析器（与 CsvReader 约定相同：引号翻转状态，"" 在引号内表示引号，
+ *        空行跳过，行号计入引号内的 \n）
+ */
+static RecordList ReferenceParse(std::string_view data) {
+    RecordList records;
+    size_t i = 0;
+    if (data.size() >= 3 && data.substr(0, 3) == "\xEF\xBB\xBF") {
+        i = 3;
+    }
+
+    long long line = 1;
+    while (i < data.size()) {
+        long long startLine = line;
+        size_t recordStart = i;
+        size_t recordEnd = data.size();         // 不含换行
+        std::vector<std::string> fields(1);
+        bool inQuotes = false;
+        bool terminated = false;
+        for (; i < data.size() && !terminated; i++) {
+            char c = data[i];
+            if (inQuotes) {
+                if (c == '"') {
+                    if (i + 1 < data.size() && data[i + 1] == '"') {
+                        fields.back().push_back('"');
+                        i++;
+                    } else {
+                        inQuotes = false;
+                    }
+                } else {
+                    if (c == '\n') line++;
+                    fields.back().push_back(c);
+                }
+            } else if (c == '"') {
+                inQuotes = true;
+            } else if (c == ',') {
+                fields.emplace_back();
+            } else if (c == '\n' || c == '\r') {
+                recordEnd = i;
+                if (c == '\r' && i + 1 < data.size() && data[i + 1] == '\n') i++;
+                line++;
+                terminated = true;
+            } else {
+                fields.back().push_back(c);
+            }
+        }
+        // 空行指换行前没有任何字节；"" 是一个空字段，不算空行
+        if (recordEnd > recordStart) {
+            records.emplace_back(startLine, std::move(fields));
+        }
+    }
+    return records;
+}
+
+static RecordList ReaderParse(std::string_view data) {
+    RecordList records;
+    CsvReader reader;
+    reader.OpenMemory(data);
+    CsvRecord record;
+    while (reader.Next(record)) {
+        std::vector<std::string> fields(record.fields.begin(), record.fields.end());
+        records.emplace_back(record.line, std::move(fields));
+    }
+    return records;
+}
+
+static void PrintInput(std::string_view data) {
+    std::string escaped;
+    for (char c : data) {
+        if (c == '\n') escaped += "\\n";
+        else if (c == '\r') escaped += "\\r";
+        else escaped += c;
+    }
+    std::fprintf(stderr, "  输入 (%zu 字节): %s\n", data.size(), escaped.c_str());
+}
+
+static int RunFuzz(const CsvBenchOptions& options) {
+    std::vector<CsvScanKernel> kernels;
+    for (CsvScanKernel kernel : {CsvScanKernel::Scalar, CsvScanKernel::Sse2, CsvScanKernel::Avx2}) {
+        if (CsvScanner::IsSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    // 结构字符出现频率远高于真实数据，才能覆盖块边界上的各种组合
+    static const char kAlphabet[] = {'a', 'b', ',', ',', '"', '"', '"', '\r', '\n', '\n', ' ',
+                                     '\xD5', '\xC5', '\xEF', '\xBB', '\xBF'};
+    Rng rng(options.seed);
+    std::string data;
+    long long failures = 0;
+
+    for (long long iteration = 0; iteration < options.fuzz && failures < 10; iteration++) {
+        size_t length = (size_t)rng.Uniform(iteration % 16 == 0 ? 2000 : 200);
+        data.clear();
+        if (rng.Uniform(8) == 0) {
+            data += "\xEF\xBB\xBF";
+        }
+        for (size_t i = 0; i < length; i++) {
+            data.push_back(rng.Pick(kAlphabet));
+        }
+
+        // 各实现的块分类与标量一致（含不足 64 字节的尾块）
+        for (size_t pos = 0; pos < data.size(); pos += 64) {
+            size_t blockLength = std::min<size_t>(64, data.size() - pos);
+            CsvScanner::SetKernel(CsvScanKernel::Scalar);
+            CsvBlockMasks expected;
+            CsvScanner::Classify(data.data() + pos, blockLength, expected);
+            for (CsvScanKernel kernel : kernels) {
+                CsvScanner::SetKernel(kernel);
+                CsvBlockMasks actual;
+                CsvScanner::Classify(data.data() + pos, blockLength, actual);
+                if (actual.quote != expected.quote || actual.separator != expected.separator ||
+                    actual.lineFeed != expected.lineFeed) {
+                    std::fprintf(stderr, "分类不一致 (%s, 偏移 %zu)\n",
+                                 CsvScanner::GetKernelName(kernel), pos);
+                    PrintInput(data);
+                    failures++;
+                }
+            }
+        }
+
+        RecordList expected = ReferenceParse(data);
+        for (CsvScanKernel kernel : kernels) {
+            CsvScanner::SetKernel(kernel);
+            if (ReaderParse(data) != expected) {
+                std::fprintf(stderr, "解析结果与参考实现不一致 (%s)\n", CsvScanner::GetKernelName(kernel));
+                PrintInput(data);
+                failures++;
+            }
+        }
+    }
+
+    std::printf("差分校验 %lld 个输入，实现:", options.fuzz);
+    for (CsvScanKernel kernel : kernels) {
+        std::printf(" %s", CsvScanner::GetKernelName(kernel));
+    }
+    std::printf("，不一致 %lld 处\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// ========== 导入对照 ==========
+
+/**
+ * @brief 生成 rows 行待导入的 CSV
+ *
+ * 约 5% 的行编号留空（自动编号）、1% 与前面的行编号重复（跳过）、少量说明行与缺名称的行；
+ * 分类与使用人名称带编号后缀，导入过程中不断新建，用于核对新建名称的 ID 分配顺序。
+ */
+static bool GenerateImportCsv(const std::string& path, long long rows, uint64_t seed) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+
+    std::vector<char> buffer(1 << 20);
+    out.rdbuf()->pubsetbuf(buffer.data(), (std::streamsize)buffer.size());
+
+    out << "\xEF\xBB\xBF资产编号,资产名称,分类,使用人,部门,购入日期,金额,存放位置,状态,备注\n";
+    out << "# 说明行,导入时跳过\n";
+
+    Rng rng(seed);
+    char line[512];
+    for (long long i = 1; i <= rows; i++) {
+        char code[32];
+        uint64_t kind = rng.Uniform(100);
+        if (kind < 5) {
+            code[0] = '\0';
+        } else if (kind < 6) {
+            std::snprintf(code, sizeof(code), "IM%08lld", 1 + (long long)rng.Uniform((uint64_t)i));
+        } else {
+            std::snprintf(code, sizeof(code), "IM%08lld", i);
+        }
+        const char* name = rng.Uniform(200) == 0 ? "" : rng.Pick(kNames);
+        // 使用人前后带空格，导入时去除
+        char user[64] = "";
+        const char* userName = rng.Pick(kUsers);
+        if (*userName) {
+            std::snprintf(user, sizeof(user), " %s%d ", userName, (int)rng.Uniform(300));
+        }
+        char date[16];
+        std::snprintf(date, sizeof(date), "20%02d-%02d-%02d", 18 + (int)rng.Uniform(7),
+                      1 + (int)rng.Uniform(12), 1 + (int)rng.Uniform(28));
+        char price[32];
+        std::snprintf(price, sizeof(price), "%llu.%02d",
+                      (unsigned long long)(300 + rng.Uniform(50000)), (int)rng.Uniform(100));
+        const char* status = rng.Pick(kStatuses);
+        // 少量字段有误的行：导入与检查都应报告且不写入
+        switch (rng.Uniform(400)) {
+            case 0: std::snprintf(date, sizeof(date), "2023-02-30"); break;
+            case 1: std::snprintf(price, sizeof(price), "-%llu", (unsigned long long)rng.Uniform(1000)); break;
+            case 2: std::snprintf(price, sizeof(price), "%llu元", (unsigned long long)rng.Uniform(1000)); break;
+            case 3: status = "报废中"; break;
+            default: break;
+        }
+        int n = std::snprintf(line, sizeof(line),
+                              "%s,%s,%s%d,%s,%s,%s,%s,A座%d层%02d室,%s,%s\n",
+                              code, name, rng.Pick(kCategories), (int)rng.Uniform(50),
+                              user, rng.Pick(kDepartments), date, price,
+                              1 + (int)rng.Uniform(20), 1 + (int)rng.Uniform(40),
+                              status, rng.Pick(kRemarks));
+        out.write(line, n);
+    }
+    return (bool)out;
+}
+
+/**
+ * @brief 数据库内容摘要（FNV-1a）：资产按 ID 顺序，连同分类、部门、员工
+ */
+static uint64_t DigestDatabase(const std::string& path, long long& assetCount) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        return 0;
+    }
+
+    static const char* const kQueries[] = {
+        "SELECT id, asset_code, name, category_id, user_id, purchase_date, price, location, status, remark "
+        "FROM assets ORDER BY id",
+        "SELECT id, name FROM categories ORDER BY id",
+        "SELECT id, name FROM departments ORDER BY id",
+        "SELECT id, name, department_id FROM employees ORDER BY id",
+    };
+
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ p[i]) * 1099511628211ULL;
+        }
+    };
+
+    assetCount = 0;
+    for (const char* sql : kQueries) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            continue;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            if (sql == kQueries[0]) {
+                assetCount++;
+            }
+            int columns = sqlite3_column_count(stmt);
+            for (int i = 0; i < columns; i++) {
+                const unsigned char* text = sqlite3_column_text(stmt, i);
+                int length = sqlite3_column_bytes(stmt, i);
+                mix(text ? (const void*)text : "\x01NULL", text ? (size_t)length : 5);
+                mix("\x1F", 1);
+            }
+            mix("\x1E", 1);
+        }
+        sqlite3_finalize(stmt);
+        mix("\x1D", 1);
+    }
+    sqlite3_close(db);
+    return hash;
+}
+
+static void RemoveDatabase(const std::string& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+    fs::remove(path + "-wal", ec);
+    fs::remove(path + "-shm", ec);
+    fs::remove(path + "-journal", ec);
+}
+
+static int RunImport(const CsvBenchOptions& options) {
+    std::error_code ec;
+    fs::create_directories(options.dataDir, ec);
+    std::string csvPath = (fs::path(options.dataDir) /
+                           ("import_" + std::to_string(options.importRows) + ".csv")).string();
+
+    if (!options.reuse || !fs::exists(csvPath, ec)) {
+        std::printf("生成 %s ...\n", csvPath.c_str());
+        std::fflush(stdout);
+        if (!GenerateImportCsv(csvPath, options.importRows, options.seed)) {
+            std::fprintf(stderr, "生成 CSV 失败: %s\n", csvPath.c_str());
+            return 1;
+        }
+    }
+    std::printf("== 导入 %lld 行 (%.1f MB)\n", options.importRows, fs::file_size(csvPath, ec) / 1048576.0);
+
+    // 同一份数据的 GBK 版本（无 BOM），走转码路径
+    std::string gbkPath = csvPath + ".gbk";
+    {
+        std::ifstream in(csvPath, std::ios::binary);
+        std::string utf8((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(gbkPath, std::ios::binary);
+        std::string gbk = GbkCodec::FromUtf8(std::string_view(utf8).substr(3));
+        out.write(gbk.data(), (std::streamsize)gbk.size());
+    }
+
+    struct Run {
+        const char* name;
+        const std::string* path;
+        int workers;
+        CsvImportResult result;
+        uint64_t digest = 0;
+        long long assets = 0;
+    };
+    Run runs[] = {{"serial", &csvPath, 0, {}},
+                  {"pipeline", &csvPath, options.workers, {}},
+                  {"gbk", &gbkPath, options.workers, {}}};
+
+    // 检查结果：逐行信息经 onMessage 流式计数并摘要，不在内存中累积
+    struct Check {
+        const char* name;
+        int workers;
+        CsvValidateResult result;
+        uint64_t digest = 0;
+        bool strict = false;
+    };
+    auto validate = [&csvPath](Database& db, Check& check) {
+        CsvImportOptions validateOptions;
+        validateOptions.workers = check.workers;
+        validateOptions.strictFields = check.strict;
+        validateOptions.onMessage = [&check](const CsvImportMessage& message) {
+            std::string text = message.ToString();
+            for (unsigned char c : text) {
+                check.digest = (check.digest ^ c) * 1099511628211ULL;
+            }
+        };
+        check.digest = 14695981039346656037ULL;
+        CsvImporter importer(db, validateOptions);
+        auto start = Clock::now();
+        if (!importer.Validate(csvPath, check.result)) {
+            std::fprintf(stderr, "%s 检查失败: %s\n", check.name, importer.GetLastError().c_str());
+            return false;
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const CsvValidateResult& r = check.result;
+        std::printf("  %-10s 解析线程 %d  %8.2f s  %10.0f 行/s  合格 %lld  不规范 %lld  不合格 %lld  "
+                    "文件内重复 %lld  库中已有 %lld  信息 %lld\n",
+                    check.name, importer.GetWorkerCount(), seconds, r.rows / seconds, r.validRows,
+                    r.nonStandardRows, r.invalidRows, r.duplicateRows, r.existingRows, r.messageCount);
+        std::fflush(stdout);
+        return true;
+    };
+    Check checks[] = {{"validate", 0, {}}, {"validate", options.workers, {}}, {"revalidate", options.workers, {}},
+                      {"strict", options.workers, {}, 0, true}};
+
+    for (Run& run : runs) {
+        std::string dbPath = (fs::path(options.dataDir) / (std::string("import_") + run.name + ".db")).string();
+        RemoveDatabase(dbPath);
+
+        // 空库上检查（串行与流水线各一次），之后导入同一个库
+        if (&run == &runs[0]) {
+            Database db;
+            if (!db.Initialize(dbPath) || !validate(db, checks[0]) || !validate(db, checks[1])) {
+                return 1;
+            }
+        }
+
+        {
+            Database db;
+            if (!db.Initialize(dbPath)) {
+                std::fprintf(stderr, "初始化数据库失败: %s\n", db.GetLastError().c_str());
+                return 1;
+            }
+
+            CsvImportOptions importOptions;
+            importOptions.workers = run.workers;
+            CsvImporter importer(db, importOptions);
+
+            auto start = Clock::now();
+            if (!importer.Import(*run.path, run.result)) {
+                std::fprintf(stderr, "%s 导入失败: %s\n", run.name, importer.GetLastError().c_str());
+                return 1;
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            std::printf("  %-10s 解析线程 %d  %8.2f s  %10.0f 行/s  成功 %d  跳过 %d  不合格 %d  信息 %zu\n",
+                        run.name, importer.GetWorkerCount(), seconds, options.importRows / seconds,
+                        run.result.successCount, run.result.skipCount, run.result.invalidCount,
+                        run.result.errors.size());
+            std::fflush(stdout);
+
+            // 导入后再检查一次：导入时写入的编号都应报告为库中已有
+            if (&run == &runs[0] && !validate(db, checks[2])) {
+                return 1;
+            }
+        }
+
+        run.digest = DigestDatabase(dbPath, run.assets);
+        RemoveDatabase(dbPath);
+    }
+
+    const Run& serial = runs[0];
+    bool allSame = true;
+    for (const Run& run : runs) {
+        bool same = run.digest == serial.digest && run.assets == serial.assets &&
+                    run.result.successCount == serial.result.successCount &&
+                    run.result.skipCount == serial.result.skipCount &&
+                    run.result.invalidCount == serial.result.invalidCount &&
+                    run.result.errors == serial.result.errors;
+        std::printf("  %-10s 资产 %lld  摘要 %016llx  %s\n", run.name, run.assets,
+                    (unsigned long long)run.digest, same ? "一致" : "与串行不一致");
+        allSame = allSame && same;
+    }
+
+    // 空库上：导入跳过的都是文件内重复，不合格的行导入时报告且不写入，合格与不规范的行都被写入；
+    // 导入后：写入过的编号都报告为库中已有，只有自动编号的行仍然可导入
+    const CsvValidateResult& fresh = checks[0].result;
+    const CsvValidateResult& again = checks[2].result;
+    bool checkSame = checks[1].digest == checks[0].digest &&
+                     checks[1].result.messageCount == fresh.messageCount &&
+                     fresh.duplicateRows == serial.result.skipCount &&
+                     fresh.invalidRows == serial.result.invalidCount &&
+                     fresh.rows - fresh.invalidRows == serial.result.rows &&
+                     fresh.existingRows == 0 &&
+                     fresh.validRows + fresh.nonStandardRows == serial.result.successCount &&
+                     again.duplicateRows == fresh.duplicateRows &&
+                     again.existingRows + again.validRows + again.nonStandardRows ==
+                         fresh.validRows + fresh.nonStandardRows;
+    std::printf("  %-10s 重复 %lld  可导入 %lld  导入后已有 %lld  %s\n", "validate", fresh.duplicateRows,
+                fresh.rows - fresh.invalidRows, again.existingRows, checkSame ? "与导入一致" : "与导入不一致");
+
+    // 严格模式：不规范的行导入与检查都按字段有误处理，检查仍与导入一致
+    Check& strict = checks[3];
+    CsvImportResult strictResult;
+    {
+        std::string dbPath = (fs::path(options.dataDir) / "import_strict.db").string();
+        RemoveDatabase(dbPath);
+        {
+            Database db;
+            if (!db.Initialize(dbPath) || !validate(db, strict)) {
+                return 1;
+            }
+            CsvImportOptions importOptions;
+            importOptions.workers = options.workers;
+            importOptions.strictFields = true;
+            CsvImporter importer(db, importOptions);
+            if (!importer.Import(csvPath, strictResult)) {
+                std::fprintf(stderr, "strict 导入失败: %s\n", importer.GetLastError().c_str());
+                return 1;
+            }
+        }
+        RemoveDatabase(dbPath);
+    }
+    bool strictSame = strict.result.rows == fresh.rows &&
+                      strict.result.nonStandardRows == 0 &&
+                      strict.result.invalidRows > fresh.invalidRows &&
+                      strictResult.invalidCount == strict.result.invalidRows &&
+                      strictResult.skipCount == strict.result.duplicateRows &&
+                      strictResult.successCount == strict.result.validRows;
+    std::printf("  %-10s 成功 %d  跳过 %d  不合格 %d  %s\n", "strict", strictResult.successCount,
+                strictResult.skipCount, strictResult.invalidCount, strictSame ? "与检查一致" : "与检查不一致");
+
+    fs::remove(gbkPath, ec);
+    return allSame && checkSame && strictSame ? 0 : 1;
+}
+
+// ========== 主流程 ==========
+
+int main(int argc, char** argv) {
+    CsvBenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    if (options.fuzz > 0) {
+        return RunFuzz(options);
+    }
+    if (options.importRows > 0) {
+        return RunImport(options);
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.dataDir, ec);
+
+    uint64_t targetBytes = (uint64_t)options.sizeMb << 20;
+    std::string path = (fs::path(options.dataDir) /
+                        ("bench_" + std::to_string(options.sizeMb) + "mb.csv")).string();
+
+    uint64_t existing = fs::exists(path, ec) ? fs::file_size(path, ec) : 0;
+    if (!options.reuse || existing < targetBytes) {
+        std::printf("生成 %s ...\n", path.c_str());
+        std::fflush(stdout);
+        if (!GenerateCsv(path, targetBytes, options.seed)) {
+            std::fprintf(stderr, "生成 CSV 失败: %s\n", path.c_str());
+            return 1;
+        }
+    }
+    double megabytes = fs::file_size(path, ec) / 1048576.0;
+    std::printf("== CSV %.1f MB (%s)\n", megabytes, path.c_str());
+
+    CsvScanKernel defaultKernel = CsvScanner::GetKernel();
+    std::vector<CsvScanKernel> kernels;
+    for (CsvScanKernel kernel : {CsvScanKernel::Scalar, CsvScanKernel::Sse2, CsvScanKernel::Avx2}) {
+        if (CsvScanner::IsSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    std::printf("  CsvScanner 默认实现: %s\n", CsvScanner::GetKernelName(defaultKernel));
+
+    // 只扫描结构字符：读入前 256 MB，排除 I/O 与记录构造
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string sample((size_t)std::min<uint64_t>(fs::file_size(path, ec), 256ULL << 20), '\0');
+        file.read(&sample[0], (std::streamsize)sample.size());
+        double sampleMb = sample.size() / 1048576.0;
+
+        for (CsvScanKernel kernel : kernels) {
+            CsvScanner::SetKernel(kernel);
+            long long count = ScanStructural(sample);
+            double best = 0;
+            for (int i = 0; i < options.repeat; i++) {
+                auto start = Clock::now();
+                count = ScanStructural(sample);
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                if (i == 0 || seconds < best) {
+                    best = seconds;
+                }
+            }
+            std::printf("  %-26s %9.1f MB/s  分隔符 %lld\n",
+                        (std::string("scan(") + CsvScanner::GetKernelName(kernel) + ")").c_str(),
+                        sampleMb / best, count);
+        }
+    }
+
+    struct Candidate {
+        std::string name;
+        CsvScanKernel kernel;
+        std::function<bool(ParseSummary&)> parse;
+    };
+    std::vector<Candidate> candidates;
+    candidates.push_back({"getline + ParseCSVLine", defaultKernel,
+                          [&](ParseSummary& s) { return ParseWithGetline(path, s); }});
+    for (CsvScanKernel kernel : kernels) {
+        candidates.push_back({std::string("CsvReader(mmap,") + CsvScanner::GetKernelName(kernel) + ")", kernel,
+                              [&](ParseSummary& s) { return ParseWithReader(path, CsvReadMode::Auto, s); }});
+    }
+    candidates.push_back({std::string("CsvReader(buffered,") + CsvScanner::GetKernelName(defaultKernel) + ")",
+                          defaultKernel,
+                          [&](ParseSummary& s) { return ParseWithReader(path, CsvReadMode::Buffered, s); }});
+
+    for (const Candidate& candidate : candidates) {
+        CsvScanner::SetKernel(candidate.kernel);
+        ParseSummary summary;
+        if (!candidate.parse(summary)) {       // 预热页缓存
+            std::fprintf(stderr, "%s 读取失败\n", candidate.name.c_str());
+            return 1;
+        }
+
+        double best = 0;
+        for (int i = 0; i < options.repeat; i++) {
+            summary = ParseSummary();
+            auto start = Clock::now();
+            candidate.parse(summary);
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (i == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+
+        std::printf("  %-26s %9.1f MB/s  %12.0f 行/s  记录 %lld  字段 %lld  字段字节 %llu\n",
+                    candidate.name.c_str(), megabytes / best, summary.records / best,
+                    summary.records, summary.fields, (unsigned long long)summary.fieldBytes);
+        std::fflush(stdout);
+    }
+    return 0;
+}
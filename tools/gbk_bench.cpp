@@ -0,0 +1,402 @@
+/**
+ * @file gbk_bench.cpp
+ * @brief GbkCodec 一致性检查与吞吐基准测试
+ *
+ * 与系统的 CP936 转换（Windows 为代码页 936，其他平台为 iconv）逐项比较：
+ *
+ *   gbk_bench --verify        检查全部双字节码与全部 BMP 码位，不一致时返回 1
+ *   gbk_bench --size-mb 256   测量 GBK -> UTF-8、UTF-8 -> GBK 的吞吐（MB/s）
+ *
+ * 检查内容：
+ * - 每个首字节 0x81-0xFE 与尾字节 0x40-0xFE 的组合，解码结果与参考实现一致
+ * - 每个已定义的双字节码往返转换后不变
+ * - 每个 BMP 码位的编码结果与参考实现一致
+ * - 整张码表拼接（穿插 ASCII）后整段转换的结果与参考实现一致
+ * - 非法序列按约定替换，不吞掉后面的 ASCII
+ * Windows 把用户自定义区映射到私用区（U+E000-U+F8FF），GbkCodec 不映射，单独计数，不算不一致。
+ *
+ * 吞吐测试的数据有两种：以 ASCII 为主、夹杂中文的资产 CSV，与纯中文文本。
+ */
+
+#include "GbkCodec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(GBK_BENCH_ICONV)
+#include <iconv.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// ========== 命令行参数 ==========
+
+struct GbkBenchOptions {
+    long long sizeMb = 256;
+    int repeat = 3;
+    bool verify = false;
+};
+
+static void PrintUsage() {
+    std::printf(
+        "用法: gbk_bench [选项]\n"
+        "  --size-mb N    每种测试数据的大小（默认 256）\n"
+        "  --repeat N     每种方式测量次数，取最好成绩（默认 3）\n"
+        "  --verify       与系统 CP936 转换逐项比较（不测吞吐）\n");
+}
+
+static bool ParseOptions(int argc, char** argv, GbkBenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+
+        if (arg == "--size-mb") {
+            options.sizeMb = std::max(1LL, std::atoll(value().c_str()));
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else {
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 参考实现 ==========
+
+#if defined(_WIN32)
+
+static const char* ReferenceName() { return "Windows 代码页 936"; }
+
+static bool ReferenceToUtf8(const std::string& gbk, std::string& utf8) {
+    utf8.clear();
+    if (gbk.empty()) return true;
+    int wlen = MultiByteToWideChar(936, MB_ERR_INVALID_CHARS, gbk.data(), (int)gbk.size(), nullptr, 0);
+    if (wlen <= 0) return false;
+    std::wstring wide(wlen, L'\0');
+    MultiByteToWideChar(936, MB_ERR_INVALID_CHARS, gbk.data(), (int)gbk.size(), &wide[0], wlen);
+    int len = WideCharToMultiByte(CP_UTF8, 0, wide.data(), wlen, nullptr, 0, nullptr, nullptr);
+    utf8.resize(len);
+    WideCharToMultiByte(CP_UTF8, 0, wide.data(), wlen, &utf8[0], len, nullptr, nullptr);
+    return true;
+}
+
+static bool ReferenceFromUtf8(const std::string& utf8, std::string& gbk) {
+    gbk.clear();
+    if (utf8.empty()) return true;
+    int wlen = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, utf8.data(), (int)utf8.size(), nullptr, 0);
+    if (wlen <= 0) return false;
+    std::wstring wide(wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, utf8.data(), (int)utf8.size(), &wide[0], wlen);
+    BOOL usedDefault = FALSE;
+    int len = WideCharToMultiByte(936, WC_NO_BEST_FIT_CHARS, wide.data(), wlen, nullptr, 0, nullptr, &usedDefault);
+    if (len <= 0 || usedDefault) return false;
+    gbk.resize(len);
+    WideCharToMultiByte(936, WC_NO_BEST_FIT_CHARS, wide.data(), wlen, &gbk[0], len, nullptr, nullptr);
+    return true;
+}
+
+#elif defined(GBK_BENCH_ICONV)
+
+static const char* ReferenceName() { return "iconv CP936"; }
+
+static bool IconvConvert(const char* to, const char* from, const std::string& input, std::string& output) {
+    output.clear();
+    iconv_t cd = iconv_open(to, from);
+    if (cd == (iconv_t)-1) return false;
+    output.resize(input.size() * 2 + 16);
+    char* in = const_cast<char*>(input.data());
+    size_t inLeft = input.size();
+    char* out = &output[0];
+    size_t outLeft = output.size();
+    size_t rc = iconv(cd, &in, &inLeft, &out, &outLeft);
+    iconv_close(cd);
+    if (rc == (size_t)-1 || inLeft != 0) return false;
+    output.resize(output.size() - outLeft);
+    return true;
+}
+
+static bool ReferenceToUtf8(const std::string& gbk, std::string& utf8) {
+    return IconvConvert("UTF-8", "CP936", gbk, utf8);
+}
+
+static bool ReferenceFromUtf8(const std::string& utf8, std::string& gbk) {
+    return IconvConvert("CP936", "UTF-8", utf8, gbk);
+}
+
+#else
+
+static const char* ReferenceName() { return nullptr; }
+static bool ReferenceToUtf8(const std::string&, std::string&) { return false; }
+static bool ReferenceFromUtf8(const std::string&, std::string&) { return false; }
+
+#endif
+
+// ========== 一致性检查 ==========
+
+static std::string CodePointToUtf8(unsigned int codePoint) {
+    std::string utf8;
+    if (codePoint < 0x80) {
+        utf8.push_back((char)codePoint);
+    } else if (codePoint < 0x800) {
+        utf8.push_back((char)(0xC0 | (codePoint >> 6)));
+        utf8.push_back((char)(0x80 | (codePoint & 0x3F)));
+    } else {
+        utf8.push_back((char)(0xE0 | (codePoint >> 12)));
+        utf8.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+        utf8.push_back((char)(0x80 | (codePoint & 0x3F)));
+    }
+    return utf8;
+}
+
+static bool IsPrivateUse(const std::string& utf8) {
+    // U+E000-U+F8FF 的 UTF-8 编码为 EE 80 80 - EF A3 BF
+    if (utf8.size() != 3) return false;
+    unsigned char b0 = (unsigned char)utf8[0];
+    unsigned char b1 = (unsigned char)utf8[1];
+    return b0 == 0xEE || (b0 == 0xEF && b1 <= 0xA3);
+}
+
+static int RunVerify() {
+    const char* reference = ReferenceName();
+    if (!reference) {
+        std::fprintf(stderr, "本平台没有可用的 CP936 参考实现\n");
+        return 1;
+    }
+    std::printf("参考实现: %s\n", reference);
+
+    long long failures = 0;
+    auto fail = [&failures](const char* what, unsigned int code) {
+        if (failures < 20) {
+            std::fprintf(stderr, "  不一致: %s 0x%04X\n", what, code);
+        }
+        failures++;
+    };
+
+    // 双字节码：解码与参考一致，已定义的往返不变
+    long long defined = 0;
+    long long privateUse = 0;
+    std::string table;          // 全部已定义字符，穿插 ASCII
+    std::string expected;
+    for (unsigned int lead = 0x81; lead <= 0xFE; lead++) {
+        for (unsigned int trail = 0x40; trail <= 0xFE; trail++) {
+            if (trail == 0x7F) continue;
+            std::string gbk{(char)lead, (char)trail};
+            std::string refUtf8;
+            bool refOk = ReferenceToUtf8(gbk, refUtf8);
+            unsigned int codePoint = GbkCodec::Decode((unsigned char)lead, (unsigned char)trail);
+            unsigned int code = (lead << 8) | trail;
+
+            if (codePoint == 0) {
+                if (refOk && IsPrivateUse(refUtf8)) {
+                    privateUse++;
+                } else if (refOk) {
+                    fail("解码（参考已定义）", code);
+                }
+                continue;
+            }
+
+            defined++;
+            std::string utf8 = GbkCodec::ToUtf8(gbk);
+            if (!refOk || utf8 != refUtf8) {
+                fail("解码", code);
+            }
+            if (GbkCodec::Encode(codePoint) != code || GbkCodec::FromUtf8(utf8) != gbk) {
+                fail("往返", code);
+            }
+
+            table += gbk;
+            expected += utf8;
+            if (code % 7 == 0) {
+                table += ",a\n";
+                expected += ",a\n";
+            }
+        }
+    }
+    std::printf("双字节码: 已定义 %lld，用户自定义区（参考映射到私用区）%lld\n", defined, privateUse);
+
+    // 单字节
+    if (GbkCodec::ToUtf8("\x80") != "\xE2\x82\xAC" || GbkCodec::FromUtf8("\xE2\x82\xAC") != "\x80") {
+        fail("单字节", 0x80);
+    }
+
+    // BMP 码位：编码与参考一致
+    long long encodable = 0;
+    for (unsigned int codePoint = 0x80; codePoint < 0x10000; codePoint++) {
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF) continue;
+        std::string utf8 = CodePointToUtf8(codePoint);
+        std::string refGbk;
+        bool refOk = ReferenceFromUtf8(utf8, refGbk);
+        std::string gbk;
+        size_t replaced = GbkCodec::FromUtf8(utf8, gbk);
+        if (replaced == 0) {
+            encodable++;
+            if (!refOk || gbk != refGbk) {
+                fail("编码", codePoint);
+            }
+        } else if (refOk && !(codePoint >= 0xE000 && codePoint <= 0xF8FF)) {
+            fail("编码（参考可编码）", codePoint);
+        }
+    }
+    std::printf("BMP 码位: 可编码 %lld\n", encodable);
+
+    // 整段转换
+    std::string refUtf8;
+    std::string refGbk;
+    if (GbkCodec::ToUtf8(table) != expected || !ReferenceToUtf8(table, refUtf8) || refUtf8 != expected) {
+        fail("整段解码", 0);
+    }
+    if (GbkCodec::FromUtf8(expected) != table || !ReferenceFromUtf8(expected, refGbk) || refGbk != table) {
+        fail("整段编码", 0);
+    }
+    std::printf("整段转换: %zu 字节 GBK / %zu 字节 UTF-8\n", table.size(), expected.size());
+
+    // 非法序列的替换约定
+    struct Case {
+        const char* input;
+        size_t length;
+        const char* output;
+        bool toUtf8;
+    };
+    static const Case kCases[] = {
+        {"\x81", 1, "\xEF\xBF\xBD", true},                  // 末尾孤立的首字节
+        {"\x81,", 2, "\xEF\xBF\xBD,", true},                // 尾字节不合法，保留逗号
+        {"\x81\"\n", 3, "\xEF\xBF\xBD\"\n", true},
+        {"\xFF" "a", 2, "\xEF\xBF\xBD" "a", true},
+        {"\xA1\x40", 2, "\xEF\xBF\xBD", true},              // 尾字节合法但未定义，两字节一起替换
+        {"\xE4\xB8", 2, "??", false},                       // 截断的 UTF-8
+        {"\xF0\x9F\x98\x80,", 5, "?,", false},              // 辅助平面字符
+        {"\xED\xA0\x80", 3, "???", false},                  // 代理区
+        {"\xC0\xAF", 2, "??", false},                       // 过长编码
+    };
+    for (const Case& c : kCases) {
+        std::string_view input(c.input, c.length);
+        std::string output = c.toUtf8 ? GbkCodec::ToUtf8(input) : GbkCodec::FromUtf8(input);
+        if (output != c.output) {
+            fail(c.toUtf8 ? "非法 GBK 序列" : "非法 UTF-8 序列", (unsigned char)c.input[0]);
+        }
+    }
+
+    std::printf("不一致 %lld 处\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// ========== 吞吐 ==========
+
+/**
+ * @brief 拼接 UTF-8 文本片段到约 bytes 字节
+ */
+static std::string RepeatText(const std::vector<std::string>& pieces, uint64_t bytes) {
+    std::string text;
+    text.reserve((size_t)bytes + 256);
+    uint64_t state = 20240501;
+    while (text.size() < bytes) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        text += pieces[(state >> 33) % pieces.size()];
+    }
+    return text;
+}
+
+static int RunBench(const GbkBenchOptions& options) {
+    uint64_t bytes = (uint64_t)options.sizeMb << 20;
+
+    // 资产 CSV：编号、日期、金额为 ASCII，名称、分类、人员、部门等为中文
+    std::vector<std::string> csvRows = {
+        "ZC00012345,ThinkPad X1 笔记本电脑,笔记本电脑,王伟,研发中心,2023-05-12,8999.00,A座3层12室,在用,\n",
+        "ZC00012346,戴尔 27寸显示器,显示器,李芳,产品部,2022-11-02,1899.50,A座5层03室,在用,已贴资产标签\n",
+        "ZC00012347,HP LaserJet Pro M404dn,打印设备,,行政部,2021-03-18,2399.00,B座1层01室,闲置,\n",
+        "ZC00012348,Huawei S5735 Switch,网络设备,张敏,,2020-07-30,4599.00,Server Room 2,在用,\"含电源, 导轨\"\n",
+    };
+    std::vector<std::string> chinese = {
+        "固定资产管理系统支持按分类、部门与使用人检索，", "导入时自动创建缺少的分类和员工。",
+        "资产编号留空时按默认前缀自动编号，", "变更记录保存每个字段修改前后的值。",
+    };
+
+    struct Dataset {
+        const char* name;
+        std::string utf8;
+        std::string gbk;
+    };
+    Dataset datasets[] = {
+        {"资产 CSV", RepeatText(csvRows, bytes), ""},
+        {"纯中文", RepeatText(chinese, bytes), ""},
+    };
+    for (Dataset& dataset : datasets) {
+        GbkCodec::FromUtf8(dataset.utf8, dataset.gbk);
+    }
+
+    const char* reference = ReferenceName();
+    std::printf("== %lld MB  参考实现: %s\n", options.sizeMb, reference ? reference : "无");
+
+    auto measure = [&](const std::function<bool()>& run) -> double {
+        if (!run()) return -1;      // 预热
+        double best = 0;
+        for (int i = 0; i < options.repeat; i++) {
+            auto start = Clock::now();
+            run();
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (i == 0 || seconds < best) best = seconds;
+        }
+        return best;
+    };
+
+    for (Dataset& dataset : datasets) {
+        double gbkMb = dataset.gbk.size() / 1048576.0;
+        double utf8Mb = dataset.utf8.size() / 1048576.0;
+        std::string output;
+
+        struct Candidate {
+            const char* name;
+            double megabytes;
+            std::function<bool()> run;
+            const std::string* expected;
+        };
+        std::vector<Candidate> candidates = {
+            {"GbkCodec::ToUtf8", gbkMb,
+             [&] { output.clear(); GbkCodec::ToUtf8(dataset.gbk, output); return true; }, &dataset.utf8},
+            {"GbkCodec::FromUtf8", utf8Mb,
+             [&] { output.clear(); GbkCodec::FromUtf8(dataset.utf8, output); return true; }, &dataset.gbk},
+        };
+        if (reference) {
+            candidates.push_back({"参考 GBK -> UTF-8", gbkMb,
+                                  [&] { return ReferenceToUtf8(dataset.gbk, output); }, &dataset.utf8});
+            candidates.push_back({"参考 UTF-8 -> GBK", utf8Mb,
+                                  [&] { return ReferenceFromUtf8(dataset.utf8, output); }, &dataset.gbk});
+        }
+
+        for (const Candidate& candidate : candidates) {
+            double seconds = measure(candidate.run);
+            if (seconds < 0) {
+                std::printf("  %-10s %-22s 失败\n", dataset.name, candidate.name);
+                continue;
+            }
+            std::printf("  %-10s %-22s %9.1f MB/s  %s\n", dataset.name, candidate.name,
+                        candidate.megabytes / seconds, output == *candidate.expected ? "" : "结果不一致");
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    GbkBenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    return options.verify ? RunVerify() : RunBench(options);
+}
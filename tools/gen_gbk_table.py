@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+"""生成 src/GbkTable.inc：CP936 双字节码到 Unicode 的映射表
+
+用法: python3 tools/gen_gbk_table.py > src/GbkTable.inc
+
+表按 (首字节 - 0x81) * 190 + 尾字节序号 索引，尾字节依次为 0x40-0x7E、0x80-0xFE；
+值为 BMP 码位，0 表示未定义。Python 的 gbk 编解码器与 glibc iconv 的 CP936 一致；
+Windows 代码页 936 额外映射到私用区的用户自定义区不在表内。
+单字节 0x80（欧元符号）不在表内，由 GbkCodec 单独处理。
+"""
+
+TRAILS = list(range(0x40, 0x7F)) + list(range(0x80, 0xFF))
+
+
+def main():
+    table = []
+    for lead in range(0x81, 0xFF):
+        for trail in TRAILS:
+            try:
+                char = bytes([lead, trail]).decode("gbk")
+                table.append(ord(char))
+            except UnicodeDecodeError:
+                table.append(0)
+
+    assert len(table) == 126 * 190
+    assert all(code < 0x10000 for code in table)
+
+    print("// 由 tools/gen_gbk_table.py 生成，请勿手工修改")
+    print("// CP936 双字节码 -> Unicode，共 %d 项，已定义 %d 项" %
+          (len(table), sum(1 for code in table if code)))
+    for lead in range(126):
+        row = table[lead * 190:(lead + 1) * 190]
+        print("// 0x%02X" % (0x81 + lead))
+        for i in range(0, len(row), 12):
+            print("    " + " ".join("0x%04X," % code for code in row[i:i + 12]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,592 @@
+/**
+ * @file query_plan_check.cpp
+ * @brief 查询计划回归检查
+ *
+ * 生成一个有数据的数据库，调用 Database 的全部接口（含 SearchAssets、
+ * SearchAssetsPage、SearchEmployees、SearchChangeLogs、GetChangeLogsBefore 的每种条件组合），
+ * 收集实际 prepare 的每条 SQL，对其执行 EXPLAIN QUERY PLAN，并与
+ * tools/query_plans.txt 中的期望计划比较：
+ *
+ *   query_plan_check              检查，有回归时返回 1
+ *   query_plan_check --update     重新生成期望文件（修改 SQL 或索引后执行并提交）
+ *
+ * 判定为回归（返回 1）：
+ * - 出现期望计划中没有的 SCAN（全表/全索引扫描）或 USE TEMP B-TREE（临时排序）
+ * - 期望文件中没有的新语句
+ * 其余计划差异只打印提示。
+ */
+
+#include "database.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#ifndef QUERY_PLAN_EXPECTED
+#define QUERY_PLAN_EXPECTED "query_plans.txt"
+#endif
+
+// ========== 命令行参数 ==========
+
+struct CheckOptions {
+    std::string expectPath = QUERY_PLAN_EXPECTED;
+    std::string dbPath = "query_plan_check.db";
+    int rows = 20000;               // 生成的资产数量
+    bool update = false;            // 重写期望文件
+};
+
+static void PrintUsage() {
+    std::printf(
+        "用法: query_plan_check [选项]\n"
+        "  --expect FILE   期望计划文件（默认 %s）\n"
+        "  --db FILE       临时数据库路径（默认 query_plan_check.db，运行前删除）\n"
+        "  --rows N        生成的资产数量（默认 20000）\n"
+        "  --update        用当前计划重写期望文件\n",
+        QUERY_PLAN_EXPECTED);
+}
+
+static bool ParseOptions(int argc, char** argv, CheckOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            return i + 1 < argc ? argv[++i] : "";
+        };
+
+        if (arg == "--expect") {
+            options.expectPath = value();
+        } else if (arg == "--db") {
+            options.dbPath = value();
+        } else if (arg == "--rows") {
+            options.rows = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--update") {
+            options.update = true;
+        } else {
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 语句收集 ==========
+
+/**
+ * @brief 压缩空白，使同一条 SQL 的不同缩进形式得到相同的键
+ */
+static std::string NormalizeSql(const char* sql) {
+    std::string result;
+    bool space = false;
+    for (const char* p = sql; *p; p++) {
+        if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+            space = !result.empty();
+            continue;
+        }
+        if (space) {
+            result.push_back(' ');
+            space = false;
+        }
+        result.push_back(*p);
+    }
+    return result;
+}
+
+/**
+ * @brief 按首次出现顺序去重收集 SQL
+ */
+class StatementCollector {
+public:
+    void Add(const char* sql) {
+        std::string text = NormalizeSql(sql);
+        if (m_seen.emplace(text, m_order.size()).second) {
+            m_order.push_back(text);
+        }
+    }
+
+    const std::vector<std::string>& Statements() const { return m_order; }
+
+private:
+    std::map<std::string, size_t> m_seen;
+    std::vector<std::string> m_order;
+};
+
+// ========== 测试数据与接口调用 ==========
+
+static const char* const kCategoryNames[] = {
+    "笔记本电脑", "台式电脑", "显示器", "打印设备", "网络设备",
+    "办公家具", "通讯设备", "服务器", "投影设备", "车辆",
+};
+
+static const char* const kDepartmentNames[] = {
+    "研发中心", "市场部", "财务部", "行政部", "信息技术部",
+};
+
+static const char* const kStatuses[] = {"在用", "闲置", "维修中", "已报废"};
+
+static bool Populate(Database& db, int rows) {
+    std::vector<int> categoryIds;
+    std::vector<int> departmentIds;
+    std::vector<int> employeeIds;
+
+    db.BeginTransaction();
+    for (const char* name : kCategoryNames) {
+        Category category{0, name};
+        if (!db.AddCategory(category)) {
+            db.Rollback();
+            return false;
+        }
+        categoryIds.push_back(category.id);
+    }
+    for (const char* name : kDepartmentNames) {
+        Department dept{0, name};
+        if (!db.AddDepartment(dept)) {
+            db.Rollback();
+            return false;
+        }
+        departmentIds.push_back(dept.id);
+    }
+    int employeeCount = std::max(20, rows / 50);
+    for (int i = 0; i < employeeCount; i++) {
+        Employee employee;
+        employee.id = 0;
+        employee.name = "员工" + std::to_string(i + 1);
+        employee.departmentId = (i % 17 == 0) ? -1 : departmentIds[i % departmentIds.size()];
+        if (!db.AddEmployee(employee)) {
+            db.Rollback();
+            return false;
+        }
+        employeeIds.push_back(employee.id);
+    }
+    db.Commit();
+
+    std::vector<Asset> batch;
+    for (int i = 1; i <= rows; i++) {
+        char code[32];
+        std::snprintf(code, sizeof(code), "ZC%08d", i);
+        char date[16];
+        std::snprintf(date, sizeof(date), "%04d-%02d-%02d", 2015 + i % 10, 1 + i % 12, 1 + i % 28);
+
+        Asset asset;
+        asset.id = 0;
+        asset.assetCode = code;
+        asset.name = std::string(kCategoryNames[i % 10]) + " " + std::to_string(i % 97);
+        asset.categoryId = (i % 50 == 0) ? -1 : categoryIds[i % categoryIds.size()];
+        asset.status = kStatuses[i % 4];
+        asset.userId = (i % 4 == 0) ? employeeIds[i % employeeIds.size()] : -1;
+        asset.purchaseDate = date;
+        asset.price = 100.0 + (i % 1000) * 7.5;
+        asset.location = "A座" + std::to_string(1 + i % 12) + "楼";
+        asset.remark = (i % 5 == 0) ? "已贴资产标签" : "";
+        batch.push_back(std::move(asset));
+
+        if (batch.size() == 5000 || i == rows) {
+            if (db.AddAssets(batch) != (int)batch.size()) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+
+    std::vector<AssetChangeLog> logs;
+    for (int i = 1; i <= rows * 2; i++) {
+        int assetId = 1 + i % rows;
+        AssetChangeLog log;
+        log.id = 0;
+        log.assetId = assetId;
+        log.assetCode = "ZC" + std::to_string(assetId);
+        log.assetName = kCategoryNames[assetId % 10];
+        log.fieldName = (i % 2) ? "状态" : "使用人";
+        log.oldValue = kStatuses[i % 4];
+        log.newValue = kStatuses[(i + 1) % 4];
+        log.changeTime = 1704067200LL + i * 60;  // 2024-01-01 起每分钟一条
+        logs.push_back(std::move(log));
+
+        if (logs.size() == 10000 || i == rows * 2) {
+            db.BeginTransaction();
+            bool ok = db.AddChangeLogs(logs);
+            db.Commit();
+            if (!ok) {
+                return false;
+            }
+            logs.clear();
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 调用每个接口，使其全部 SQL 被 prepare 一次
+ */
+static void ExerciseAll(Database& db) {
+    // 分类、部门、员工
+    std::vector<Category> categories = db.GetAllCategories();
+    std::vector<Department> departments = db.GetAllDepartments();
+    std::vector<Employee> employees = db.GetAllEmployees();
+    int categoryId = categories.front().id;
+    int departmentId = departments.front().id;
+    int employeeId = employees.front().id;
+
+    Category category;
+    db.GetCategoryById(categoryId, category);
+    db.GetCategoryByName(category.name, category);
+    Department dept;
+    db.GetDepartmentById(departmentId, dept);
+    db.GetDepartmentByName(dept.name, dept);
+    db.GetDepartmentEmployeeCount(departmentId);
+    Employee employee;
+    db.GetEmployeeById(employeeId, employee);
+    db.GetEmployeesByName(employee.name);
+    db.GetEmployeeAssetCount(employeeId);
+    db.GetAllEmployeeAssetCounts();
+
+    for (const char* text : {"", "员工1"}) {
+        for (int dept : {-1, departmentId}) {
+            db.SearchEmployees(text, dept);
+        }
+    }
+
+    // 资产查询：短词走 LIKE，3 个字符以上走全文索引
+    const char* const searchTexts[] = {"", "笔记", "笔记本"};
+    const char* const statuses[] = {"", "在用"};
+    for (const char* text : searchTexts) {
+        for (int cat : {-1, categoryId}) {
+            for (const char* status : statuses) {
+                db.SearchAssets(text, cat, status);
+
+                AssetFilter filter;
+                filter.searchText = text;
+                filter.categoryId = cat;
+                filter.status = status;
+                for (int field = (int)AssetSortField::Id; field <= (int)AssetSortField::Remark; field++) {
+                    filter.sortField = (AssetSortField)field;
+                    for (bool ascending : {false, true}) {
+                        filter.ascending = ascending;
+                        AssetPageKey next;
+                        db.SearchAssetsPage(filter, AssetPageKey(), 50, &next);
+                        if (!next.valid) {
+                            // 结果为空时也要生成带键集条件的语句
+                            next.valid = true;
+                        }
+                        db.SearchAssetsPage(filter, next, 50);
+                    }
+                }
+
+                filter.sortField = AssetSortField::Id;
+                filter.ascending = false;
+                db.ForEachAsset(filter, [](const AssetRowView&) { return false; });
+            }
+        }
+    }
+
+    Asset asset;
+    db.GetLastAsset(asset);
+    db.GetAssetById(asset.id, asset);
+    db.GetAssetByCode(asset.assetCode, asset);
+    db.HasAssetCode(asset.assetCode);
+    int count = 0;
+    double total = 0;
+    db.GetAssetStats(count, total);
+    AssetSummary summary;
+    db.GetAssetSummary(summary);
+
+    // 变更日志
+    db.GetChangeLogCount();
+    db.GetChangeLogsByAssetId(asset.id);
+    db.GetAllChangeLogs();
+    db.GetAllChangeLogs(100, 1000);
+    for (const char* text : {"", "ZC1"}) {
+        for (const char* start : {"", "2024-01-01"}) {
+            for (const char* end : {"", "2024-12-31"}) {
+                ChangeLogTimeRange range = ChangeLogTimeRange::FromLocalDates(start, end);
+                db.SearchChangeLogs(text, range);
+                db.ForEachChangeLog(text, range,
+                                    [](const ChangeLogRowView&) { return false; });
+                for (int assetId : {-1, asset.id}) {
+                    ChangeLogFilter filter{text, range, assetId};
+                    ChangeLogPageKey key;
+                    db.GetChangeLogsBefore(key, 100, filter, &key);
+                    key.valid = true;
+                    key.changeTime = range.to ? *range.to - 1 : 1717171200;
+                    db.GetChangeLogsBefore(key, 100, filter);
+                }
+            }
+        }
+    }
+    db.GetDataVersion();
+
+    // 写操作：在事务中执行后回滚，不影响数据
+    db.BeginTransaction();
+    Category newCategory{0, "计划检查分类"};
+    db.AddCategory(newCategory);
+    db.UpdateCategory(newCategory);
+    Department newDept{0, "计划检查部门"};
+    db.AddDepartment(newDept);
+    db.UpdateDepartment(newDept);
+    Employee newEmployee;
+    newEmployee.id = 0;
+    newEmployee.name = "计划检查员工";
+    newEmployee.departmentId = newDept.id;
+    db.AddEmployee(newEmployee);
+    db.UpdateEmployee(newEmployee);
+
+    Asset newAsset = asset;
+    newAsset.id = 0;
+    newAsset.assetCode = "PLAN-CHECK-1";
+    db.AddAsset(newAsset);
+    std::vector<Asset> batch(1, newAsset);
+    batch[0].assetCode = "PLAN-CHECK-2";
+    db.AddAssets(batch);
+    db.BeginBulkLoad();
+    batch[0].assetCode = "PLAN-CHECK-3";
+    db.AddAssets(batch);
+    db.EndBulkLoad();
+    newAsset.name = "计划检查资产";
+    newAsset.status = "闲置";
+    newAsset.userId = newEmployee.id;
+    db.UpdateAsset(newAsset);
+
+    AssetChangeLog log;
+    log.id = 0;
+    log.assetId = newAsset.id;
+    log.assetCode = newAsset.assetCode;
+    log.assetName = newAsset.name;
+    log.fieldName = "备注";
+    db.AddChangeLog(log);
+
+    std::string prefix = db.GetDefaultAssetCodePrefix();
+    db.PeekAssetCode(prefix);
+    AssetCodeBlock codes;
+    db.ReserveAssetCodes(prefix, 100, codes);
+
+    db.DeleteAsset(newAsset.id);
+    db.DeleteEmployee(newEmployee.id);
+    db.DeleteDepartment(newDept.id);
+    db.DeleteCategory(newCategory.id);
+    db.Rollback();
+}
+
+// ========== 查询计划 ==========
+
+/**
+ * @brief 执行 EXPLAIN QUERY PLAN，每个节点一行，按层级缩进两个空格
+ */
+static bool ExplainPlan(sqlite3* db, const std::string& sql, std::vector<std::string>& lines,
+                        std::string& error) {
+    lines.clear();
+    std::string explain = "EXPLAIN QUERY PLAN " + sql;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, explain.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+
+    std::map<int, int> depth;   // 节点 id -> 层级
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        int parent = sqlite3_column_int(stmt, 1);
+        const char* detail = (const char*)sqlite3_column_text(stmt, 3);
+        auto it = depth.find(parent);
+        int level = (it == depth.end()) ? 0 : it->second + 1;
+        depth[id] = level;
+        lines.push_back(std::string(level * 2, ' ') + (detail ? detail : ""));
+    }
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+static std::string Trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(' ');
+    return begin == std::string::npos ? std::string() : text.substr(begin);
+}
+
+/**
+ * @brief 全表/全索引扫描或临时排序节点
+ */
+static bool IsCostlyStep(const std::string& line) {
+    std::string step = Trim(line);
+    return step.compare(0, 5, "SCAN ") == 0 || step.find("USE TEMP B-TREE") != std::string::npos;
+}
+
+struct PlanEntry {
+    std::string sql;
+    std::vector<std::string> lines;
+};
+
+// 期望文件格式：
+//   # 注释
+//   SQL: <压缩空白后的 SQL>
+//     <计划行，前缀两个空格后为 ExplainPlan 的缩进>
+static bool ReadExpectations(const std::string& path, std::vector<PlanEntry>& entries) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        if (line.compare(0, 5, "SQL: ") == 0) {
+            entries.push_back({line.substr(5), {}});
+        } else if (!entries.empty() && line.compare(0, 2, "  ") == 0) {
+            entries.back().lines.push_back(line.substr(2));
+        }
+    }
+    return true;
+}
+
+static bool WriteExpectations(const std::string& path, const std::vector<PlanEntry>& entries) {
+    std::ofstream out(path, std::ios::binary);
+    out << "# 由 query_plan_check --update 生成，SQL 或索引变化后重新生成并随代码提交\n";
+    for (const PlanEntry& entry : entries) {
+        out << "\nSQL: " << entry.sql << "\n";
+        for (const std::string& line : entry.lines) {
+            out << "  " << line << "\n";
+        }
+    }
+    return (bool)out;
+}
+
+static void PrintPlan(const char* title, const std::vector<std::string>& lines) {
+    std::printf("    %s:\n", title);
+    for (const std::string& line : lines) {
+        std::printf("      %s\n", line.c_str());
+    }
+}
+
+// ========== 主流程 ==========
+
+static void RemoveDatabaseFiles(const std::string& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+    fs::remove(path + "-wal", ec);
+    fs::remove(path + "-shm", ec);
+    fs::remove(path + "-journal", ec);
+}
+
+int main(int argc, char** argv) {
+    CheckOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    RemoveDatabaseFiles(options.dbPath);
+
+    StatementCollector collector;
+    std::vector<PlanEntry> actual;
+    {
+        Database db;
+        db.SetStatementObserver([&](const char* sql) { collector.Add(sql); });
+        if (!db.Initialize(options.dbPath)) {
+            std::fprintf(stderr, "数据库初始化失败: %s\n", db.GetLastError().c_str());
+            return 2;
+        }
+        if (!Populate(db, options.rows)) {
+            std::fprintf(stderr, "生成数据失败: %s\n", db.GetLastError().c_str());
+            return 2;
+        }
+        ExerciseAll(db);
+
+        // 另开一个连接取计划，避免影响 Database 的语句缓存
+        sqlite3* raw = nullptr;
+        if (sqlite3_open_v2(options.dbPath.c_str(), &raw, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            std::fprintf(stderr, "无法打开数据库: %s\n", sqlite3_errmsg(raw));
+            sqlite3_close(raw);
+            return 2;
+        }
+        for (const std::string& sql : collector.Statements()) {
+            PlanEntry entry{sql, {}};
+            std::string error;
+            if (!ExplainPlan(raw, sql, entry.lines, error)) {
+                std::fprintf(stderr, "EXPLAIN 失败: %s\n  %s\n", error.c_str(), sql.c_str());
+                sqlite3_close(raw);
+                return 2;
+            }
+            actual.push_back(std::move(entry));
+        }
+        sqlite3_close(raw);
+    }
+    RemoveDatabaseFiles(options.dbPath);
+
+    std::printf("收集到 %zu 条语句\n", actual.size());
+
+    if (options.update) {
+        if (!WriteExpectations(options.expectPath, actual)) {
+            std::fprintf(stderr, "写入期望文件失败: %s\n", options.expectPath.c_str());
+            return 2;
+        }
+        std::printf("期望计划已写入 %s\n", options.expectPath.c_str());
+        return 0;
+    }
+
+    std::vector<PlanEntry> expected;
+    if (!ReadExpectations(options.expectPath, expected)) {
+        std::fprintf(stderr, "无法读取期望文件: %s（可先执行 --update 生成）\n",
+                     options.expectPath.c_str());
+        return 2;
+    }
+    std::map<std::string, const PlanEntry*> expectedBySql;
+    for (const PlanEntry& entry : expected) {
+        expectedBySql[entry.sql] = &entry;
+    }
+
+    int regressions = 0;
+    int changed = 0;
+    for (const PlanEntry& entry : actual) {
+        auto it = expectedBySql.find(entry.sql);
+        if (it == expectedBySql.end()) {
+            regressions++;
+            std::printf("[新语句] %s\n", entry.sql.c_str());
+            PrintPlan("实际计划", entry.lines);
+            continue;
+        }
+        const PlanEntry& expect = *it->second;
+        expectedBySql.erase(it);
+        if (expect.lines == entry.lines) {
+            continue;
+        }
+
+        // 期望计划中已有的扫描/临时排序不算回归（按出现次数抵消）
+        std::vector<std::string> allowed;
+        for (const std::string& line : expect.lines) {
+            if (IsCostlyStep(line)) allowed.push_back(Trim(line));
+        }
+        std::vector<std::string> costly;
+        for (const std::string& line : entry.lines) {
+            if (!IsCostlyStep(line)) continue;
+            auto found = std::find(allowed.begin(), allowed.end(), Trim(line));
+            if (found != allowed.end()) {
+                allowed.erase(found);
+            } else {
+                costly.push_back(Trim(line));
+            }
+        }
+
+        if (costly.empty()) {
+            changed++;
+            std::printf("[计划变化] %s\n", entry.sql.c_str());
+        } else {
+            regressions++;
+            std::printf("[回归] %s\n", entry.sql.c_str());
+            for (const std::string& line : costly) {
+                std::printf("    新增: %s\n", line.c_str());
+            }
+        }
+        PrintPlan("期望计划", expect.lines);
+        PrintPlan("实际计划", entry.lines);
+    }
+
+    for (const auto& missing : expectedBySql) {
+        std::printf("[未执行] %s\n", missing.first.c_str());
+    }
+
+    std::printf("回归 %d 条，计划变化 %d 条，期望中未执行 %zu 条\n",
+                regressions, changed, expectedBySql.size());
+    return regressions > 0 ? 1 : 0;
+}